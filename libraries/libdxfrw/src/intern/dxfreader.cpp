@@ -11,9 +11,22 @@
 ******************************************************************************/
 
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <locale>
 #include <string>
 #include <sstream>
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 #include "dxfreader.h"
 #include "drw_textcodec.h"
 #include "drw_dbg.h"
@@ -89,8 +102,13 @@ bool dxfReader::readRec(int *codeData) {
         //break in binary files because the conduct is unpredictable
         return false;
 
-    return (filestr->good());
+    return good();
+}
+
+bool dxfReader::good() {
+    return filestr->good();
 }
+
 int dxfReader::getHandleString(){
     int res;
 #if defined(__APPLE__)
@@ -266,3 +284,259 @@ bool dxfReaderAscii::readBool() {
         return false;
 }
 
+
+namespace {
+bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+//! atoi() on a line which is not null terminated
+int parseInt(const char *p, const char *end) {
+    while (p < end && isSpace(*p))
+        ++p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+    unsigned long long value = 0;
+    for (; p < end && isDigit(*p); ++p) {
+        if (value < 0xffffffffULL)
+            value = value * 10 + (*p - '0');
+    }
+    return negative ? -(int)value : (int)value;
+}
+}
+
+dxfReaderAsciiMapped::dxfReaderAsciiMapped(const char *name):dxfReader(nullptr){
+    skip = true;
+    fallback.imbue(std::locale::classic());
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize)) {
+        size = (size_t)fileSize.QuadPart;
+        if (size == 0) {
+            opened = true;
+        } else {
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping != NULL) {
+                data = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                opened = data != NULL;
+                CloseHandle(mapping);
+            }
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = open(name, O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+        size = (size_t)st.st_size;
+        if (size == 0) {
+            opened = true;
+        } else {
+            void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED) {
+                madvise(map, size, MADV_SEQUENTIAL);
+                data = (const char *)map;
+                opened = true;
+            }
+        }
+    }
+    close(fd);
+#endif
+    if (!opened)
+        size = 0;
+}
+
+dxfReaderAsciiMapped::~dxfReaderAsciiMapped(){
+    if (data == nullptr)
+        return;
+#if defined(_WIN32)
+    UnmapViewOfFile(data);
+#else
+    munmap((void *)data, size);
+#endif
+}
+
+/**
+ * Same conduct as std::getline() on the ascii stream: the last line
+ * needs no line feed but reaching the end of the file while reading it
+ * makes the reader not good anymore.
+ */
+bool dxfReaderAsciiMapped::readLine(const char **begin, const char **end){
+    if (pos >= size) {
+        atEnd = true;
+        *begin = *end = data + size;
+        return false;
+    }
+    *begin = data + pos;
+    const char *lf = (const char *)memchr(*begin, '\n', size - pos);
+    if (lf == nullptr) {
+        *end = data + size;
+        pos = size;
+        atEnd = true;
+    } else {
+        *end = lf;
+        pos = lf - data + 1;
+    }
+    if (*end > *begin && *(*end - 1) == '\r')
+        --*end;
+    return !atEnd;
+}
+
+bool dxfReaderAsciiMapped::readCode(int *code) {
+    const char *begin, *end;
+    readLine(&begin, &end);
+    *code = parseInt(begin, end);
+    DRW_DBG(*code); DRW_DBG("\n");
+    return good();
+}
+
+bool dxfReaderAsciiMapped::readString(std::string *text) {
+    type = STRING;
+    const char *begin, *end;
+    readLine(&begin, &end);
+    text->assign(begin, end);
+    return good();
+}
+
+bool dxfReaderAsciiMapped::readString() {
+    type = STRING;
+    const char *begin, *end;
+    readLine(&begin, &end);
+    strData.assign(begin, end);
+    DRW_DBG(strData); DRW_DBG("\n");
+    return good();
+}
+
+bool dxfReaderAsciiMapped::readInt16() {
+    type = INT32;
+    const char *begin, *end;
+    if (readLine(&begin, &end)){
+        intData = parseInt(begin, end);
+        DRW_DBG(intData); DRW_DBG("\n");
+        return true;
+    } else
+        return false;
+}
+
+bool dxfReaderAsciiMapped::readInt32() {
+    type = INT32;
+    return readInt16();
+}
+
+bool dxfReaderAsciiMapped::readInt64() {
+    type = INT64;
+    return readInt16();
+}
+
+bool dxfReaderAsciiMapped::readDouble() {
+    type = DOUBLE;
+    const char *begin, *end;
+    if (readLine(&begin, &end)){
+        doubleData = parseDouble(begin, end);
+        DRW_DBG(doubleData); DRW_DBG('\n');
+        return true;
+    } else
+        return false;
+}
+
+//saved as int or add a bool member??
+bool dxfReaderAsciiMapped::readBool() {
+    type = BOOL;
+    const char *begin, *end;
+    if (readLine(&begin, &end)){
+        intData = parseInt(begin, end);
+        DRW_DBG(intData); DRW_DBG("\n");
+        return true;
+    } else
+        return false;
+}
+
+/**
+ * Parses a decimal number. Mantissas up to 2^53 scaled by up to 10^22 are
+ * converted exactly with one multiplication or division (Clinger's fast
+ * path), which covers the output of all common DXF writers. Anything else
+ * (long mantissas, huge exponents, inf, nan, garbage) is left to a stream
+ * imbued with the classic locale.
+ */
+double dxfReaderAsciiMapped::parseDouble(const char *begin, const char *end) {
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const unsigned long long maxExact = 1ULL << 53;
+
+    const char *p = begin;
+    while (p < end && isSpace(*p))
+        ++p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+
+    unsigned long long mantissa = 0;
+    int exponent = 0;
+    int digits = 0;
+    bool truncated = false;
+    for (; p < end && isDigit(*p); ++p, ++digits) {
+        if (mantissa < 100000000000000000ULL)
+            mantissa = mantissa * 10 + (*p - '0');
+        else {
+            ++exponent;
+            truncated |= *p != '0';
+        }
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && isDigit(*p); ++p, ++digits) {
+            if (mantissa < 100000000000000000ULL) {
+                mantissa = mantissa * 10 + (*p - '0');
+                --exponent;
+            } else
+                truncated |= *p != '0';
+        }
+    }
+    bool valid = digits > 0 && !truncated;
+    if (valid && p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExp = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negativeExp = (*p++ == '-');
+        valid = p < end && isDigit(*p);
+        int exp = 0;
+        for (; p < end && isDigit(*p); ++p) {
+            if (exp < 10000)
+                exp = exp * 10 + (*p - '0');
+        }
+        exponent += negativeExp ? -exp : exp;
+    }
+
+    if (valid) {
+        while (mantissa != 0 && mantissa % 10 == 0
+               && (mantissa > maxExact || exponent < 0)) {
+            mantissa /= 10;
+            ++exponent;
+        }
+        if (mantissa == 0)
+            return negative ? -0.0 : 0.0;
+        if (mantissa <= maxExact && exponent >= -22 && exponent <= 22) {
+            double value = (double)mantissa;
+            value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+            return negative ? -value : value;
+        }
+    }
+
+    double value = 0.0;
+    fallback.clear();
+    fallback.str(std::string(begin, end));
+    fallback >> value;
+    return value;
+}
@@ -13,6 +13,8 @@
 #ifndef DXFREADER_H
 #define DXFREADER_H
 
+#include <cstddef>
+#include <sstream>
 #include "drw_textcodec.h"
 
 class dxfReader {
@@ -49,6 +51,7 @@ public:
     void setIgnoreComments( const bool bValue) { m_bIgnoreComments = bValue;};
 
 protected:
+    virtual bool good();
     virtual bool readCode(int *code) = 0; //return true if sucesful (not EOF)
     virtual bool readString(std::string *text) = 0;
     virtual bool readString() = 0;
@@ -98,4 +101,42 @@ public:
     virtual bool readBool();
 };
 
+/**
+ * Ascii reader working on a memory mapped file. Lines are tokenized in
+ * place and numbers are parsed without streams or locales, only strings
+ * are copied. Reads the same values as dxfReaderAscii, but numbers keep
+ * their type instead of reporting STRING.
+ */
+class dxfReaderAsciiMapped : public dxfReader {
+public:
+    dxfReaderAsciiMapped(const char *name);
+    virtual ~dxfReaderAsciiMapped();
+    //! false if the file could not be mapped, use dxfReaderAscii then
+    bool isOpen() const {return opened;}
+    virtual bool readCode(int *code);
+    virtual bool readString(std::string *text);
+    virtual bool readString();
+    virtual bool readInt16();
+    virtual bool readDouble();
+    virtual bool readInt32();
+    virtual bool readInt64();
+    virtual bool readBool();
+
+protected:
+    virtual bool good() {return !atEnd;}
+
+private:
+    //! next line without line feed and carriage return
+    bool readLine(const char **begin, const char **end);
+    double parseDouble(const char *begin, const char *end);
+
+    const char *data {nullptr};
+    size_t size {0};
+    size_t pos {0};
+    bool atEnd {false};
+    bool opened {false};
+    //! parses doubles the fast path can't handle exactly
+    std::istringstream fallback;
+};
+
 #endif // DXFREADER_H
@@ -11,11 +11,19 @@
 ******************************************************************************/
 
 #include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <clocale>
 #include <fstream>
 #include <string>
 #include <algorithm>
 #include "dxfwriter.h"
 
+namespace {
+//! buffered output is handed to the stream in chunks of this size
+const size_t chunkSize = 4 << 20;
+}
+
 //RLZ TODO change std::endl to x0D x0A (13 10)
 /*bool dxfWriter::readRec(int *codeData, bool skip) {
 //    std::string text;
@@ -91,6 +99,11 @@
     return (filestr->good());
 }*/
 
+bool dxfWriter::flush() {
+    filestr->flush();
+    return (filestr->good());
+}
+
 bool dxfWriter::writeUtf8String(int code, std::string text) {
     std::string t = encoder.fromUtf8(text);
     return writeString(code, t);
@@ -268,3 +281,127 @@ bool dxfWriterAscii::writeBool(int code, bool data) {
     return (filestr->good());
 }
 
+
+dxfWriterAsciiBuffered::dxfWriterAsciiBuffered(std::ofstream *stream):dxfWriter(stream){
+    buffer.reserve(chunkSize + 1024);
+    const char *point = localeconv()->decimal_point;
+    decimalPoint = (point != NULL && *point != '\0') ? *point : '.';
+}
+
+dxfWriterAsciiBuffered::~dxfWriterAsciiBuffered(){
+    if (!buffer.empty())
+        filestr->write(buffer.data(), buffer.size());
+}
+
+bool dxfWriterAsciiBuffered::flush() {
+    filestr->write(buffer.data(), buffer.size());
+    buffer.clear();
+    return dxfWriter::flush();
+}
+
+/** writes a full chunk to the stream, without flushing it */
+bool dxfWriterAsciiBuffered::endRecord() {
+    buffer += '\n';
+    if (buffer.size() < chunkSize)
+        return true;
+    filestr->write(buffer.data(), buffer.size());
+    buffer.clear();
+    return (filestr->good());
+}
+
+/** group code right aligned in 3 columns, like dxfWriterAscii */
+void dxfWriterAsciiBuffered::appendCode(int code) {
+    appendInt(code < 0 ? -(long long)code : code, code < 0, 3);
+    buffer += '\n';
+}
+
+void dxfWriterAsciiBuffered::appendInt(unsigned long long value, bool negative, size_t width) {
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    char *first = end;
+    do {
+        *--first = '0' + value % 10;
+        value /= 10;
+    } while (value != 0);
+    if (negative)
+        *--first = '-';
+    size_t len = end - first;
+    if (len < width)
+        buffer.append(width - len, ' ');
+    buffer.append(first, len);
+}
+
+/**
+ * Writes the shortest of %.15g, %.16g and %.17g reading back to the same
+ * value. Values with up to six decimals are formatted without printf,
+ * they are exact if the decimal scaled back gives the same double.
+ */
+void dxfWriterAsciiBuffered::appendDouble(double data) {
+    double const magnitude = std::fabs(data);
+    if (magnitude == 0.0 || (magnitude >= 1e-4 && magnitude < 1e9)) {
+        unsigned long long const scaled = (unsigned long long)std::floor(magnitude * 1e6 + 0.5);
+        if (scaled / 1e6 == magnitude) {
+            appendInt(scaled / 1000000, std::signbit(data), 0);
+            unsigned long long fraction = scaled % 1000000;
+            if (fraction != 0) {
+                char decimals[7] = {'.'};
+                for (int i = 6; i > 0; --i) {
+                    decimals[i] = '0' + fraction % 10;
+                    fraction /= 10;
+                }
+                int last = 6;
+                while (decimals[last] == '0')
+                    --last;
+                buffer.append(decimals, last + 1);
+            }
+            return;
+        }
+    }
+
+    char text[32];
+    int len = 0;
+    for (int precision = 15; precision <= 17; ++precision) {
+        len = snprintf(text, sizeof(text), "%.*g", precision, data);
+        if (precision == 17 || strtod(text, NULL) == data)
+            break;
+    }
+    if (decimalPoint != '.')
+        std::replace(text, text + len, decimalPoint, '.');
+    buffer.append(text, len);
+}
+
+bool dxfWriterAsciiBuffered::writeString(int code, std::string text) {
+    appendCode(code);
+    buffer += text;
+    return endRecord();
+}
+
+bool dxfWriterAsciiBuffered::writeInt16(int code, int data) {
+    appendCode(code);
+    appendInt(data < 0 ? -(long long)data : data, data < 0, 5);
+    return endRecord();
+}
+
+bool dxfWriterAsciiBuffered::writeInt32(int code, int data) {
+    return writeInt16(code, data);
+}
+
+bool dxfWriterAsciiBuffered::writeInt64(int code, unsigned long long int data) {
+    appendCode(code);
+    appendInt(data, false, 5);
+    return endRecord();
+}
+
+bool dxfWriterAsciiBuffered::writeDouble(int code, double data) {
+    appendCode(code);
+    appendDouble(data);
+    return endRecord();
+}
+
+//same as dxfWriterAscii, the code is not aligned here
+bool dxfWriterAsciiBuffered::writeBool(int code, bool data) {
+    appendInt(code < 0 ? -(long long)code : code, code < 0, 0);
+    buffer += '\n';
+    buffer += data ? '1' : '0';
+    return endRecord();
+}
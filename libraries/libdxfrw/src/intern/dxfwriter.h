@@ -28,6 +28,7 @@ public:
     virtual bool writeInt64(int code, unsigned long long int data) = 0;
     virtual bool writeDouble(int code, double data) = 0;
     virtual bool writeBool(int code, bool data) = 0;
+    virtual bool flush();
     void setVersion(std::string *v, bool dxfFormat){encoder.setVersion(v, dxfFormat);}
     void setCodePage(std::string *c){encoder.setCodePage(c, true);}
     std::string getCodePage(){return encoder.getCodePage();}
@@ -61,4 +62,31 @@ public:
     virtual bool writeBool(int code, bool data);
 };
 
+/**
+ * Ascii writer collecting the output in a large buffer, written to the
+ * stream in big chunks without flushing, flush() must be called at the end.
+ * Doubles are written with the shortest representation reading back to the
+ * same value, independent of the locale.
+ */
+class dxfWriterAsciiBuffered : public dxfWriter {
+public:
+    dxfWriterAsciiBuffered(std::ofstream *stream);
+    virtual ~dxfWriterAsciiBuffered();
+    virtual bool writeString(int code, std::string text);
+    virtual bool writeInt16(int code, int data);
+    virtual bool writeInt32(int code, int data);
+    virtual bool writeInt64(int code, unsigned long long int data);
+    virtual bool writeDouble(int code, double data);
+    virtual bool writeBool(int code, bool data);
+    virtual bool flush();
+private:
+    void appendCode(int code);
+    void appendInt(unsigned long long value, bool negative, size_t width);
+    void appendDouble(double data);
+    bool endRecord();
+
+    std::string buffer;
+    char decimalPoint;
+};
+
 #endif // DXFWRITER_H
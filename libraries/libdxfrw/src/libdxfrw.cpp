@@ -37,6 +37,8 @@ dxfRW::dxfRW(const char* name){
     fileName = name;
     reader = NULL;
     writer = NULL;
+    memoryMapped = true;
+    buffered = true;
     applyExt = false;
     elParts = 128; //parts munber when convert ellipse to polyline
 }
@@ -92,8 +94,18 @@ bool dxfRW::read(DRW_Interface *interface_, bool ext){
         DRW_DBG("dxfRW::read binary file\n");
     } else {
         binFile = false;
-        filestr.open (fileName.c_str(), std::ios_base::in);
-        reader = new dxfReaderAscii(&filestr);
+        if (memoryMapped) {
+            dxfReaderAsciiMapped *mapped = new dxfReaderAsciiMapped(fileName.c_str());
+            if (mapped->isOpen()) {
+                reader = mapped;
+                DRW_DBG("dxfRW::read memory mapped file\n");
+            } else
+                delete mapped;
+        }
+        if (reader == NULL) {
+            filestr.open (fileName.c_str(), std::ios_base::in);
+            reader = new dxfReaderAscii(&filestr);
+        }
     }
 
     isOk = processDxf();
@@ -117,7 +129,10 @@ bool dxfRW::write(DRW_Interface *interface_, DRW::Version ver, bool bin){
         DRW_DBG("dxfRW::read binary file\n");
     } else {
         filestr.open (fileName.c_str(), std::ios_base::out | std::ios::trunc);
-        writer = new dxfWriterAscii(&filestr);
+        if (buffered)
+            writer = new dxfWriterAsciiBuffered(&filestr);
+        else
+            writer = new dxfWriterAscii(&filestr);
         std::string comm = std::string("dxfrw ") + std::string(DRW_VERSION);
         writer->writeString(999, comm);
     }
@@ -153,9 +168,8 @@ bool dxfRW::write(DRW_Interface *interface_, DRW::Version ver, bool bin){
         writer->writeString(0, "ENDSEC");
     }
     writer->writeString(0, "EOF");
-    filestr.flush();
+    isOk = writer->flush();
     filestr.close();
-    isOk = true;
     delete writer;
     writer = NULL;
     return isOk;
@@ -38,6 +38,13 @@ public:
      */
     bool read(DRW_Interface *interface_, bool ext);
     void setBinary(bool b) {binFile = b;}
+    /// reads ascii files through a memory map instead of a stream, default true
+    /*!
+     * Falls back to the stream reader if the file can't be mapped.
+     */
+    void setMemoryMapped(bool b) {memoryMapped = b;}
+    /// writes ascii files through a large buffer instead of flushing every line, default true
+    void setBuffered(bool b) {buffered = b;}
 
     bool write(DRW_Interface *interface_, DRW::Version ver, bool bin);
     bool writeLineType(DRW_LType *ent);
@@ -126,6 +133,8 @@ private:
     std::string fileName;
     std::string codePage;
     bool binFile;
+    bool memoryMapped;
+    bool buffered;
     dxfReader *reader;
     dxfWriter *writer;
     DRW_Interface *iface;
@@ -143,6 +143,7 @@ void RS_ActionDrawHatch::trigger() {
 			document->endUndoCycle();
 		}
 		hatch->update();
+		container->updateSpatialIndex(hatch.get());
 
 		graphicView->redraw(RS2::RedrawDrawing);
 
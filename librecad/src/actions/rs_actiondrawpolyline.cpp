@@ -319,6 +319,8 @@ void RS_ActionDrawPolyline::coordinateEvent(RS_CoordinateEvent* e) {
 						pPoints->polyline->setPenToActive();
 								container->addEntity(pPoints->polyline);
                         }
+						// the polyline grew after it was added
+						container->updateSpatialIndex(pPoints->polyline);
                         deletePreview();
                         // clearPreview();
                         deleteSnapper();
@@ -519,6 +521,7 @@ void RS_ActionDrawPolyline::undo() {
         }
 		if (pPoints->polyline) {
 			pPoints->polyline->removeLastVertex();
+			container->updateSpatialIndex(pPoints->polyline);
 			graphicView->moveRelativeZero(pPoints->polyline->getEndpoint());
 			graphicView->drawEntity(pPoints->polyline);
         }
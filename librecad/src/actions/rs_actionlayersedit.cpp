@@ -55,6 +55,7 @@ void RS_ActionLayersEdit::trigger() {
                 RS_Layer* l = e->getLayer();
                 if (l && l->getName()==layer->getName()) {
                     e->update();
+                    graphic->updateSpatialIndex(e);
                 }
             }
         }
@@ -201,6 +201,8 @@ void RS_ActionPolylineAppend::coordinateEvent(RS_CoordinateEvent* e) {
 				pPoints->polyline->setLayerToActive();
 				pPoints->polyline->setPenToActive();
 			}
+			// the polyline grew after it was added
+			container->updateSpatialIndex(pPoints->polyline);
                         // RVT_PORT (can be deleted) deletePreview();
 			//clearPreview();
 			deleteSnapper();
@@ -39,6 +39,7 @@
 #include "rs_overlayline.h"
 #include "rs_coordinateevent.h"
 #include "rs_entitycontainer.h"
+#include "rs_document.h"
 #include "rs_pen.h"
 #include "rs_debug.h"
 
@@ -56,6 +57,13 @@ struct RS_Snapper::Indicator
 struct RS_Snapper::ImpData {
 RS_Vector snapCoord;
 RS_Vector snapSpot;
+// last intersection snap, reused while the mouse stays within a pixel
+// and neither the document nor the snap mode changed
+RS_Vector intersectionCoord;
+RS_Vector intersection;
+unsigned long intersectionModification;
+double intersectionFactor;
+RS_SnapMode intersectionMode;
 };
 
 /**
@@ -82,6 +90,7 @@ void RS_Snapper::init()
 	keyEntity = nullptr;
 	pImpData->snapSpot = RS_Vector{false};
 	pImpData->snapCoord = RS_Vector{false};
+	pImpData->intersectionCoord = RS_Vector{false};
 	m_SnapDistance = 1.0;
 
     RS_SETTINGS->beginGroup("/Appearance");
@@ -443,11 +452,29 @@ RS_Vector RS_Snapper::snapDist(const RS_Vector& coord) {
  * @return The coordinates of the point or an invalid vector.
  */
 RS_Vector RS_Snapper::snapIntersection(const RS_Vector& coord) {
-	RS_Vector vec{};
+	ImpData& d = *pImpData;
+	RS_Document* doc = container->getDocument();
+	if (!doc) {
+		return container->getNearestIntersection(coord, nullptr);
+	}
 
-    vec = container->getNearestIntersection(coord,
-											nullptr);
-    return vec;
+	unsigned long const modification = doc->getModificationCount();
+	double const factor = graphicView->getFactor().x;
+	if (d.intersectionCoord.valid
+			&& d.intersectionModification == modification
+			&& d.intersectionFactor == factor
+			&& d.intersectionMode == snapMode
+			&& graphicView->toGuiDX(d.intersectionCoord.distanceTo(coord)) < 1.) {
+		return d.intersection;
+	}
+
+	d.intersection = container->getNearestIntersection(coord,
+														nullptr);
+	d.intersectionCoord = coord;
+	d.intersectionModification = modification;
+	d.intersectionFactor = factor;
+	d.intersectionMode = snapMode;
+	return d.intersection;
 }
 
 
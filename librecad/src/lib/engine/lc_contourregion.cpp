@@ -0,0 +1,287 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "lc_contourregion.h"
+#include "lc_parallel.h"
+#include "lc_splinepoints.h"
+#include "rs_arc.h"
+#include "rs_circle.h"
+#include "rs_ellipse.h"
+#include "rs_entitycontainer.h"
+#include "rs_math.h"
+
+namespace {
+//! points classified by one task of a batch
+constexpr size_t batchSize = 256;
+}
+
+LC_ContourRegion::LC_ContourRegion(RS_EntityContainer* contour, double tolerance):
+	tolerance(tolerance)
+{
+	if (!contour)
+		return;
+
+	for (RS_Entity* e = contour->firstEntity(RS2::ResolveAll); e;
+		 e = contour->nextEntity(RS2::ResolveAll)) {
+		switch (e->rtti()) {
+		case RS2::EntityLine:
+			addEdge({true, e->getStartpoint(),
+					 e->getEndpoint() - e->getStartpoint(), {}, 0., 1.});
+			break;
+		case RS2::EntityArc: {
+			auto arc = static_cast<RS_Arc*>(e);
+			double const r = arc->getRadius();
+			double t0 = arc->isReversed() ? arc->getAngle2() : arc->getAngle1();
+			double t1 = arc->isReversed() ? arc->getAngle1() : arc->getAngle2();
+			t1 = t0 + RS_Math::correctAngle(t1 - t0);
+			if (t1 - t0 < RS_TOLERANCE_ANGLE)
+				t1 += 2.*M_PI;
+			addEdge({false, arc->getCenter(), {r, 0.}, {0., r}, t0, t1});
+			break;
+		}
+		case RS2::EntityCircle: {
+			auto circle = static_cast<RS_Circle*>(e);
+			double const r = circle->getRadius();
+			addEdge({false, circle->getCenter(), {r, 0.}, {0., r}, 0., 2.*M_PI});
+			break;
+		}
+		case RS2::EntityEllipse: {
+			auto ellipse = static_cast<RS_Ellipse*>(e);
+			RS_Vector const u = ellipse->getMajorP();
+			RS_Vector const v = RS_Vector{-u.y, u.x}*ellipse->getRatio();
+			double t0 = 0.;
+			double t1 = 2.*M_PI;
+			if (ellipse->isEllipticArc()) {
+				t0 = ellipse->isReversed() ? ellipse->getAngle2() : ellipse->getAngle1();
+				t1 = ellipse->isReversed() ? ellipse->getAngle1() : ellipse->getAngle2();
+				t1 = t0 + RS_Math::correctAngle(t1 - t0);
+				if (t1 - t0 < RS_TOLERANCE_ANGLE)
+					t1 += 2.*M_PI;
+			}
+			addEdge({false, ellipse->getCenter(), u, v, t0, t1});
+			break;
+		}
+		case RS2::EntitySplinePoints: {
+			std::vector<RS_Vector> const points =
+					static_cast<LC_SplinePoints*>(e)->getStrokePoints();
+			for (size_t i = 1; i < points.size(); ++i)
+				addEdge({true, points[i - 1], points[i] - points[i - 1], {}, 0., 1.});
+			break;
+		}
+		default:
+			break;
+		}
+	}
+	if (pieces.empty())
+		return;
+
+	// bounding box and the height of all pieces relative to the contour
+	minV = RS_Vector{pieces.front().xLow, pieces.front().yLow};
+	maxV = RS_Vector{pieces.front().xHigh, pieces.front().yHigh};
+	for (const Piece& p: pieces) {
+		minV = RS_Vector::minimum(minV, RS_Vector{p.xLow, p.yLow});
+		maxV = RS_Vector::maximum(maxV, RS_Vector{p.xHigh, p.yHigh});
+	}
+	double const height = maxV.y - minV.y + 2.*tolerance;
+	double span = 0.;
+	for (const Piece& p: pieces)
+		span += (p.yHigh - p.yLow + 2.*tolerance)/height;
+
+	// slabs hold about 4 pieces each, unless tall pieces would fill every slab
+	double const count = std::max(1., std::min(65536., 4.*pieces.size()/(1. + span)));
+	size_t const slabs = static_cast<size_t>(count);
+	slabHeight = height/slabs;
+	slabStart.assign(slabs + 1, 0);
+	for (const Piece& p: pieces) {
+		for (size_t i = slabOf(p.yLow - tolerance); i <= slabOf(p.yHigh + tolerance); ++i)
+			++slabStart[i + 1];
+	}
+	for (size_t i = 0; i < slabs; ++i)
+		slabStart[i + 1] += slabStart[i];
+	slabPieces.resize(slabStart.back());
+	std::vector<size_t> fill(slabStart.begin(), slabStart.end() - 1);
+	for (size_t k = 0; k < pieces.size(); ++k) {
+		const Piece& p = pieces[k];
+		for (size_t i = slabOf(p.yLow - tolerance); i <= slabOf(p.yHigh + tolerance); ++i)
+			slabPieces[fill[i]++] = k;
+	}
+}
+
+bool LC_ContourRegion::isEmpty() const {
+	return pieces.empty();
+}
+
+void LC_ContourRegion::addEdge(const Edge& edge) {
+	size_t const index = edges.size();
+	edges.push_back(edge);
+	if (edge.straight) {
+		addPiece(index, 0., 1.);
+		return;
+	}
+	// y(t) = cy + r*cos(t - psi), with extremes at t = psi + k*M_PI
+	double const r = hypot(edge.u.y, edge.v.y);
+	if (r < RS_TOLERANCE) {
+		addPiece(index, edge.t0, edge.t1);
+		return;
+	}
+	double const psi = atan2(edge.v.y, edge.u.y);
+	double t = edge.t0;
+	for (double k = ceil((edge.t0 - psi)/M_PI); t < edge.t1; k += 1.) {
+		double const t1 = std::min(edge.t1, psi + k*M_PI);
+		if (t1 - t > RS_TOLERANCE_ANGLE)
+			addPiece(index, t, t1);
+		t = std::max(t, t1);
+	}
+}
+
+void LC_ContourRegion::addPiece(size_t edge, double t0, double t1) {
+	const Edge& e = edges[edge];
+	RS_Vector const p0 = pointAt(e, t0);
+	RS_Vector const p1 = pointAt(e, t1);
+	Piece piece{edge, t0, t1,
+				std::min(p0.y, p1.y), std::max(p0.y, p1.y),
+				std::min(p0.x, p1.x), std::max(p0.x, p1.x)};
+	if (!e.straight) {
+		// x(t) = cx + r*cos(t - phi), with extremes at t = phi + k*M_PI
+		double const phi = atan2(e.v.x, e.u.x);
+		for (double k = ceil((t0 - phi)/M_PI); phi + k*M_PI < t1; k += 1.) {
+			double const x = pointAt(e, phi + k*M_PI).x;
+			piece.xLow = std::min(piece.xLow, x);
+			piece.xHigh = std::max(piece.xHigh, x);
+		}
+	}
+	pieces.push_back(piece);
+}
+
+RS_Vector LC_ContourRegion::pointAt(const Edge& edge, double t) const {
+	if (edge.straight)
+		return edge.center + edge.u*t;
+	return edge.center + edge.u*cos(t) + edge.v*sin(t);
+}
+
+double LC_ContourRegion::crossing(const Piece& piece, double y) const {
+	const Edge& e = edges[piece.edge];
+	if (e.straight) {
+		double const t = (y - e.center.y)/e.u.y;
+		return e.center.x + e.u.x*t;
+	}
+	double const psi = atan2(e.v.y, e.u.y);
+	double const w = (y - e.center.y)/hypot(e.u.y, e.v.y);
+	double const a = acos(std::max(-1., std::min(1., w)));
+	// of the two solutions, take the one within the piece
+	double const mid = 0.5*(piece.t0 + piece.t1);
+	double best = piece.t0;
+	double bestError = RS_MAXDOUBLE;
+	for (double t: {psi + a, psi - a}) {
+		t = mid + remainder(t - mid, 2.*M_PI);
+		double const error = std::max(piece.t0 - t, t - piece.t1);
+		if (error < bestError) {
+			best = t;
+			bestError = error;
+		}
+	}
+	return pointAt(e, best).x;
+}
+
+double LC_ContourRegion::distanceTo(const Piece& piece, const RS_Vector& point) const {
+	const Edge& e = edges[piece.edge];
+	RS_Vector const p0 = pointAt(e, piece.t0);
+	RS_Vector const p1 = pointAt(e, piece.t1);
+	if (e.straight) {
+		RS_Vector const d = p1 - p0;
+		double const l2 = d.squared();
+		double const t = l2 > RS_TOLERANCE2 ? (point - p0).dotP(d)/l2 : 0.;
+		return point.distanceTo(p0 + d*std::max(0., std::min(1., t)));
+	}
+	double dist = std::min(point.distanceTo(p0), point.distanceTo(p1));
+	double const a = e.u.magnitude();
+	double const b = e.v.magnitude();
+	if (a < RS_TOLERANCE || b < RS_TOLERANCE)
+		return dist;
+	// nearest point on the conic in its own frame by Newton iteration
+	RS_Vector const q = point - e.center;
+	double const x = q.dotP(e.u)/a;
+	double const y = q.dotP(e.v)/b;
+	double t = atan2(a*y, b*x);
+	for (int i = 0; i < 8; ++i) {
+		double const s = sin(t);
+		double const c = cos(t);
+		double const f = (b*b - a*a)*s*c + a*x*s - b*y*c;
+		double const df = (b*b - a*a)*(c*c - s*s) + a*x*c + b*y*s;
+		if (fabs(df) < RS_TOLERANCE)
+			break;
+		t -= f/df;
+	}
+	double const mid = 0.5*(piece.t0 + piece.t1);
+	t = mid + remainder(t - mid, 2.*M_PI);
+	if (t >= piece.t0 && t <= piece.t1)
+		dist = std::min(dist, point.distanceTo(pointAt(e, t)));
+	return dist;
+}
+
+size_t LC_ContourRegion::slabOf(double y) const {
+	double const i = floor((y - minV.y + tolerance)/slabHeight);
+	double const last = static_cast<double>(slabStart.size() - 2);
+	return static_cast<size_t>(std::max(0., std::min(last, i)));
+}
+
+bool LC_ContourRegion::isInside(const RS_Vector& point, bool* onContour) const {
+	if (onContour)
+		*onContour = false;
+	if (pieces.empty()
+			|| point.x < minV.x - tolerance || point.x > maxV.x + tolerance
+			|| point.y < minV.y - tolerance || point.y > maxV.y + tolerance)
+		return false;
+
+	size_t const slab = slabOf(point.y);
+	int counter = 0;
+	for (size_t k = slabStart[slab]; k < slabStart[slab + 1]; ++k) {
+		const Piece& p = pieces[slabPieces[k]];
+		if (onContour && !*onContour
+				&& point.x >= p.xLow - tolerance && point.x <= p.xHigh + tolerance
+				&& point.y >= p.yLow - tolerance && point.y <= p.yHigh + tolerance
+				&& distanceTo(p, point) <= tolerance)
+			*onContour = true;
+		// crossings of the ray to +x
+		if (p.yLow <= point.y && point.y < p.yHigh && p.xHigh > point.x
+				&& (p.xLow > point.x || crossing(p, point.y) > point.x))
+			++counter;
+	}
+	return (counter%2) == 1;
+}
+
+std::vector<char> LC_ContourRegion::isInside(const std::vector<RS_Vector>& points) const {
+	std::vector<char> ret(points.size(), 0);
+	size_t const tasks = (points.size() + batchSize - 1)/batchSize;
+	LC_Parallel::forEach(tasks, [this, &points, &ret](size_t task) {
+		size_t const last = std::min(points.size(), (task + 1)*batchSize);
+		for (size_t i = task*batchSize; i < last; ++i)
+			ret[i] = isInside(points[i]) ? 1 : 0;
+	});
+	return ret;
+}
@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_CONTOURREGION_H
+#define LC_CONTOURREGION_H
+
+#include <vector>
+
+#include "rs_vector.h"
+
+class RS_EntityContainer;
+
+/**
+ * \brief point in region tests against one closed contour
+ *
+ * The contour is read once: lines stay straight edges, arcs, circles and
+ * ellipses are kept as conic edges center + u*cos(t) + v*sin(t), and
+ * spline points are flattened. Edges are split into pieces monotone in y,
+ * which are sorted into horizontal slabs, so a query only looks at the
+ * pieces of one slab and counts the crossings of a ray to +x with them.
+ * A piece is crossed for yLow <= y < yHigh, so a vertex shared by two
+ * pieces is counted once and no ray has to be retried.
+ *
+ * The region holds no pointers to the entities, it stays valid until
+ * the contour changes.
+ *
+ * @see RS_Information::isPointInsideContour()
+ */
+class LC_ContourRegion {
+public:
+	/**
+	 * @param contour one or more closed loops, resolved to atomic entities
+	 * @param tolerance distance from the contour for onContour
+	 */
+	explicit LC_ContourRegion(RS_EntityContainer* contour,
+							  double tolerance = 1.0e-5);
+
+	/**
+	 * @return true, if the point is inside the contour, by even-odd parity
+	 * @param onContour set to true, if the point is within the tolerance
+	 * of the contour
+	 */
+	bool isInside(const RS_Vector& point, bool* onContour = nullptr) const;
+	/**
+	 * classifies many points at once, on worker threads for large batches
+	 * @return 1 for every point inside the contour, 0 otherwise
+	 */
+	std::vector<char> isInside(const std::vector<RS_Vector>& points) const;
+
+	bool isEmpty() const;
+
+private:
+	/**
+	 * a contour edge, either the straight line from center to center + u,
+	 * or the conic center + u*cos(t) + v*sin(t) for t0 <= t <= t1 with u
+	 * perpendicular to v
+	 */
+	struct Edge {
+		bool straight;
+		RS_Vector center;
+		RS_Vector u;
+		RS_Vector v;
+		double t0;
+		double t1;
+	};
+
+	/** part of an edge, along which y is monotone */
+	struct Piece {
+		size_t edge;
+		double t0;
+		double t1;
+		double yLow;
+		double yHigh;
+		double xLow;
+		double xHigh;
+	};
+
+	void addEdge(const Edge& edge);
+	void addPiece(size_t edge, double t0, double t1);
+	RS_Vector pointAt(const Edge& edge, double t) const;
+	/** x of the crossing of a piece with the line at y */
+	double crossing(const Piece& piece, double y) const;
+	double distanceTo(const Piece& piece, const RS_Vector& point) const;
+	size_t slabOf(double y) const;
+
+	double tolerance;
+	std::vector<Edge> edges;
+	std::vector<Piece> pieces;
+	RS_Vector minV;
+	RS_Vector maxV;
+	double slabHeight = 1.;
+	//! pieces of slab i are slabPieces[slabStart[i]] to slabPieces[slabStart[i + 1] - 1]
+	std::vector<size_t> slabStart;
+	std::vector<size_t> slabPieces;
+};
+
+#endif // LC_CONTOURREGION_H
@@ -0,0 +1,220 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "lc_curvecache.h"
+#include "rs_math.h"
+#include "rs_painterqt.h"
+#include "rs_vector.h"
+
+namespace {
+//! segments per chunk
+constexpr int chunkSize = 32;
+//! largest cached radius in pixels, about 13000 points for a full circle
+constexpr double maxRadius = 4096.;
+//! segments of one arc, bounds the sampling once angles lose precision
+constexpr int maxArcSegments = 65536;
+}
+
+bool LC_CurveCache::Key::operator == (const Key& other) const {
+	return zoomBucket == other.zoomBucket
+			&& pattern == other.pattern
+			&& dpmm == other.dpmm
+			&& std::abs(phase - other.phase)
+			<= RS_TOLERANCE * std::max(1., std::abs(phase))
+			&& shape == other.shape;
+}
+
+LC_CurveCache::LC_CurveCache(const LC_CurveCache&) {
+}
+
+LC_CurveCache& LC_CurveCache::operator = (const LC_CurveCache& other) {
+	if (this != &other)
+		clear();
+	return *this;
+}
+
+int LC_CurveCache::zoomBucket(double factor) {
+	if (!(factor > 0.) || !std::isfinite(factor))
+		return INT_MIN;
+	return static_cast<int>(std::floor(std::log2(factor) * 32. + 0.5));
+}
+
+bool LC_CurveCache::isValid(const Key& key) const {
+	return key.zoomBucket != INT_MIN && this->key == key;
+}
+
+void LC_CurveCache::reset(const Key& key, double factor) {
+	this->key = key;
+	this->factor = factor;
+	chunks.clear();
+}
+
+void LC_CurveCache::clear() {
+	key = Key();
+	factor = 0.;
+	chunks.clear();
+	chunks.shrink_to_fit();
+}
+
+bool LC_CurveCache::isCacheable(double radius) {
+	return radius <= maxRadius;
+}
+
+std::vector<std::pair<double, double>> LC_CurveCache::visibleSpans(
+		const QPointF& center, double radius, double angle, double sweep,
+		const QRectF& area) {
+	return visibleSpans(center, radius, radius, 0., angle, sweep, area);
+}
+
+std::vector<std::pair<double, double>> LC_CurveCache::visibleSpans(
+		const QPointF& center, double radius1, double radius2, double angle,
+		double start, double sweep, const QRectF& area) {
+	double const dir = sweep < 0. ? -1. : 1.;
+	double const length = std::abs(sweep);
+
+	// screen offset at parameter t: (xc cos t + xs sin t, yc cos t + ys sin t)
+	double const c = std::cos(angle);
+	double const s = std::sin(angle);
+	double const xc = radius1 * c;
+	double const xs = -radius2 * s;
+	double const yc = -radius1 * s;
+	double const ys = -radius2 * c;
+	auto pointAt = [&](double t) {
+		return QPointF(center.x() + xc * std::cos(t) + xs * std::sin(t),
+					   center.y() + yc * std::cos(t) + ys * std::sin(t));
+	};
+
+	// parameter offsets where the arc crosses the border lines of the area
+	std::vector<double> cuts{0., length};
+	auto addCuts = [&](double a, double b, double v) {
+		// a cos t + b sin t = v
+		double const r = std::hypot(a, b);
+		if (std::abs(v) >= r) return;
+		double const phase = std::atan2(b, a);
+		double const d = std::atan2(std::sqrt((r - v) * (r + v)), v);
+		for (double t: {phase + d, phase - d}) {
+			double const offset = RS_Math::correctAngle(dir * (t - start));
+			if (offset < length)
+				cuts.push_back(offset);
+		}
+	};
+	addCuts(xc, xs, area.left() - center.x());
+	addCuts(xc, xs, area.right() - center.x());
+	addCuts(yc, ys, area.top() - center.y());
+	addCuts(yc, ys, area.bottom() - center.y());
+	std::sort(cuts.begin(), cuts.end());
+
+	// the arc stays on one side of the border between two cuts
+	std::vector<std::pair<double, double>> spans;
+	for (size_t i = 1; i < cuts.size(); ++i) {
+		if (cuts[i] <= cuts[i - 1]) continue;
+		if (!area.contains(pointAt(start + dir * 0.5 * (cuts[i - 1] + cuts[i]))))
+			continue;
+		if (!spans.empty() && spans.back().second == cuts[i - 1])
+			spans.back().second = cuts[i];
+		else
+			spans.emplace_back(cuts[i - 1], cuts[i]);
+	}
+	return spans;
+}
+
+void LC_CurveCache::addArc(double radius, double angle, double sweep) {
+	if (radius < 1.0e-6 || sweep == 0.)
+		return;
+
+	double const aStep = std::min(2.0 / radius, 0.5);
+	int const n = static_cast<int>(std::min<double>(
+			std::ceil(std::abs(sweep) / aStep), maxArcSegments));
+
+	QPolygonF pa;
+	for (int i = 0; i <= n; ++i) {
+		double const a = angle + sweep * i / n;
+		pa << QPointF(std::cos(a) * radius, -std::sin(a) * radius);
+	}
+	addPolyline(pa);
+}
+
+void LC_CurveCache::addEllipse(double radius1, double radius2, double angle,
+							   double start, double sweep) {
+	if (sweep == 0.)
+		return;
+	RS_Vector const vr(radius1, radius2);
+	RS_Vector const rvp(radius2, radius1);
+	double const ab = radius1 * radius2;
+	double const dir = sweep < 0. ? -1. : 1.;
+	double const length = std::abs(sweep);
+	RS_Vector const angleVector(-angle);
+
+	// a new chord after the tangent turned by 0.01 rad, see RS_Painter::createEllipse()
+	QPolygonF pa;
+	double const minDea = length / 2048.;
+	for (double t = 0.; t < length; ) {
+		RS_Vector va(-(start + dir * t));
+		RS_Vector vp = va;
+		double r2 = va.scale(rvp).squared();
+		if (r2 < RS_TOLERANCE15) r2 = RS_TOLERANCE15;
+		double aStep = ab / (r2 * std::sqrt(r2));
+		if (aStep < minDea) aStep = minDea;
+		if (aStep > M_PI / 4.) aStep = M_PI / 4.;
+		t += aStep;
+		vp.scale(vr);
+		vp.rotate(angleVector);
+		pa << QPointF(vp.x, vp.y);
+	}
+
+	RS_Vector vp(std::cos(start + sweep) * radius1, -std::sin(start + sweep) * radius2);
+	vp.rotate(angleVector);
+	pa << QPointF(vp.x, vp.y);
+	addPolyline(pa);
+}
+
+void LC_CurveCache::addPolyline(const QPolygonF& points) {
+	for (int i = 0; i + 1 < points.size(); i += chunkSize) {
+		Chunk chunk;
+		chunk.points = points.mid(i, chunkSize + 1);
+		chunk.box = chunk.points.boundingRect();
+		chunks.push_back(chunk);
+	}
+}
+
+void LC_CurveCache::draw(RS_PainterQt* painter, const QPointF& origin,
+						 double factor, const QRectF& viewport) const {
+	double const scale = factor / this->factor;
+	// thick pens reach into the view from outside
+	double const margin = painter->pen().widthF() + 1.;
+	QRectF const area = viewport.adjusted(-margin, -margin, margin, margin);
+	for (const Chunk& chunk: chunks) {
+		QRectF const& box = chunk.box;
+		if (origin.x() + box.right() * scale < area.left()
+				|| origin.x() + box.left() * scale > area.right()
+				|| origin.y() + box.bottom() * scale < area.top()
+				|| origin.y() + box.top() * scale > area.bottom())
+			continue;
+		painter->drawPolylineBatched(chunk.points, origin, scale);
+	}
+}
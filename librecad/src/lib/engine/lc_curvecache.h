@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_CURVECACHE_H
+#define LC_CURVECACHE_H
+
+#include <array>
+#include <climits>
+#include <utility>
+#include <vector>
+
+#include <QPolygonF>
+#include <QRectF>
+
+struct RS_LineTypePattern;
+class RS_PainterQt;
+
+/**
+ * \brief screen space approximation of an arc, circle or ellipse
+ *
+ * The cache holds the polylines drawn for an entity in pixels relative
+ * to its center, so panning only moves them. It is bound to a key made
+ * of the zoom bucket, the line pattern and the entity shape; the entity
+ * rebuilds the polylines once the key changes. Within one zoom bucket
+ * the polylines are scaled to the current factor.
+ *
+ * Polylines are split into short chunks with bounding boxes, so only the
+ * chunks overlapping the viewport are drawn.
+ *
+ * Curves larger than maxRadius pixels are not cached: a full sampling
+ * would take millions of points at deep zooms. The entity samples only
+ * the spans returned by visibleSpans() for each frame instead.
+ *
+ * Copies of a cache are empty, clones of entities start without
+ * approximation.
+ */
+class LC_CurveCache {
+public:
+	/** everything the approximation depends on */
+	struct Key {
+		int zoomBucket = INT_MIN;
+		//! nullptr for solid lines
+		const RS_LineTypePattern* pattern = nullptr;
+		//! pixels per mm of the painter, pattern scale
+		double dpmm = 0.;
+		//! pattern offset at the start in graph units
+		double phase = 0.;
+		//! entity geometry, independent of the position
+		std::array<double, 6> shape{};
+
+		bool operator == (const Key& other) const;
+	};
+
+	LC_CurveCache() = default;
+	LC_CurveCache(const LC_CurveCache&);
+	LC_CurveCache& operator = (const LC_CurveCache&);
+
+	/** @return the zoom bucket of a view factor, 32 buckets per octave */
+	static int zoomBucket(double factor);
+	/** @return true, if a curve of this radius in pixels may be cached */
+	static bool isCacheable(double radius);
+	/**
+	 * @return the spans of an arc inside the area as angle offsets from
+	 * the start, ordered along the arc
+	 * @param center arc center in screen coordinates
+	 * @param radius radius in pixels
+	 * @param sweep signed angle length, negative for clockwise arcs
+	 */
+	static std::vector<std::pair<double, double>> visibleSpans(
+			const QPointF& center, double radius, double angle, double sweep,
+			const QRectF& area);
+	/**
+	 * @return the spans of an elliptic arc inside the area as offsets of
+	 * the ellipse parameter from the start, ordered along the arc
+	 * @param radius1 major radius in pixels
+	 * @param radius2 minor radius in pixels
+	 * @param angle angle of the major axis
+	 * @param start ellipse parameter at the start
+	 * @param sweep signed parameter length, negative for clockwise arcs
+	 */
+	static std::vector<std::pair<double, double>> visibleSpans(
+			const QPointF& center, double radius1, double radius2, double angle,
+			double start, double sweep, const QRectF& area);
+
+	bool isValid(const Key& key) const;
+	/** drops the polylines and binds the cache to a new key */
+	void reset(const Key& key, double factor);
+	void clear();
+
+	/**
+	 * adds an arc with the radius in pixels, with the chord length
+	 * of RS_Painter::createArc()
+	 * @param angle start angle
+	 * @param sweep signed angle length, negative for clockwise arcs
+	 */
+	void addArc(double radius, double angle, double sweep);
+	/**
+	 * adds an elliptic arc with radii in pixels and angle of the major
+	 * axis, with the steps of RS_Painter::createEllipse(), at most 2048
+	 * segments
+	 * @param start ellipse parameter at the start
+	 * @param sweep signed parameter length, negative for clockwise arcs
+	 */
+	void addEllipse(double radius1, double radius2, double angle,
+					double start, double sweep);
+
+	/**
+	 * draws the chunks overlapping the viewport
+	 * @param origin entity center in screen coordinates
+	 * @param factor current view factor
+	 */
+	void draw(RS_PainterQt* painter, const QPointF& origin, double factor,
+			  const QRectF& viewport) const;
+
+private:
+	struct Chunk {
+		QPolygonF points;
+		QRectF box;
+	};
+
+	void addPolyline(const QPolygonF& points);
+
+	Key key;
+	double factor = 0.;
+	std::vector<Chunk> chunks;
+};
+
+#endif // LC_CURVECACHE_H
@@ -0,0 +1,131 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "lc_endpointindex.h"
+#include "rs_entity.h"
+
+namespace {
+//! cell coordinates are clamped, far away points share the border cells
+constexpr double maxCell = 1.0e18;
+}
+
+size_t LC_EndpointIndex::CellHash::operator () (const Cell& cell) const {
+	std::hash<long long> hasher;
+	size_t const h = hasher(cell.x);
+	return h ^ (hasher(cell.y) + 0x9e3779b9 + (h << 6) + (h >> 2));
+}
+
+LC_EndpointIndex::LC_EndpointIndex(double tolerance):
+	tolerance(std::max(tolerance, RS_TOLERANCE))
+{
+}
+
+LC_EndpointIndex::Cell LC_EndpointIndex::cellOf(const RS_Vector& coord) const {
+	double const x = std::floor(coord.x / tolerance);
+	double const y = std::floor(coord.y / tolerance);
+	return {static_cast<long long>(std::max(-maxCell, std::min(maxCell, x))),
+			static_cast<long long>(std::max(-maxCell, std::min(maxCell, y)))};
+}
+
+void LC_EndpointIndex::insert(RS_Entity* entity) {
+	if (!entity)
+		return;
+	Endpoint endpoint;
+	endpoint.entity = entity;
+	endpoint.order = nextOrder++;
+	insertPoint(entity->getStartpoint(), endpoint);
+	endpoint.start = false;
+	insertPoint(entity->getEndpoint(), endpoint);
+	++size;
+}
+
+void LC_EndpointIndex::remove(RS_Entity* entity) {
+	if (!entity)
+		return;
+	bool const removed = removePoint(entity->getStartpoint(), entity);
+	if (removePoint(entity->getEndpoint(), entity) || removed)
+		--size;
+}
+
+bool LC_EndpointIndex::isEmpty() const {
+	return size == 0;
+}
+
+void LC_EndpointIndex::insertPoint(const RS_Vector& coord, const Endpoint& endpoint) {
+	if (!coord.valid)
+		return;
+	cells[cellOf(coord)].push_back(endpoint);
+}
+
+bool LC_EndpointIndex::removePoint(const RS_Vector& coord, RS_Entity* entity) {
+	if (!coord.valid)
+		return false;
+	auto it = cells.find(cellOf(coord));
+	if (it == cells.end())
+		return false;
+	std::vector<Endpoint>& list = it->second;
+	auto const last = std::remove_if(list.begin(), list.end(),
+									 [entity](const Endpoint& e) {
+		return e.entity == entity;
+	});
+	bool const removed = last != list.end();
+	list.erase(last, list.end());
+	if (list.empty())
+		cells.erase(it);
+	return removed;
+}
+
+bool LC_EndpointIndex::findNearest(const RS_Vector& coord, Endpoint& found,
+								   double* dist) const {
+	if (!coord.valid)
+		return false;
+	Cell const center = cellOf(coord);
+	double minDist = tolerance;
+	bool ret = false;
+	for (long long dx = -1; dx <= 1; ++dx) {
+		for (long long dy = -1; dy <= 1; ++dy) {
+			auto it = cells.find({center.x + dx, center.y + dy});
+			if (it == cells.end())
+				continue;
+			for (const Endpoint& e: it->second) {
+				RS_Vector const p = e.start ? e.entity->getStartpoint()
+											: e.entity->getEndpoint();
+				double const d = p.distanceTo(coord);
+				if (d > minDist || (ret && d == minDist && e.order > found.order))
+					continue;
+				minDist = d;
+				found = e;
+				ret = true;
+			}
+		}
+	}
+	if (ret && dist)
+		*dist = minDist;
+	return ret;
+}
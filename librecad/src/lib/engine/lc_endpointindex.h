@@ -0,0 +1,98 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_ENDPOINTINDEX_H
+#define LC_ENDPOINTINDEX_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "rs_vector.h"
+
+class RS_Entity;
+
+/**
+ * \brief hash grid over the start and end points of entities
+ *
+ * Coordinates are quantized to cells of the size of the tolerance, so
+ * all endpoints within the tolerance of a point are found in the 3x3
+ * cells around it. Used to chain connected entities into contours in
+ * linear time.
+ *
+ * Entities must not be modified while they are indexed.
+ *
+ * @see RS_EntityContainer::optimizeContours()
+ * @see RS_Selection::selectContour()
+ */
+class LC_EndpointIndex {
+public:
+	/** an indexed endpoint */
+	struct Endpoint {
+		RS_Entity* entity = nullptr;
+		//! true for the startpoint, false for the endpoint
+		bool start = true;
+		//! insertion order, breaks ties between equally near endpoints
+		size_t order = 0;
+	};
+
+	explicit LC_EndpointIndex(double tolerance);
+
+	/** adds the startpoint and the endpoint of an entity */
+	void insert(RS_Entity* entity);
+	/** removes both endpoints, the entity must be unchanged since insert() */
+	void remove(RS_Entity* entity);
+	bool isEmpty() const;
+
+	/**
+	 * @brief findNearest the nearest endpoint within the tolerance of a
+	 * coordinate
+	 * @return false, if there is no endpoint within the tolerance
+	 */
+	bool findNearest(const RS_Vector& coord, Endpoint& found,
+					 double* dist = nullptr) const;
+
+private:
+	struct Cell {
+		long long x;
+		long long y;
+		bool operator == (const Cell& other) const {
+			return x == other.x && y == other.y;
+		}
+	};
+	struct CellHash {
+		size_t operator () (const Cell& cell) const;
+	};
+
+	Cell cellOf(const RS_Vector& coord) const;
+	void insertPoint(const RS_Vector& coord, const Endpoint& endpoint);
+	bool removePoint(const RS_Vector& coord, RS_Entity* entity);
+
+	double tolerance;
+	std::unordered_map<Cell, std::vector<Endpoint>, CellHash> cells;
+	size_t nextOrder = 0;
+	size_t size = 0;
+};
+
+#endif // LC_ENDPOINTINDEX_H
@@ -0,0 +1,112 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "lc_glyph.h"
+#include "rs_arc.h"
+#include "rs_block.h"
+#include "rs_circle.h"
+#include "rs_ellipse.h"
+#include "rs_line.h"
+#include "rs_math.h"
+
+LC_Glyph::LC_Glyph(RS_Block* letter):
+	basePoint(letter->getBasePoint())
+{
+	for (RS_Entity* e: *letter)
+		addEntity(e);
+}
+
+void LC_Glyph::addEntity(RS_Entity* e)
+{
+	switch (e->rtti()) {
+	case RS2::EntityLine: {
+		RS_Line* line = static_cast<RS_Line*>(e);
+		moveTo(line->getStartpoint());
+		lineTo(line->getEndpoint());
+		break;
+	}
+	case RS2::EntityArc: {
+		RS_Arc* arc = static_cast<RS_Arc*>(e);
+		double angleLength = arc->getAngleLength();
+		addArc(arc->getCenter(), arc->getRadius(), arc->getAngle1(),
+			   arc->isReversed() ? -angleLength : angleLength);
+		break;
+	}
+	case RS2::EntityCircle: {
+		RS_Circle* circle = static_cast<RS_Circle*>(e);
+		addArc(circle->getCenter(), circle->getRadius(), 0., 2.*M_PI);
+		break;
+	}
+	case RS2::EntityEllipse: {
+		RS_Ellipse* ellipse = static_cast<RS_Ellipse*>(e);
+		double angleLength = ellipse->getAngleLength();
+		if (ellipse->isReversed())
+			angleLength = -angleLength;
+		double radius = ellipse->getMajorRadius();
+		double step = radius > tolerance ?
+					2.*std::acos(1. - tolerance/radius) : M_PI;
+		int n = std::max(1, (int) std::ceil(std::abs(angleLength)/step));
+		double a1 = ellipse->getAngle1();
+		moveTo(ellipse->getEllipsePoint(a1));
+		for (int i = 1; i <= n; ++i)
+			lineTo(ellipse->getEllipsePoint(a1 + angleLength*i/n));
+		break;
+	}
+	default:
+		// polylines and letters referenced by other letters:
+		if (e->isContainer()) {
+			for (RS_Entity* child: *static_cast<RS_EntityContainer*>(e))
+				addEntity(child);
+		}
+		break;
+	}
+}
+
+void LC_Glyph::addArc(const RS_Vector& center, double radius,
+					  double angle1, double angleLength)
+{
+	double step = radius > tolerance ?
+				2.*std::acos(1. - tolerance/radius) : M_PI;
+	int n = std::max(1, (int) std::ceil(std::abs(angleLength)/step));
+	moveTo(center + RS_Vector::polar(radius, angle1));
+	for (int i = 1; i <= n; ++i)
+		lineTo(center + RS_Vector::polar(radius, angle1 + angleLength*i/n));
+}
+
+void LC_Glyph::moveTo(const RS_Vector& p)
+{
+	RS_Vector v = p - basePoint;
+	if (!strokes.empty() && strokes.back().back().distanceTo(v) < RS_TOLERANCE)
+		return;
+	strokes.push_back({v});
+}
+
+void LC_Glyph::lineTo(const RS_Vector& p)
+{
+	strokes.back().push_back(p - basePoint);
+}
@@ -0,0 +1,78 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_GLYPH_H
+#define LC_GLYPH_H
+
+#include <vector>
+
+#include "rs_vector.h"
+
+class RS_Block;
+class RS_Entity;
+
+/**
+ * \brief tessellated outline of one font letter
+ *
+ * A glyph holds the strokes of a letter block as polylines in glyph space,
+ * i.e. relative to the base point of the letter, with arcs replaced by
+ * chords. Glyphs are cached by the font and shared by all letters of all
+ * texts, which only keep a transformation (insertion point, scale, angle).
+ *
+ * @see RS_Font::findGlyph()
+ * @see RS_Insert::setGlyph()
+ */
+class LC_Glyph {
+public:
+	/** tessellates all entities of a letter block */
+	explicit LC_Glyph(RS_Block* letter);
+
+	/** @return the strokes, every stroke is a connected polyline */
+	const std::vector<std::vector<RS_Vector>>& getStrokes() const {
+		return strokes;
+	}
+	bool isEmpty() const {
+		return strokes.empty();
+	}
+
+	/**
+	 * maximum distance in glyph space between a chord and its arc,
+	 * letters are 9 units high
+	 */
+	static constexpr double tolerance = 0.005;
+
+private:
+	void addEntity(RS_Entity* e);
+	void addArc(const RS_Vector& center, double radius,
+				double angle1, double angleLength);
+	/** starts a new stroke, unless p continues the last one */
+	void moveTo(const RS_Vector& p);
+	void lineTo(const RS_Vector& p);
+
+	std::vector<std::vector<RS_Vector>> strokes;
+	RS_Vector basePoint;
+};
+
+#endif // LC_GLYPH_H
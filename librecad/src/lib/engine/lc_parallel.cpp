@@ -0,0 +1,81 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "lc_parallel.h"
+
+namespace {
+std::atomic<unsigned> requestedThreads{0};
+//! true while the thread runs tasks of forEach()
+thread_local bool inTask = false;
+}
+
+unsigned LC_Parallel::threadCount() {
+	if (inTask) {
+		return 1;
+	}
+	unsigned count = requestedThreads;
+	if (count == 0) {
+		count = std::thread::hardware_concurrency();
+	}
+	return std::max(count, 1u);
+}
+
+void LC_Parallel::setThreadCount(unsigned count) {
+	requestedThreads = count;
+}
+
+void LC_Parallel::forEach(size_t count, const std::function<void(size_t)>& task) {
+	size_t const threads = std::min<size_t>(threadCount(), count);
+	if (threads <= 1) {
+		for (size_t i = 0; i < count; ++i) {
+			task(i);
+		}
+		return;
+	}
+
+	std::atomic<size_t> next{0};
+	auto worker = [&]() {
+		inTask = true;
+		for (size_t i = next++; i < count; i = next++) {
+			task(i);
+		}
+		inTask = false;
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	for (size_t i = 1; i < threads; ++i) {
+		workers.emplace_back(worker);
+	}
+	worker();
+	for (std::thread& t: workers) {
+		t.join();
+	}
+}
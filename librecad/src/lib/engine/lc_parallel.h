@@ -0,0 +1,60 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_PARALLEL_H
+#define LC_PARALLEL_H
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * \brief Runs independent tasks on worker threads
+ *
+ * Used for work on entities which only reads shared data, like
+ * regenerating the inserts of different blocks after a file was loaded.
+ * The tasks must not touch the GUI.
+ */
+class LC_Parallel {
+public:
+	/**
+	 * @return number of threads used, at least 1
+	 * Always 1 inside a task of forEach(), nested calls run serially.
+	 */
+	static unsigned threadCount();
+	/**
+	 * @brief setThreadCount limits the number of threads
+	 * @param count 0 for one thread per core, 1 to run everything on
+	 * the calling thread
+	 */
+	static void setThreadCount(unsigned count);
+
+	/**
+	 * @brief forEach calls task(i) for all i in [0, count), the calling
+	 * thread takes part and the call returns once all tasks are done
+	 */
+	static void forEach(size_t count, const std::function<void(size_t)>& task);
+};
+
+#endif // LC_PARALLEL_H
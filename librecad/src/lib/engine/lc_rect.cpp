@@ -21,9 +21,12 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 **********************************************************************/
 #include<iostream>
+#include <algorithm>
+#include <cmath>
 #include <QDebug>
 #include <cassert>
 #include "lc_rect.h"
+#include "rs_math.h"
 
 #define INTERT_TEST(s) qDebug()<<"\ntesting " #s; \
 	assert(s); \
@@ -275,6 +278,82 @@ Area(coord, {coord.x + width, coord.y + height})
 					upperRightCorner(), upperLeftCorner()}};
 	}
 
+	bool LC_Rect::clipLine(const Coordinate& p0, const Coordinate& p1,
+						   double& t0, double& t1) const
+	{
+		double const dx = p1.x - p0.x;
+		double const dy = p1.y - p0.y;
+		// for the left, right, bottom and top borders: the line is inside,
+		// if p*t <= q
+		std::array<std::pair<double, double>, 4> const borders{{
+				{-dx, p0.x - _minP.x}, {dx, _maxP.x - p0.x},
+				{-dy, p0.y - _minP.y}, {dy, _maxP.y - p0.y}
+			}};
+		for (auto const& b: borders) {
+			if (b.first == 0.) {
+				// parallel to this border
+				if (b.second < 0.)
+					return false;
+				continue;
+			}
+			double const t = b.second / b.first;
+			if (b.first < 0.) {
+				// entering
+				if (t > t1)
+					return false;
+				t0 = std::max(t0, t);
+			} else {
+				// leaving
+				if (t < t0)
+					return false;
+				t1 = std::min(t1, t);
+			}
+		}
+		return t0 <= t1;
+	}
+
+	bool LC_Rect::overlapsEllipse(const Coordinate& center, const Coordinate& majorP,
+								  double ratio, double a1, double a2, bool reversed) const
+	{
+		double const a = majorP.magnitude();
+		double const b = a * ratio;
+		if (a < RS_TOLERANCE || b < RS_TOLERANCE)
+			return inArea(center);
+		Coordinate const ux = majorP / a;
+		Coordinate const uy{-ux.y, ux.x};
+		bool const full = fabs(remainder(a2 - a1, 2. * M_PI)) < RS_TOLERANCE_ANGLE;
+
+		// a start inside, otherwise the arc has to cross the border
+		if (inArea(center + ux * (a * cos(a1)) + uy * (b * sin(a1))))
+			return true;
+
+		// the borders in the frame, where the ellipse is the unit circle
+		std::array<Coordinate, 4> corners = vertices();
+		for (Coordinate& c: corners) {
+			Coordinate const q = c - center;
+			c = Coordinate{q.dotP(ux) / a, q.dotP(uy) / b};
+		}
+		for (size_t i = 0; i < corners.size(); ++i) {
+			Coordinate const& q0 = corners[i];
+			Coordinate const d = corners[(i + 1) % corners.size()] - q0;
+			double const qa = d.squared();
+			double const qb = 2. * q0.dotP(d);
+			double const qc = q0.squared() - 1.;
+			double const disc = qb * qb - 4. * qa * qc;
+			if (qa < RS_TOLERANCE2 || disc < 0.)
+				continue;
+			double const root = sqrt(disc);
+			for (double t: {(-qb - root) / (2. * qa), (-qb + root) / (2. * qa)}) {
+				if (t < 0. || t > 1.)
+					continue;
+				Coordinate const p = q0 + d * t;
+				if (full || RS_Math::isAngleBetween(atan2(p.y, p.x), a1, a2, reversed))
+					return true;
+			}
+		}
+		return false;
+	}
+
 	std::ostream& operator<<(std::ostream& os, const Area& area) {
 		os << "Area(" << area.minP() << " " << area.maxP() << ")";
 		return os;
@@ -305,5 +384,33 @@ void LC_Rect::unitTest() {
 	INTERT_TEST(!rect0.inArea({1.1, 1.1}))
 	INTERT_TEST(!rect0.inArea({-1.1, -1.1}))
 
+	// clipLine() tests
+	double t0 = 0., t1 = 1.;
+	INTERT_TEST(rect0.clipLine({-1., 0.5}, {2., 0.5}, t0, t1))
+	INTERT_TEST(fabs(t0 - 1./3.) < 1e-12 && fabs(t1 - 2./3.) < 1e-12)
+	t0 = 0.; t1 = 1.;
+	INTERT_TEST(rect0.clipLine({0.2, 0.2}, {0.8, 0.8}, t0, t1))
+	INTERT_TEST(t0 == 0. && t1 == 1.)
+	t0 = 0.; t1 = 1.;
+	INTERT_TEST(!rect0.clipLine({2., 0.}, {3., 1.}, t0, t1))
+	t0 = 0.; t1 = 1.;
+	INTERT_TEST(!rect0.clipLine({-1., 2.}, {2., 2.}, t0, t1))
+	// infinite line
+	t0 = -1e10; t1 = 1e10;
+	INTERT_TEST(rect0.clipLine({2., 0.5}, {3., 0.5}, t0, t1))
+	INTERT_TEST(fabs(t0 + 2.) < 1e-12 && fabs(t1 + 1.) < 1e-12)
+
+	// overlapsEllipse() tests
+	// circle around the area, through it and inside it
+	INTERT_TEST(!rect0.overlapsEllipse({0.5, 0.5}, {2., 0.}, 1., 0., 0., false))
+	INTERT_TEST(rect0.overlapsEllipse({0., 0.}, {1., 0.}, 1., 0., 0., false))
+	INTERT_TEST(rect0.overlapsEllipse({0.5, 0.5}, {0.2, 0.}, 1., 0., 0., false))
+	// arcs of the unit circle, only the upper right quarter is in the area
+	INTERT_TEST(rect0.overlapsEllipse({0., 0.}, {1., 0.}, 1., -0.5, 0.5, false))
+	INTERT_TEST(!rect0.overlapsEllipse({0., 0.}, {1., 0.}, 1., M_PI, 1.5*M_PI, false))
+	// flat ellipse along the x axis
+	INTERT_TEST(rect0.overlapsEllipse({0., 0.5}, {2., 0.}, 0.1, 0., 0., false))
+	INTERT_TEST(!rect0.overlapsEllipse({0., 2.}, {2., 0.}, 0.1, 0., 0., false))
+
 }
 
@@ -200,6 +200,27 @@ public:
 	 */
 	std::array<Coordinate, 4> vertices() const;
 
+	/**
+	 * @brief clipLine clips the line p0 + t*(p1 - p0) to this area
+	 * (Liang-Barsky), no allocation involved
+	 * @param t0, t1 parameter range to clip, e.g. [0, 1] for the segment
+	 * from p0 to p1, or a huge range for an infinite line. On return, the
+	 * range inside this area
+	 * @return false, if no part of the given range is inside this area
+	 */
+	bool clipLine(const Coordinate& p0, const Coordinate& p1,
+				  double& t0, double& t1) const;
+
+	/**
+	 * @brief overlapsEllipse whether an elliptic arc has a point in this
+	 * area, no allocation involved
+	 * @param majorP major axis relative to the center
+	 * @param ratio minor to major axis ratio, 1 for circular arcs
+	 * @param a1, a2 ellipse angles of the arc ends, equal for a full ellipse
+	 */
+	bool overlapsEllipse(const Coordinate& center, const Coordinate& majorP,
+						 double ratio, double a1, double a2, bool reversed) const;
+
 	static void unitTest();
 
 private:
@@ -0,0 +1,84 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#include "lc_selectionset.h"
+
+bool LC_SelectionSet::insert(RS_Entity* entity) {
+	if (!entity || !position.emplace(entity, order.size()).second)
+		return false;
+	order.push_back(entity);
+	return true;
+}
+
+bool LC_SelectionSet::remove(RS_Entity* entity) {
+	auto it = position.find(entity);
+	if (it == position.end())
+		return false;
+	order[it->second] = nullptr;
+	position.erase(it);
+	if (position.empty())
+		order.clear();
+	else if (order.size() > 2 * position.size() + 16)
+		compact();
+	return true;
+}
+
+bool LC_SelectionSet::contains(RS_Entity* entity) const {
+	return position.count(entity) > 0;
+}
+
+void LC_SelectionSet::clear() {
+	order.clear();
+	position.clear();
+}
+
+size_t LC_SelectionSet::size() const {
+	return position.size();
+}
+
+bool LC_SelectionSet::isEmpty() const {
+	return position.empty();
+}
+
+std::vector<RS_Entity*> LC_SelectionSet::entities() const {
+	std::vector<RS_Entity*> ret;
+	ret.reserve(position.size());
+	forEach([&ret](RS_Entity* entity) {
+		ret.push_back(entity);
+	});
+	return ret;
+}
+
+void LC_SelectionSet::compact() {
+	size_t kept = 0;
+	for (RS_Entity* entity: order) {
+		if (entity) {
+			position[entity] = kept;
+			order[kept++] = entity;
+		}
+	}
+	order.resize(kept);
+}
@@ -0,0 +1,78 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#ifndef LC_SELECTIONSET_H
+#define LC_SELECTIONSET_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+class RS_Entity;
+
+/**
+ * \brief Selected entities of one document in the order they were selected
+ *
+ * Insertion and removal are constant time, removed entities leave a hole
+ * which is compacted once the holes outnumber the entities.
+ * The set is kept by RS_EntityContainer::updateSelection(), which is
+ * called whenever the select flag of a direct child changes.
+ *
+ * @see RS_EntityContainer::getSelectedEntities()
+ */
+class LC_SelectionSet {
+public:
+	/** @return false, if the entity was in the set already */
+	bool insert(RS_Entity* entity);
+	/** @return false, if the entity was not in the set */
+	bool remove(RS_Entity* entity);
+	bool contains(RS_Entity* entity) const;
+	void clear();
+
+	size_t size() const;
+	bool isEmpty() const;
+
+	/** @return the entities in the order they were selected */
+	std::vector<RS_Entity*> entities() const;
+
+	/** calls visitor for every entity in the order they were selected */
+	template<class Visitor>
+	void forEach(Visitor visitor) const {
+		for (RS_Entity* entity: order)
+			if (entity)
+				visitor(entity);
+	}
+
+private:
+	void compact();
+
+	//! entities by selection order, nullptr for removed ones
+	std::vector<RS_Entity*> order;
+	//! position of each entity in order
+	std::unordered_map<RS_Entity*, size_t> position;
+};
+
+#endif // LC_SELECTIONSET_H
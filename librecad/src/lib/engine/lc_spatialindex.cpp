@@ -0,0 +1,579 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+#include "lc_spatialindex.h"
+#include "rs_block.h"
+#include "rs_entitycontainer.h"
+#include "rs_insert.h"
+
+namespace {
+//! maximum number of entries per node
+constexpr size_t maxEntries = 16;
+
+/**
+ * @brief grow the box of an item by the extents of an entity
+ * @return false, if the entity is of infinite size
+ */
+bool grow(const RS_Entity* entity, LC_SpatialIndex::Item& item)
+{
+	switch (entity->rtti()) {
+	case RS2::EntityConstructionLine:
+		return false;
+	case RS2::EntityLine:
+		// lines on construction layers are extended to infinity
+		if (entity->isConstruction())
+			return false;
+		break;
+	default:
+		break;
+	}
+
+	RS_Vector const vMin = entity->getMin();
+	RS_Vector const vMax = entity->getMax();
+	// containers without entities keep their reset borders
+	if (vMin.x <= vMax.x && vMin.y <= vMax.y) {
+		item.minX = std::min(item.minX, vMin.x);
+		item.minY = std::min(item.minY, vMin.y);
+		item.maxX = std::max(item.maxX, vMax.x);
+		item.maxY = std::max(item.maxY, vMax.y);
+	}
+
+	for (RS_Vector const& vp: entity->getRefPoints()) {
+		if (!vp.valid)
+			continue;
+		item.minX = std::min(item.minX, vp.x);
+		item.minY = std::min(item.minY, vp.y);
+		item.maxX = std::max(item.maxX, vp.x);
+		item.maxY = std::max(item.maxY, vp.y);
+	}
+
+	if (entity->rtti() == RS2::EntityInsert
+			&& static_cast<const RS_Insert*>(entity)->isInstanced()
+			&& entity->count() == 0) {
+		// the sub-entities are the block entities placed in the cells
+		auto insert = static_cast<const RS_Insert*>(entity);
+		RS_Block* block = insert->getBlockForInsert();
+		LC_SpatialIndex::Item blockItem{nullptr, 0,
+					RS_MAXDOUBLE, RS_MAXDOUBLE, RS_MINDOUBLE, RS_MINDOUBLE};
+		if (!block || !grow(block, blockItem))
+			return false;
+		if (blockItem.minX > blockItem.maxX || blockItem.minY > blockItem.maxY)
+			return true;
+		int const colStep = std::max(1, insert->getCols() - 1);
+		int const rowStep = std::max(1, insert->getRows() - 1);
+		for (int c = 0; c < insert->getCols(); c += colStep) {
+			for (int r = 0; r < insert->getRows(); r += rowStep) {
+				LC_Rect const box = insert->instanceBox({blockItem.minX, blockItem.minY},
+														{blockItem.maxX, blockItem.maxY},
+														c, r);
+				item.minX = std::min(item.minX, box.minP().x);
+				item.minY = std::min(item.minY, box.minP().y);
+				item.maxX = std::max(item.maxX, box.maxP().x);
+				item.maxY = std::max(item.maxY, box.maxP().y);
+			}
+		}
+		return true;
+	}
+
+	if (entity->isContainer()) {
+		// reference points and centers of sub-entities may be outside
+		// of the borders of the container, e.g. for arcs in blocks
+		for (RS_Entity* e: *static_cast<const RS_EntityContainer*>(entity)) {
+			if (!grow(e, item))
+				return false;
+		}
+	}
+	return true;
+}
+
+template<class Box>
+double squaredDistance(const Box& box, const RS_Vector& coord)
+{
+	double const dx = std::max({box.minX - coord.x, 0., coord.x - box.maxX});
+	double const dy = std::max({box.minY - coord.y, 0., coord.y - box.maxY});
+	return dx*dx + dy*dy;
+}
+
+template<class Box>
+double centerX(const Box& box)
+{
+	return box.minX + box.maxX;
+}
+
+template<class Box>
+double centerY(const Box& box)
+{
+	return box.minY + box.maxY;
+}
+
+template<class Box>
+bool overlaps(const Box& box, const LC_Rect& area)
+{
+	return box.minX <= area.maxP().x && box.maxX >= area.minP().x
+			&& box.minY <= area.maxP().y && box.maxY >= area.minP().y;
+}
+
+template<class Box>
+double boxArea(const Box& box)
+{
+	return (box.maxX - box.minX) * (box.maxY - box.minY);
+}
+
+//! area of the union of two boxes
+template<class Box1, class Box2>
+double mergedArea(const Box1& a, const Box2& b)
+{
+	return (std::max(a.maxX, b.maxX) - std::min(a.minX, b.minX))
+			* (std::max(a.maxY, b.maxY) - std::min(a.minY, b.minY));
+}
+
+/**
+ * @brief sortTileRecursive orders a list of boxes in sort-tile-recursive
+ * order, so consecutive runs of maxEntries boxes form compact tiles
+ */
+template<class T, class GetBox>
+void sortTileRecursive(std::vector<T>& list, GetBox getBox)
+{
+	size_t const count = list.size();
+	size_t const nodeCount = (count + maxEntries - 1) / maxEntries;
+	size_t const sliceCount = static_cast<size_t>(std::ceil(std::sqrt(double(nodeCount))));
+	size_t const sliceSize = sliceCount * maxEntries;
+
+	std::sort(list.begin(), list.end(), [&getBox](const T& a, const T& b) {
+		return centerX(getBox(a)) < centerX(getBox(b));
+	});
+	for (size_t i = 0; i < count; i += sliceSize) {
+		auto const sliceEnd = list.begin() + std::min(count, i + sliceSize);
+		std::sort(list.begin() + i, sliceEnd, [&getBox](const T& a, const T& b) {
+			return centerY(getBox(a)) < centerY(getBox(b));
+		});
+	}
+}
+}
+
+struct LC_SpatialIndex::Node {
+	double minX = RS_MAXDOUBLE;
+	double minY = RS_MAXDOUBLE;
+	double maxX = RS_MINDOUBLE;
+	double maxY = RS_MINDOUBLE;
+	Node* parent = nullptr;
+	bool leaf = true;
+	std::vector<std::unique_ptr<Node>> children;
+	std::vector<Item> items;
+
+	template<class Box>
+	void extend(const Box& box) {
+		minX = std::min(minX, box.minX);
+		minY = std::min(minY, box.minY);
+		maxX = std::max(maxX, box.maxX);
+		maxY = std::max(maxY, box.maxY);
+	}
+
+	size_t size() const {
+		return leaf ? items.size() : children.size();
+	}
+
+	void recalculate() {
+		minX = minY = RS_MAXDOUBLE;
+		maxX = maxY = RS_MINDOUBLE;
+		if (leaf) {
+			for (const Item& item: items)
+				extend(item);
+		} else {
+			for (const auto& child: children)
+				extend(*child);
+		}
+	}
+
+	void move(const RS_Vector& offset) {
+		minX += offset.x;
+		maxX += offset.x;
+		minY += offset.y;
+		maxY += offset.y;
+		for (Item& item: items) {
+			item.minX += offset.x;
+			item.maxX += offset.x;
+			item.minY += offset.y;
+			item.maxY += offset.y;
+		}
+		for (auto& child: children)
+			child->move(offset);
+	}
+};
+
+LC_SpatialIndex::LC_SpatialIndex() = default;
+
+LC_SpatialIndex::~LC_SpatialIndex() = default;
+
+bool LC_SpatialIndex::extents(const RS_Entity* entity, Item& item)
+{
+	item.minX = item.minY = RS_MAXDOUBLE;
+	item.maxX = item.maxY = RS_MINDOUBLE;
+	if (!entity || !grow(entity, item))
+		return false;
+	return item.minX <= item.maxX && item.minY <= item.maxY;
+}
+
+void LC_SpatialIndex::bulkLoad(const std::vector<RS_Entity*>& list)
+{
+	clear();
+
+	std::vector<Item> items;
+	items.reserve(list.size());
+	for (RS_Entity* e: list) {
+		Item item{e, ++lastOrder, 0., 0., 0., 0.};
+		if (extents(e, item))
+			items.push_back(item);
+		else
+			unbounded.push_back(item);
+	}
+	if (items.empty())
+		return;
+
+	// leaves
+	sortTileRecursive(items, [](const Item& item) -> const Item& {
+		return item;
+	});
+	std::vector<std::unique_ptr<Node>> level;
+	for (size_t i = 0; i < items.size(); i += maxEntries) {
+		std::unique_ptr<Node> leaf{new Node};
+		size_t const last = std::min(items.size(), i + maxEntries);
+		for (size_t j = i; j < last; ++j) {
+			leaf->items.push_back(items[j]);
+			leaf->extend(items[j]);
+			leafOf[items[j].entity] = leaf.get();
+		}
+		level.push_back(std::move(leaf));
+	}
+
+	// inner nodes, bottom up
+	while (level.size() > 1) {
+		sortTileRecursive(level, [](const std::unique_ptr<Node>& node) -> const Node& {
+			return *node;
+		});
+		std::vector<std::unique_ptr<Node>> upper;
+		for (size_t i = 0; i < level.size(); i += maxEntries) {
+			std::unique_ptr<Node> node{new Node};
+			node->leaf = false;
+			size_t const last = std::min(level.size(), i + maxEntries);
+			for (size_t j = i; j < last; ++j) {
+				level[j]->parent = node.get();
+				node->extend(*level[j]);
+				node->children.push_back(std::move(level[j]));
+			}
+			upper.push_back(std::move(node));
+		}
+		level = std::move(upper);
+	}
+	root = std::move(level.front());
+	root->parent = nullptr;
+}
+
+void LC_SpatialIndex::insert(RS_Entity* entity, bool prepend)
+{
+	if (!entity)
+		return;
+	Item item{entity, prepend ? --firstOrder : ++lastOrder, 0., 0., 0., 0.};
+	if (extents(entity, item))
+		insertItem(item);
+	else
+		unbounded.push_back(item);
+}
+
+void LC_SpatialIndex::insertItem(const Item& item)
+{
+	if (!root)
+		root.reset(new Node);
+
+	// descend into the child which needs the least enlargement
+	Node* node = root.get();
+	while (!node->leaf) {
+		Node* best = nullptr;
+		double bestGrowth = 0.;
+		double bestArea = 0.;
+		for (const auto& child: node->children) {
+			double const area = boxArea(*child);
+			double const growth = mergedArea(*child, item) - area;
+			if (!best || growth < bestGrowth
+					|| (growth == bestGrowth && area < bestArea)) {
+				best = child.get();
+				bestGrowth = growth;
+				bestArea = area;
+			}
+		}
+		node = best;
+	}
+
+	node->items.push_back(item);
+	leafOf[item.entity] = node;
+	for (Node* n = node; n; n = n->parent)
+		n->extend(item);
+
+	if (node->items.size() > maxEntries)
+		split(node);
+}
+
+/**
+ * Splits an overflowing node into halves along its longer side.
+ */
+void LC_SpatialIndex::split(Node* node)
+{
+	std::unique_ptr<Node> sibling{new Node};
+	sibling->leaf = node->leaf;
+	bool const byX = node->maxX - node->minX >= node->maxY - node->minY;
+
+	if (node->leaf) {
+		std::sort(node->items.begin(), node->items.end(), [byX](const Item& a, const Item& b) {
+			return byX ? centerX(a) < centerX(b) : centerY(a) < centerY(b);
+		});
+		size_t const half = node->items.size() / 2;
+		sibling->items.assign(node->items.begin() + half, node->items.end());
+		node->items.resize(half);
+		for (const Item& item: sibling->items)
+			leafOf[item.entity] = sibling.get();
+	} else {
+		std::sort(node->children.begin(), node->children.end(),
+				  [byX](const std::unique_ptr<Node>& a, const std::unique_ptr<Node>& b) {
+			return byX ? centerX(*a) < centerX(*b) : centerY(*a) < centerY(*b);
+		});
+		size_t const half = node->children.size() / 2;
+		for (size_t i = half; i < node->children.size(); ++i) {
+			node->children[i]->parent = sibling.get();
+			sibling->children.push_back(std::move(node->children[i]));
+		}
+		node->children.resize(half);
+	}
+	node->recalculate();
+	sibling->recalculate();
+
+	Node* parent = node->parent;
+	if (!parent) {
+		std::unique_ptr<Node> newRoot{new Node};
+		newRoot->leaf = false;
+		node->parent = newRoot.get();
+		sibling->parent = newRoot.get();
+		newRoot->children.push_back(std::move(root));
+		newRoot->children.push_back(std::move(sibling));
+		newRoot->recalculate();
+		root = std::move(newRoot);
+		return;
+	}
+
+	sibling->parent = parent;
+	parent->children.push_back(std::move(sibling));
+	if (parent->children.size() > maxEntries)
+		split(parent);
+}
+
+bool LC_SpatialIndex::takeItem(RS_Entity* entity, Item& item)
+{
+	auto const it = leafOf.find(entity);
+	if (it == leafOf.end()) {
+		auto const pos = std::find_if(unbounded.begin(), unbounded.end(),
+									  [entity](const Item& i) {
+			return i.entity == entity;
+		});
+		if (pos == unbounded.end())
+			return false;
+		item = *pos;
+		unbounded.erase(pos);
+		return true;
+	}
+
+	Node* node = it->second;
+	leafOf.erase(it);
+	auto const pos = std::find_if(node->items.begin(), node->items.end(),
+								  [entity](const Item& i) {
+		return i.entity == entity;
+	});
+	item = *pos;
+	node->items.erase(pos);
+
+	// remove empty nodes
+	while (node->parent && node->size() == 0) {
+		Node* parent = node->parent;
+		parent->children.erase(std::find_if(parent->children.begin(), parent->children.end(),
+											[node](const std::unique_ptr<Node>& n) {
+			return n.get() == node;
+		}));
+		node = parent;
+	}
+	tighten(node);
+
+	// shorten the tree
+	while (!root->leaf && root->children.size() == 1) {
+		std::unique_ptr<Node> child = std::move(root->children.front());
+		child->parent = nullptr;
+		root = std::move(child);
+	}
+	if (root->size() == 0)
+		root.reset();
+	return true;
+}
+
+void LC_SpatialIndex::tighten(Node* node)
+{
+	for (; node; node = node->parent)
+		node->recalculate();
+}
+
+bool LC_SpatialIndex::remove(RS_Entity* entity)
+{
+	Item item;
+	return takeItem(entity, item);
+}
+
+void LC_SpatialIndex::update(RS_Entity* entity)
+{
+	Item item;
+	if (!takeItem(entity, item))
+		return;
+	if (extents(entity, item))
+		insertItem(item);
+	else
+		unbounded.push_back(item);
+}
+
+void LC_SpatialIndex::move(const RS_Vector& offset)
+{
+	if (root)
+		root->move(offset);
+	for (Item& item: unbounded) {
+		item.minX += offset.x;
+		item.maxX += offset.x;
+		item.minY += offset.y;
+		item.maxY += offset.y;
+	}
+}
+
+void LC_SpatialIndex::clear()
+{
+	root.reset();
+	unbounded.clear();
+	leafOf.clear();
+	firstOrder = 0;
+	lastOrder = -1;
+}
+
+size_t LC_SpatialIndex::size() const
+{
+	return leafOf.size() + unbounded.size();
+}
+
+bool LC_SpatialIndex::contains(RS_Entity* entity) const
+{
+	if (leafOf.count(entity))
+		return true;
+	return std::any_of(unbounded.begin(), unbounded.end(), [entity](const Item& item) {
+		return item.entity == entity;
+	});
+}
+
+std::vector<RS_Entity*> LC_SpatialIndex::query(const LC_Rect& area, bool sorted) const
+{
+	std::vector<const Item*> found;
+	for (const Item& item: unbounded)
+		found.push_back(&item);
+
+	if (root && overlaps(*root, area)) {
+		std::vector<const Node*> stack{root.get()};
+		while (!stack.empty()) {
+			const Node* node = stack.back();
+			stack.pop_back();
+			if (node->leaf) {
+				for (const Item& item: node->items) {
+					if (overlaps(item, area))
+						found.push_back(&item);
+				}
+				continue;
+			}
+			for (const auto& child: node->children) {
+				if (overlaps(*child, area))
+					stack.push_back(child.get());
+			}
+		}
+	}
+
+	if (sorted) {
+		std::sort(found.begin(), found.end(), [](const Item* a, const Item* b) {
+			return a->order < b->order;
+		});
+	}
+	std::vector<RS_Entity*> ret;
+	ret.reserve(found.size());
+	for (const Item* item: found)
+		ret.push_back(item->entity);
+	return ret;
+}
+
+void LC_SpatialIndex::visitNearest(const RS_Vector& coord,
+								   const std::function<double(RS_Entity*, long)>& visitor) const
+{
+	double radius = RS_MAXDOUBLE;
+	for (const Item& item: unbounded)
+		radius = visitor(item.entity, item.order);
+	if (!root)
+		return;
+
+	// candidates by squared distance of their box, nearest on top
+	struct Candidate {
+		double distance;
+		const Node* node;
+		const Item* item;
+		bool operator < (const Candidate& other) const {
+			return distance > other.distance;
+		}
+	};
+	std::priority_queue<Candidate> queue;
+	queue.push({squaredDistance(*root, coord), root.get(), nullptr});
+
+	while (!queue.empty()) {
+		Candidate const candidate = queue.top();
+		// equal distances are still visited to let the visitor break ties
+		if (candidate.distance > radius * radius)
+			break;
+		queue.pop();
+
+		if (candidate.item) {
+			radius = visitor(candidate.item->entity, candidate.item->order);
+		} else if (candidate.node->leaf) {
+			for (const Item& item: candidate.node->items) {
+				double const d = squaredDistance(item, coord);
+				if (d <= radius * radius)
+					queue.push({d, nullptr, &item});
+			}
+		} else {
+			for (const auto& child: candidate.node->children) {
+				double const d = squaredDistance(*child, coord);
+				if (d <= radius * radius)
+					queue.push({d, child.get(), nullptr});
+			}
+		}
+	}
+}
@@ -0,0 +1,145 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_SPATIALINDEX_H
+#define LC_SPATIALINDEX_H
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "lc_rect.h"
+
+class RS_Entity;
+
+/**
+ * \brief R-tree over the entities of one entity container
+ *
+ * Every entity is stored with its snap extents, i.e. its bounding box
+ * grown by all its reference points (arc centers, spline control points,
+ * insertion points, ...), so the distance from a coordinate to the box is
+ * a lower bound for every getNearest*() result of that entity.
+ * Entities without finite extents (construction lines, lines on
+ * construction layers, containers without borders) are kept aside
+ * and are visited by every query.
+ *
+ * The tree is bulk loaded (sort-tile-recursive) from the entity list and
+ * kept up to date by incremental inserts and removals afterwards.
+ * Every entity carries an order key following the position in the
+ * container, so callers can break ties the same way a linear scan would.
+ *
+ * @see RS_EntityContainer::getSpatialIndex()
+ */
+class LC_SpatialIndex {
+public:
+	/** an indexed entity */
+	struct Item {
+		RS_Entity* entity;
+		//! position in the container, smaller is drawn earlier
+		long order;
+		double minX;
+		double minY;
+		double maxX;
+		double maxY;
+	};
+
+	LC_SpatialIndex();
+	~LC_SpatialIndex();
+	LC_SpatialIndex(const LC_SpatialIndex&) = delete;
+	LC_SpatialIndex& operator = (const LC_SpatialIndex&) = delete;
+
+	/**
+	 * @brief build discards the index and bulk loads all entities of a
+	 * range, the order of the range is the container order
+	 */
+	template<class Iterator>
+	void build(Iterator first, Iterator last) {
+		std::vector<RS_Entity*> list;
+		for (; first != last; ++first)
+			list.push_back(*first);
+		bulkLoad(list);
+	}
+
+	/**
+	 * @brief insert adds an entity
+	 * @param prepend true, if the entity was put in front of the container
+	 */
+	void insert(RS_Entity* entity, bool prepend = false);
+	/** @return false, if the entity was not indexed */
+	bool remove(RS_Entity* entity);
+	/**
+	 * @brief update re-reads the extents of an indexed entity after it was
+	 * modified in place, the container order is kept
+	 */
+	void update(RS_Entity* entity);
+	/** translates all boxes, used when the whole container is moved */
+	void move(const RS_Vector& offset);
+	void clear();
+
+	size_t size() const;
+	bool contains(RS_Entity* entity) const;
+
+	/**
+	 * @brief query entities with extents overlapping the given area
+	 * @param sorted true, to return the entities in container order
+	 */
+	std::vector<RS_Entity*> query(const LC_Rect& area, bool sorted = true) const;
+
+	/**
+	 * @brief visitNearest visits the entities by increasing distance from
+	 * coord to their extents
+	 * The visitor is called with the entity and its order key, and returns
+	 * the current search radius. The traversal stops once every remaining
+	 * box is farther away than the radius.
+	 */
+	void visitNearest(const RS_Vector& coord,
+					  const std::function<double(RS_Entity*, long)>& visitor) const;
+
+	/**
+	 * @brief extents snap extents of an entity
+	 * @return false, if the entity has no finite extents
+	 */
+	static bool extents(const RS_Entity* entity, Item& item);
+
+private:
+	struct Node;
+
+	void bulkLoad(const std::vector<RS_Entity*>& list);
+	void insertItem(const Item& item);
+	bool takeItem(RS_Entity* entity, Item& item);
+	void split(Node* node);
+	void tighten(Node* node);
+
+	std::unique_ptr<Node> root;
+	//! entities visited by every query
+	std::vector<Item> unbounded;
+	//! leaf of each bounded entity
+	std::unordered_map<RS_Entity*, Node*> leafOf;
+	long firstOrder = 0;
+	long lastOrder = -1;
+};
+
+#endif // LC_SPATIALINDEX_H
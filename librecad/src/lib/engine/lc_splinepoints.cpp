@@ -35,6 +35,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "rs_information.h"
 #include "rs_math.h"
 #include "rs_linetypepattern.h"
+#include "lc_rect.h"
 
 
 namespace {
@@ -1897,6 +1898,21 @@ void LC_SplinePoints::drawSimple(RS_Painter* painter, RS_GraphicView* view)
 	painter->drawPath(qPath);
 }
 
+bool LC_SplinePoints::isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const
+{
+	LC_Rect const window{v1, v2};
+	if (!window.intersects(LC_Rect{getMin(), getMax()}))
+		return false;
+	std::vector<RS_Vector> const points = getStrokePoints();
+	for (size_t i = 1; i < points.size(); ++i) {
+		double t0 = 0.;
+		double t1 = 1.;
+		if (window.clipLine(points[i-1], points[i], t0, t1))
+			return true;
+	}
+	return false;
+}
+
 void LC_SplinePoints::draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset)
 {
 	if(painter == nullptr || view == nullptr)
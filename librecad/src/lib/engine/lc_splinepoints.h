@@ -210,6 +210,8 @@ public:
 	void moveRef(const RS_Vector& ref, const RS_Vector& offset) override;
 	void revertDirection() override;
 
+	/** @return true, if the curve has a point in the window */
+	bool isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const;
 	void draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset) override;
     std::vector<RS_Vector> const& getPoints() const;
     std::vector<RS_Vector> const& getControlPoints() const;
@@ -24,6 +24,7 @@
 **********************************************************************/
 
 #include "lc_undosection.h"
+#include "lc_undotransform.h"
 #include "rs_document.h"
 
 LC_UndoSection::LC_UndoSection(RS_Document *doc, const bool handleUndo /*= true*/) :
@@ -48,3 +49,10 @@ void LC_UndoSection::addUndoable(RS_Undoable *undoable)
         document->addUndoable( undoable);
     }
 }
+
+void LC_UndoSection::addTransform(std::unique_ptr<LC_UndoTransform> transform)
+{
+    if (valid) {
+        document->addTransform( std::move( transform));
+    }
+}
@@ -26,6 +26,9 @@
 #ifndef LC_UNDOSECTION_H
 #define LC_UNDOSECTION_H
 
+#include <memory>
+
+class LC_UndoTransform;
 class RS_Document;
 class RS_Undoable;
 
@@ -47,6 +50,7 @@ public:
     ~LC_UndoSection();
 
     void addUndoable(RS_Undoable * undoable);
+    void addTransform(std::unique_ptr<LC_UndoTransform> transform);
 
 private:
     RS_Document *document {nullptr};
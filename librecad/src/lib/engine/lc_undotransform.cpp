@@ -0,0 +1,277 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#include <algorithm>
+#include <cmath>
+
+#include "lc_undotransform.h"
+#include "rs_arc.h"
+#include "rs_circle.h"
+#include "rs_ellipse.h"
+#include "rs_entitycontainer.h"
+#include "rs_insert.h"
+#include "rs_line.h"
+#include "rs_math.h"
+#include "rs_point.h"
+
+void LC_UndoTransform::move(const RS_Vector& offset) {
+	steps.push_back({StepType::Move, offset, RS_Vector(false), 0.});
+}
+
+void LC_UndoTransform::rotate(const RS_Vector& center, double angle) {
+	steps.push_back({StepType::Rotate, center, RS_Vector(false), angle});
+}
+
+void LC_UndoTransform::scale(const RS_Vector& center, const RS_Vector& factor) {
+	steps.push_back({StepType::Scale, center, factor, 0.});
+}
+
+void LC_UndoTransform::mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2) {
+	steps.push_back({StepType::Mirror, axisPoint1, axisPoint2, 0.});
+}
+
+bool LC_UndoTransform::isInvertible(const RS_Entity* entity) const {
+	if (!entity)
+		return false;
+
+	// entities defined by a few values, see store()
+	bool nonUniform = false;
+	switch (entity->rtti()) {
+	case RS2::EntityLine:
+	case RS2::EntityPoint:
+		nonUniform = true;
+		break;
+	case RS2::EntityArc:
+	case RS2::EntityCircle:
+	case RS2::EntityEllipse:
+	case RS2::EntityInsert:
+		break;
+	default:
+		return false;
+	}
+
+	for (const Step& step: steps) {
+		if (step.type != StepType::Scale)
+			continue;
+		if (std::abs(step.v2.x) < RS_TOLERANCE || std::abs(step.v2.y) < RS_TOLERANCE)
+			return false;
+		if (!nonUniform && std::abs(step.v2.x - step.v2.y) > RS_TOLERANCE)
+			return false;
+	}
+	return true;
+}
+
+void LC_UndoTransform::addEntity(RS_Entity* entity) {
+	if (entity) {
+		entities.push_back(entity);
+		store(entity, values);
+	}
+}
+
+const std::vector<RS_Entity*>& LC_UndoTransform::getEntities() const {
+	return entities;
+}
+
+bool LC_UndoTransform::isEmpty() const {
+	return entities.empty() || steps.empty();
+}
+
+void LC_UndoTransform::apply() {
+	for (RS_Entity* e: entities) {
+		for (const Step& step: steps)
+			transform(e, step);
+		finish(e);
+	}
+	finishParents();
+}
+
+void LC_UndoTransform::changeUndoState() {
+	undone = !undone;
+	const double* v = values.data();
+	for (RS_Entity* e: entities) {
+		// redo starts from the same values as apply(), so it ends with
+		// the same bits
+		restore(e, v);
+		if (!undone) {
+			for (const Step& step: steps)
+				transform(e, step);
+		}
+		e->setSelected(false);
+		finish(e);
+	}
+	finishParents();
+}
+
+bool LC_UndoTransform::isUndone() const {
+	return undone;
+}
+
+void LC_UndoTransform::transform(RS_Entity* entity, const Step& step) const {
+	switch (step.type) {
+	case StepType::Move:
+		entity->move(step.v1);
+		break;
+	case StepType::Rotate:
+		entity->rotate(step.v1, step.angle);
+		break;
+	case StepType::Scale:
+		entity->scale(step.v1, step.v2);
+		break;
+	case StepType::Mirror:
+		entity->mirror(step.v1, step.v2);
+		break;
+	}
+}
+
+void LC_UndoTransform::store(const RS_Entity* entity, std::vector<double>& values) {
+	auto add = [&values](const RS_Vector& v) {
+		values.push_back(v.x);
+		values.push_back(v.y);
+	};
+	switch (entity->rtti()) {
+	case RS2::EntityLine: {
+		const RS_Line* line = static_cast<const RS_Line*>(entity);
+		add(line->getStartpoint());
+		add(line->getEndpoint());
+		break;
+	}
+	case RS2::EntityPoint:
+		add(static_cast<const RS_Point*>(entity)->getPos());
+		break;
+	case RS2::EntityCircle: {
+		const RS_Circle* circle = static_cast<const RS_Circle*>(entity);
+		add(circle->getCenter());
+		values.push_back(circle->getRadius());
+		break;
+	}
+	case RS2::EntityArc: {
+		const RS_Arc* arc = static_cast<const RS_Arc*>(entity);
+		add(arc->getCenter());
+		values.push_back(arc->getRadius());
+		values.push_back(arc->getAngle1());
+		values.push_back(arc->getAngle2());
+		values.push_back(arc->isReversed() ? 1. : 0.);
+		break;
+	}
+	case RS2::EntityEllipse: {
+		const RS_Ellipse* ellipse = static_cast<const RS_Ellipse*>(entity);
+		add(ellipse->getCenter());
+		add(ellipse->getMajorP());
+		values.push_back(ellipse->getRatio());
+		values.push_back(ellipse->getAngle1());
+		values.push_back(ellipse->getAngle2());
+		values.push_back(ellipse->isReversed() ? 1. : 0.);
+		break;
+	}
+	case RS2::EntityInsert: {
+		const RS_Insert* insert = static_cast<const RS_Insert*>(entity);
+		add(insert->getInsertionPoint());
+		add(insert->getScale());
+		add(insert->getSpacing());
+		values.push_back(insert->getAngle());
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void LC_UndoTransform::restore(RS_Entity* entity, const double*& values) {
+	// entities are 2D, z and validity are kept
+	auto next = [&values](RS_Vector v) {
+		v.x = *values++;
+		v.y = *values++;
+		return v;
+	};
+	switch (entity->rtti()) {
+	case RS2::EntityLine: {
+		RS_Line* line = static_cast<RS_Line*>(entity);
+		line->setStartpoint(next(line->getStartpoint()));
+		line->setEndpoint(next(line->getEndpoint()));
+		break;
+	}
+	case RS2::EntityPoint: {
+		RS_Point* point = static_cast<RS_Point*>(entity);
+		point->setPos(next(point->getPos()));
+		break;
+	}
+	case RS2::EntityCircle: {
+		RS_Circle* circle = static_cast<RS_Circle*>(entity);
+		circle->setCenter(next(circle->getCenter()));
+		circle->setRadius(*values++);
+		break;
+	}
+	case RS2::EntityArc: {
+		RS_Arc* arc = static_cast<RS_Arc*>(entity);
+		arc->setCenter(next(arc->getCenter()));
+		arc->setRadius(*values++);
+		arc->setAngle1(*values++);
+		arc->setAngle2(*values++);
+		arc->setReversed(*values++ != 0.);
+		break;
+	}
+	case RS2::EntityEllipse: {
+		RS_Ellipse* ellipse = static_cast<RS_Ellipse*>(entity);
+		ellipse->setCenter(next(ellipse->getCenter()));
+		ellipse->setMajorP(next(ellipse->getMajorP()));
+		ellipse->setRatio(*values++);
+		ellipse->setAngle1(*values++);
+		ellipse->setAngle2(*values++);
+		ellipse->setReversed(*values++ != 0.);
+		break;
+	}
+	case RS2::EntityInsert: {
+		RS_Insert* insert = static_cast<RS_Insert*>(entity);
+		insert->setInsertionPoint(next(insert->getInsertionPoint()));
+		insert->setScale(next(insert->getScale()));
+		insert->setSpacing(next(insert->getSpacing()));
+		insert->setAngle(*values++);
+		break;
+	}
+	default:
+		break;
+	}
+	entity->calculateBorders();
+}
+
+void LC_UndoTransform::finish(RS_Entity* entity) const {
+	if (entity->rtti() == RS2::EntityInsert)
+		static_cast<RS_Insert*>(entity)->update();
+	if (RS_EntityContainer* parent = entity->getParent())
+		parent->updateSpatialIndex(entity);
+}
+
+void LC_UndoTransform::finishParents() const {
+	std::vector<RS_EntityContainer*> parents;
+	for (RS_Entity* e: entities) {
+		RS_EntityContainer* parent = e->getParent();
+		if (parent && std::find(parents.begin(), parents.end(), parent) == parents.end())
+			parents.push_back(parent);
+	}
+	// borders shrink as well, adjustBorders() only grows them
+	for (RS_EntityContainer* parent: parents)
+		parent->calculateBorders();
+}
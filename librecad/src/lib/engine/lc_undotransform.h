@@ -0,0 +1,114 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+
+#ifndef LC_UNDOTRANSFORM_H
+#define LC_UNDOTRANSFORM_H
+
+#include <vector>
+
+#include "rs_vector.h"
+
+class RS_Entity;
+
+/**
+ * \brief Undo record of entities transformed in place
+ *
+ * Instead of undoing a transform by replacing the entities with the
+ * originals kept in the undo list, the record keeps the transform steps
+ * and the few values which define each entity before the transform, e.g.
+ * the end points of a line. Undo sets the values back, redo sets them and
+ * replays the steps. Coordinates don't drift over undo/redo cycles like
+ * they would by applying inverse transforms.
+ * Only entities defined by such values can be added, see isInvertible().
+ * Others have to be replaced by transformed clones.
+ *
+ * @see RS_UndoCycle::addTransform()
+ */
+class LC_UndoTransform {
+public:
+	LC_UndoTransform() = default;
+	LC_UndoTransform(const LC_UndoTransform&) = delete;
+	LC_UndoTransform& operator = (const LC_UndoTransform&) = delete;
+
+	//! \{ appends a step to the transform
+	void move(const RS_Vector& offset);
+	void rotate(const RS_Vector& center, double angle);
+	void scale(const RS_Vector& center, const RS_Vector& factor);
+	void mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2);
+	//! \}
+
+	/**
+	 * @return true, if the entity keeps its type and its defining values
+	 * can be stored, e.g. false for polylines or for circles scaled
+	 * non-uniformly
+	 */
+	bool isInvertible(const RS_Entity* entity) const;
+	void addEntity(RS_Entity* entity);
+	const std::vector<RS_Entity*>& getEntities() const;
+	bool isEmpty() const;
+
+	/** transforms the entities, called once when the record is created */
+	void apply();
+	/**
+	 * restores the entities before the transform or transforms them
+	 * again, entities are deselected like by RS_Entity::undoStateChanged()
+	 */
+	void changeUndoState();
+	bool isUndone() const;
+
+private:
+	enum class StepType {
+		Move,
+		Rotate,
+		Scale,
+		Mirror
+	};
+	struct Step {
+		StepType type;
+		RS_Vector v1;
+		RS_Vector v2;
+		double angle;
+	};
+
+	void transform(RS_Entity* entity, const Step& step) const;
+	//! appends the defining values of the entity
+	static void store(const RS_Entity* entity, std::vector<double>& values);
+	//! sets the defining values of the entity and advances values
+	static void restore(RS_Entity* entity, const double*& values);
+	//! re-derives data and refreshes the spatial index of the parent
+	void finish(RS_Entity* entity) const;
+	//! recalculates the borders of the parents once for all entities
+	void finishParents() const;
+
+	std::vector<Step> steps;
+	std::vector<RS_Entity*> entities;
+	//! defining values of the entities before the transform, packed in
+	//! the order of entities
+	std::vector<double> values;
+	bool undone = false;
+};
+
+#endif // LC_UNDOTRANSFORM_H
@@ -920,6 +920,7 @@ public:
                 RedrawGrid = 1,
                 RedrawOverlay = 2,
                 RedrawDrawing = 4,
+                RedrawPan = 8,   /**< Drawing moved, the drawing buffer can be reused */
                 RedrawAll = 0xffff
         };
 
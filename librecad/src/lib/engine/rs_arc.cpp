@@ -890,169 +890,140 @@ void RS_Arc::stretch(const RS_Vector& firstCorner,
     correctAngles(); // make sure angleLength is no more than 2*M_PI
 }
 
-/** find the visible part of the arc, and call drawVisible() to draw */
+bool RS_Arc::isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const {
+	return LC_Rect{v1, v2}.overlapsEllipse(data.center, {data.radius, 0.}, 1.,
+										   data.angle1, data.angle2, data.reversed);
+}
+
+/** draw the arc from its cached screen approximation */
 void RS_Arc::draw(RS_Painter* painter, RS_GraphicView* view,
                   double& patternOffset) {
 	if (!( painter && view)) return;
 
-    //only draw the visible portion of line
-    RS_Vector vpMin(view->toGraph(0,view->getHeight()));
-    RS_Vector vpMax(view->toGraph(view->getWidth(),0));
-    QPolygonF visualBox(QRectF(vpMin.x,vpMin.y,vpMax.x-vpMin.x, vpMax.y-vpMin.y));
-
-    RS_Vector vpStart(isReversed()?getEndpoint():getStartpoint());
-    RS_Vector vpEnd(isReversed()?getStartpoint():getEndpoint());
+    double const factor = view->getFactor().x;
+    double const startOffset = patternOffset;
+    patternOffset -= getLength()*factor;
 
-	std::vector<RS_Vector> vertex(0);
-    for(unsigned short i=0;i<4;i++){
-        const QPointF& vp(visualBox.at(i));
-		vertex.push_back(RS_Vector(vp.x(),vp.y()));
-    }
-    /** angles at cross points */
-	std::vector<double> crossPoints(0);
-
-    double baseAngle=isReversed()?getAngle2():getAngle1();
-    for(unsigned short i=0;i<4;i++){
-		RS_Line line{vertex.at(i),vertex.at((i+1)%4)};
-		auto vpIts=RS_Information::getIntersection(
-                    static_cast<RS_Entity*>(this),
-                    &line,
-                    true);
-        if( vpIts.size()==0) continue;
-		for(const RS_Vector& vp: vpIts){
-			auto ap1=getTangentDirection(vp).angle();
-			auto ap2=line.getTangentDirection(vp).angle();
-            //ignore tangent points, because the arc doesn't cross over
-            if( fabs( remainder(ap2 - ap1, M_PI) ) < RS_TOLERANCE_ANGLE) continue;
-            crossPoints.push_back(
-                        RS_Math::getAngleDifference(baseAngle, getCenter().angleTo(vp))
-                        );
-        }
-    }
-    if(vpStart.isInWindowOrdered(vpMin, vpMax)) crossPoints.push_back(0.);
-    if(vpEnd.isInWindowOrdered(vpMin, vpMax)) crossPoints.push_back(getAngleLength());
-
-    //sorting
-    std::sort(crossPoints.begin(),crossPoints.end());
-    //draw visible
-    RS_Arc arc(*this);
-    arc.setPen(getPen());
-    arc.setSelected(isSelected());
-    arc.setReversed(false);
-	for(size_t i=1;i<crossPoints.size();i+=2){
-		arc.setAngle1(baseAngle+crossPoints[i-1]);
-		arc.setAngle2(baseAngle+crossPoints[i]);
-        arc.drawVisible(painter,view,patternOffset);
-    }
-
-}
+    //only draw the visible portion of arc
+    RS_Vector const vpMin(view->toGraph(0,view->getHeight()));
+    RS_Vector const vpMax(view->toGraph(view->getWidth(),0));
+    if (!LC_Rect{vpMin, vpMax}.intersects(LC_Rect{getMin(), getMax()})) return;
 
-/** directly draw the arc, assuming the whole arc is within visible window */
-void RS_Arc::drawVisible(RS_Painter* painter, RS_GraphicView* view,
-                  double& patternOffset) {
-
-	if (!( painter && view)) return;
-    //visible in graphic view
-    if(isVisibleInWindow(view)==false) return;
-
-    RS_Vector cp=view->toGui(getCenter());
-    double ra=getRadius()*view->getFactor().x;
-    double length=getLength()*view->getFactor().x;
-    //double styleFactor = getStyleFactor();
-    patternOffset -= length;
-
-    // simple style-less lines
-    if ( !isSelected() && (
-             getPen().getLineType()==RS2::SolidLine ||
-             view->getDrawingMode()==RS2::ModePreview)) {
-        painter->drawArc(cp,
-                         ra,
-                         getAngle1(), getAngle2(),
-                         isReversed());
+    RS_Vector const cp=view->toGui(getCenter());
+    double const ra=getRadius()*factor;
+    if (ra<=0.5) {
+        painter->drawGridPoint(cp);
         return;
     }
-//    double styleFactor = getStyleFactor(view);
-    //        if (styleFactor<0.0) {
-    //            painter->drawArc(cp,
-    //                             ra,
-    //                             getAngle1(), getAngle2(),
-    //                             isReversed());
-    //            return;
-    //        }
 
     // Pattern:
-    const RS_LineTypePattern* pat;
+    const RS_LineTypePattern* pat = nullptr;
     if (isSelected()) {
         pat = &RS_LineTypePattern::patternSelected;
-    } else {
+    } else if (getPen().getLineType()!=RS2::SolidLine &&
+               view->getDrawingMode()!=RS2::ModePreview) {
         pat = view->getPattern(getPen().getLineType());
     }
-
-	if (!pat || ra<0.5) {//avoid division by zero from small ra
-		RS_DEBUG->print("%s: Invalid line pattern or radius too small, drawing arc using solid line", __func__);
-        painter->drawArc(cp, ra,
-                         getAngle1(),getAngle2(),
-                         isReversed());
-        return;
+    if (pat && pat->num<=0) {
+        RS_DEBUG->print(RS_Debug::D_WARNING, "RS_Arc::draw(): invalid line pattern\n");
+        pat = nullptr;
     }
 
-//    patternOffset=remainder(patternOffset - length -0.5*pat->totalLength,pat->totalLength)+0.5*pat->totalLength;
+    RS_PainterQt* painterQt = static_cast<RS_PainterQt*>(painter);
+    double const dpmm = pat ? painterQt->getDpmm() : 0.;
+    double const endOffset = startOffset - getLength()*factor;
+    double const sweep = isReversed() ? -getAngleLength() : getAngleLength();
+    QPointF const origin(cp.x, cp.y);
+    QRectF const viewport(0., 0., view->getWidth(), view->getHeight());
+
+    if (pat) {
+        // Pen to draw pattern is always solid:
+        RS_Pen pen = painter->getPen();
+        pen.setLineType(RS2::SolidLine);
+        painter->setPen(pen);
+    }
 
-    if (ra<RS_TOLERANCE_ANGLE){
+    if (!LC_CurveCache::isCacheable(ra)) {
+        // sample only the visible spans of huge arcs
+        curveCache.clear();
+        double const margin = painterQt->pen().widthF() + 1.;
+        LC_CurveCache visible;
+        visible.reset(LC_CurveCache::Key(), factor);
+        for (auto const& span: LC_CurveCache::visibleSpans(origin, ra, getAngle1(), sweep,
+                 viewport.adjusted(-margin, -margin, margin, margin))) {
+            double const a = getAngle1() + (isReversed() ? -span.first : span.first);
+            double const s = (isReversed() ? -1. : 1.)*(span.second - span.first);
+            if (pat) {
+                addPattern(visible, pat, dpmm, ra, a, s, endOffset - span.first*ra);
+            } else {
+                visible.addArc(ra, a, s);
+            }
+        }
+        visible.draw(painterQt, origin, factor, viewport);
         return;
     }
 
-    // Pen to draw pattern is always solid:
-    RS_Pen pen = painter->getPen();
-    pen.setLineType(RS2::SolidLine);
-    painter->setPen(pen);
-
-
+    LC_CurveCache::Key key;
+    key.zoomBucket = LC_CurveCache::zoomBucket(factor);
+    key.pattern = pat;
+    if (pat) {
+        key.dpmm = dpmm;
+        key.phase = startOffset/factor;
+    }
+    key.shape = {{data.radius, data.angle1, data.angle2,
+                  data.reversed ? 1. : 0., 0., 0.}};
+    if (!curveCache.isValid(key)) {
+        curveCache.reset(key, factor);
+        if (pat) {
+            addPattern(curveCache, pat, dpmm, ra, getAngle1(), sweep, endOffset);
+        } else {
+            curveCache.addArc(ra, getAngle1(), sweep);
+        }
+    }
+    curveCache.draw(painterQt, origin, factor, viewport);
+}
 
+/**
+ * adds the dashes of a line pattern along a span of the arc to a curve cache
+ *
+ * @param ra radius in pixels
+ * @param angle start angle of the span
+ * @param sweep signed angle length of the span, negative for reversed arcs
+ * @param patternOffset pattern offset at the end of the arc, shifted by
+ *        the pixel length before the span
+ */
+void RS_Arc::addPattern(LC_CurveCache& cache, const RS_LineTypePattern* pat,
+                        double dpmm, double ra, double angle, double sweep,
+                        double patternOffset) const {
     // create scaled pattern:
-	if(pat->num<=0) { //invalid pattern
-		RS_DEBUG->print(RS_Debug::D_WARNING, "RS_Arc::draw(): invalid line pattern\n");
-		painter->drawArc(cp,
-						 ra,
-						 getAngle1(), getAngle2(),
-						 isReversed());
-		return;
-	}
 	std::vector<double> da(pat->num);
     double patternSegmentLength(pat->totalLength);
 	double ira=1./ra;
-	double dpmm=static_cast<RS_PainterQt*>(painter)->getDpmm();
 	for (size_t i=0; i<pat->num; i++){
-		//        da[j] = pat->pattern[i++] * styleFactor;
 		//fixme, stylefactor needed
 		da[i] =dpmm*(isReversed() ? -fabs(pat->pattern[i]):fabs(pat->pattern[i]));
 		if ( fabs(da[i]) < 1.) da[i] = copysign(1., da[i]);
 		da[i] *= ira;
 	}
 
-    //    bool done = false;
     double total=remainder(patternOffset-0.5*patternSegmentLength,patternSegmentLength)-0.5*patternSegmentLength;
 
-	double a1{RS_Math::correctAngle(getAngle1())};
-	double a2{RS_Math::correctAngle(getAngle2())};
+	double const a1{angle};
+	double const a2{angle + sweep};
 
-    if(isReversed()) {//always draw from a1 to a2, so, patternOffset is automatic
-        if(a1<a2+RS_TOLERANCE_ANGLE) a2 -= 2.*M_PI;
-        total = a1 - total*ira; //in angle
-    }else{
-        if(a2<a1+RS_TOLERANCE_ANGLE) a2 += 2.*M_PI;
-        total = a1 + total*ira; //in angle
-    }
-    double limit(fabs(a1-a2));
+    //always draw from a1 to a2, so, patternOffset is automatic
+    total = isReversed() ? a1 - total*ira : a1 + total*ira; //in angle
+    double limit(fabs(sweep));
     double t2;
 
 	for(int j=0; fabs(total-a1) < limit; j=(j+1)%pat->num) {
 		t2=total+da[j];
+		if (t2 == total) break; //below the angle resolution
 
 		if(pat->pattern[j] > 0.0 && fabs(t2-a2) < limit) {
 			double a11=(fabs(total-a2) < limit)?total:a1;
 			double a21=(fabs(t2-a1) < limit)?t2:a2;
-			painter->drawArc(cp, ra, a11, a21, isReversed());
+			cache.addArc(ra, a11, a21 - a11);
 		}
 
 		total=t2;
@@ -28,6 +28,7 @@
 #define RS_ARC_H
 
 #include "rs_atomicentity.h"
+#include "lc_curvecache.h"
 class LC_Quadratic;
 
 
@@ -224,10 +225,13 @@ public:
                          const RS_Vector& secondCorner,
 						 const RS_Vector& offset) override;
 
-    /** find the visible part of the arc, and call drawVisible() to draw */
+    /** @return true, if the arc has a point in the window */
+	bool isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const;
+    /**
+     * draws the arc from a screen approximation, which is kept while
+     * the zoom bucket, the line pattern and the shape stay the same
+     */
 	void draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset) override;
-    /** directly draw the arc, assuming the whole arc is within visible window */
-	void drawVisible(RS_Painter* painter, RS_GraphicView* view, double& patternOffset);
 
     friend std::ostream& operator << (std::ostream& os, const RS_Arc& a);
 
@@ -251,7 +255,13 @@ m0 x + m1 y + m2 =0
 	virtual double areaLineIntegral() const override;
 
 protected:
+	void addPattern(LC_CurveCache& cache, const RS_LineTypePattern* pat,
+					double dpmm, double ra, double angle, double sweep,
+					double patternOffset) const;
+
 	RS_ArcData data;
+	//! screen approximation used by draw()
+	mutable LC_CurveCache curveCache;
 };
 
 #endif
@@ -53,6 +53,8 @@ RS_BlockList::RS_BlockList(bool owner) {
  */
 void RS_BlockList::clear() {
     blocks.clear();
+    blockByName.clear();
+    nestedBlocks.clear();
 	activeBlock = nullptr;
 	setModified(true);
 }
@@ -98,6 +100,11 @@ bool RS_BlockList::add(RS_Block* block, bool notify) {
     RS_Block* b = find(block->getName());
 	if (!b) {
         blocks.append(block);
+        blockByName.insert(block->getName(), block);
+        RS_BlockList* nested = block->getBlockList();
+        if (nested && nested != this) {
+            nestedBlocks.append(block);
+        }
 
         if (notify) {
             addNotification();
@@ -140,6 +147,10 @@ void RS_BlockList::remove(RS_Block* block) {
 
     // here the block is removed from the list but not deleted
     blocks.removeOne(block);
+    if (blockByName.value(block->getName()) == block) {
+        blockByName.remove(block->getName());
+    }
+    nestedBlocks.removeOne(block);
 
 	for(auto l: blockListListeners){
 		l->blockRemoved(block);
@@ -173,6 +184,10 @@ void RS_BlockList::remove(RS_Block* block) {
 bool RS_BlockList::rename(RS_Block* block, const QString& name) {
 	if (block) {
 		if (!find(name)) {
+			if (blockByName.value(block->getName()) == block) {
+				blockByName.remove(block->getName());
+				blockByName.insert(name, block);
+			}
 			block->setName(name);
 			setModified(true);
 			return true;
@@ -212,24 +227,28 @@ RS_Block* RS_BlockList::find(const QString& name) {
         RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_BlockList::find(): wrong name to find");
         return nullptr;
     }
-	// Todo : reduce this from O(N) to O(log(N)) complexity based on sorted list or hash
-	//DFS
+	if (nestedBlocks.isEmpty()) {
+		return blockByName.value(name, nullptr);
+	}
+	//DFS over the nested block lists
 	std::vector<RS_BlockList const*> nodes;
 	std::set<RS_BlockList const*> searched;
 	searched.insert(nullptr);
+	searched.insert(this);
 	nodes.push_back(this);
 	while (nodes.size()) {
 		auto list = nodes.back();
 		nodes.pop_back();
-        for (RS_Block* blk: *list) {
-            if (blk->getName() == name) {
-                RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_BlockList::find(): OK");
-                return blk;
-            }
-            auto node = blk->getBlockList();
+		RS_Block* blk = list->blockByName.value(name, nullptr);
+		if (blk) {
+			RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_BlockList::find(): OK");
+			return blk;
+		}
+		for (RS_Block* nested: list->nestedBlocks) {
+			auto node = nested->getBlockList();
 			if (!searched.count(node)) {
-				searched.insert(list);
-                nodes.push_back(blk->getBlockList());
+				searched.insert(node);
+				nodes.push_back(node);
 			}
 		}
 	}
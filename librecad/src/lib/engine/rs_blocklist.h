@@ -29,9 +29,10 @@
 #define RS_BLOCKLIST_H
 
 
+#include <QHash>
 #include <QList>
+#include <QString>
 
-class QString;
 class RS_Block;
 class RS_BlockListListener;
 
@@ -102,6 +103,10 @@ private:
     bool owner;
     //! Blocks in the graphic
     QList<RS_Block*> blocks;
+    //! Blocks by name, for find()
+    QHash<QString, RS_Block*> blockByName;
+    //! Blocks of other graphics, find() also searches their block lists
+    QList<RS_Block*> nestedBlocks;
     //! List of registered BlockListListeners
     QList<RS_BlockListListener*> blockListListeners;
     //! Currently active block
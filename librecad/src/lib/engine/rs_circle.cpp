@@ -41,6 +41,7 @@
 #include "lc_hyperbola.h"
 #include "lc_quadratic.h"
 #include "rs_debug.h"
+#include "lc_rect.h"
 
 RS_CircleData::RS_CircleData(RS_Vector const& center, double radius):
 	center(center)
@@ -766,14 +767,28 @@ bool RS_Circle::isVisibleInWindow(RS_GraphicView* view) const
 }
 
 
+bool RS_Circle::isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const {
+	return LC_Rect{v1, v2}.overlapsEllipse(data.center, {data.radius, 0.}, 1.,
+										   0., 0., false);
+}
+
+
 void RS_Circle::draw(RS_Painter* painter, RS_GraphicView* view, double& /*patternOffset*/) {
-//    // draw circle as a 2 pi arc
-//    RS_Arc arc(getParent(), RS_ArcData(getCenter(),getRadius(),0.,2.*M_PI, false));
-//    arc.setSelected(isSelected());
-//    arc.setPen(getPen());
-//    arc.draw(painter,view,patternOffset);
+	if (!(painter && view)) return;
+
+	RS_Vector const vpMin(view->toGraph(0,view->getHeight()));
+	RS_Vector const vpMax(view->toGraph(view->getWidth(),0));
+	if (!LC_Rect{vpMin, vpMax}.intersects(LC_Rect{minV, maxV})) return;
+
+	double const factor = view->getFactor().x;
+	RS_Vector const cp = view->toGui(getCenter());
+	double const ra = getRadius()*factor;
+	if (ra<=0.5) {
+		painter->drawGridPoint(cp);
+		return;
+	}
 
-    painter->drawCircle(view->toGui(getCenter()), view->toGuiDX(getRadius()));
+	painter->drawCircle(cp, ra);
 }
 
 
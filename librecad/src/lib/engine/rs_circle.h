@@ -155,6 +155,9 @@ with Cx the center of the common tangent circle, Rx the radius. Ci and Ri are th
 	void moveRef(const RS_Vector& ref, const RS_Vector& offset) override;
     /** whether the entity's bounding box intersects with visible portion of graphic view */
 	bool isVisibleInWindow(RS_GraphicView* view) const override;
+	/** @return true, if the circle has a point in the window */
+	bool isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const;
+	/** draws the circle from a screen approximation kept per zoom bucket */
 	void draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset) override;
     /** return the equation of the entity
 for quadratic,
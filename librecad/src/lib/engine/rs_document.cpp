@@ -26,8 +26,14 @@
 **********************************************************************/
 
 
+#include <algorithm>
+#include <unordered_set>
+
 #include "rs_document.h"
 #include "rs_debug.h"
+#include "rs_insert.h"
+#include "lc_selectionset.h"
+#include "lc_spatialindex.h"
 
 
 /**
@@ -51,6 +57,216 @@ RS_Document::RS_Document(RS_EntityContainer* parent)
     gv = NULL;//used to read/save current view
 }
 
+RS_Document::RS_Document(const RS_Document& doc)
+        : RS_EntityContainer(doc), RS_Undo()
+        , modified(doc.modified)
+        , activePen(doc.activePen)
+        , filename(doc.filename)
+        , autosaveFilename(doc.autosaveFilename)
+        , formatType(doc.formatType)
+        , gv(doc.gv) {
+}
+
+RS_Document::~RS_Document() {
+    if (isOwner()) {
+        for (auto const& u: undoneEntities) {
+            delete u.first;
+        }
+    }
+}
+
+
+void RS_Document::removeUndoable(RS_Undoable* u)
+{
+    if (!u || u->undoRtti()!=RS2::UndoableEntity) {
+        return;
+    }
+    RS_Entity* e = static_cast<RS_Entity*>(u);
+    if (undoneEntities.erase(e)) {
+        if (spatialIndex) {
+            spatialIndex->remove(e);
+        }
+        if (selection) {
+            selection->remove(e);
+        }
+        if (isOwner()) {
+            delete e;
+        }
+    } else {
+        removeEntity(e);
+    }
+}
+
+
+std::vector<RS_Entity*> RS_Document::getUndoneEntities() const
+{
+    std::vector<RS_Entity*> ret;
+    ret.reserve(undoneEntities.size());
+    for (auto const& u: undoneEntities) {
+        ret.push_back(u.first);
+    }
+    return ret;
+}
+
+
+void RS_Document::renameInserts(const QString& oldName, const QString& newName)
+{
+    RS_EntityContainer::renameInserts(oldName, newName);
+    for (auto const& u: undoneEntities) {
+        RS_Entity* e = u.first;
+        if (e->rtti()==RS2::EntityInsert) {
+            RS_Insert* i = static_cast<RS_Insert*>(e);
+            if (i->getName()==oldName) {
+                i->setName(newName);
+            }
+        } else if (e->isContainer()) {
+            static_cast<RS_EntityContainer*>(e)->renameInserts(oldName, newName);
+        }
+    }
+}
+
+
+/**
+ * Moves the undone entities out of the entity list, so draw, snap and
+ * export passes don't have to skip them.
+ */
+void RS_Document::storeUndoables(const std::set<RS_Undoable*>& undoables)
+{
+    std::unordered_set<RS_Entity*> store;
+    for (RS_Undoable* u: undoables) {
+        if (u->undoRtti()==RS2::UndoableEntity && u->isUndone()) {
+            RS_Entity* e = static_cast<RS_Entity*>(u);
+            if (e->getParent() == this && !undoneEntities.count(e)) {
+                store.insert(e);
+            }
+        }
+    }
+    if (store.empty()) {
+        return;
+    }
+
+    ++storePasses;
+    int kept = 0;
+    RS_Entity* anchor = nullptr;
+    for (int i = 0; i < entities.size(); ++i) {
+        RS_Entity* e = entities.at(i);
+        if (e->getFlag(RS2::FlagUndone) && store.count(e)) {
+            undoneEntities[e] = UndonePosition{anchor, i, storePasses};
+        } else {
+            entities[kept++] = e;
+            anchor = e;
+        }
+    }
+    entities.erase(entities.begin() + kept, entities.end());
+}
+
+
+/**
+ * Puts entities which are about to be redone back to their former
+ * position in the entity list. Each one goes behind its anchor, or the
+ * anchor's anchor if that one is still undone. The index is only used
+ * when the anchor has left the document, because the list may have been
+ * reordered in the meantime.
+ */
+void RS_Document::restoreUndoables(const std::set<RS_Undoable*>& undoables)
+{
+    std::unordered_map<RS_Entity*, UndonePosition> restore;
+    for (RS_Undoable* u: undoables) {
+        if (u->undoRtti()!=RS2::UndoableEntity) {
+            continue;
+        }
+        auto it = undoneEntities.find(static_cast<RS_Entity*>(u));
+        if (it != undoneEntities.end()) {
+            restore.insert(*it);
+        }
+    }
+    if (restore.empty()) {
+        return;
+    }
+    for (auto const& r: restore) {
+        undoneEntities.erase(r.first);
+    }
+
+    std::unordered_set<RS_Entity*> present(entities.begin(), entities.end());
+    // anchors are compared only, they may have been deleted already
+    auto resolve = [this, &restore, &present](UndonePosition pos) -> RS_Entity* {
+        for (;;) {
+            if (!pos.anchor || present.count(pos.anchor) || restore.count(pos.anchor)) {
+                return pos.anchor;
+            }
+            auto it = undoneEntities.find(pos.anchor);
+            if (it == undoneEntities.end()) {
+                // gone, fall back to the index
+                int const i = std::min(pos.index, entities.size());
+                return i > 0 ? entities.at(i - 1) : nullptr;
+            }
+            pos.anchor = it->second.anchor;
+        }
+    };
+
+    // entities to insert behind each anchor, in their former order
+    std::unordered_map<RS_Entity*, std::vector<std::pair<UndonePosition, RS_Entity*>>> behind;
+    for (auto const& r: restore) {
+        behind[resolve(r.second)].emplace_back(r.second, r.first);
+        if (spatialIndex && !spatialIndex->contains(r.first)) {
+            // the index was rebuilt without the entity
+            invalidateSpatialIndex();
+        }
+    }
+    for (auto& b: behind) {
+        std::sort(b.second.begin(), b.second.end(),
+                  [](const std::pair<UndonePosition, RS_Entity*>& a,
+                     const std::pair<UndonePosition, RS_Entity*>& b) {
+            return a.first.pass != b.first.pass ? a.first.pass < b.first.pass
+                                                : a.first.index < b.first.index;
+        });
+    }
+
+    QList<RS_Entity*> merged;
+    merged.reserve(entities.size() + restore.size());
+    // restored entities can be anchors of other restored ones
+    std::vector<RS_Entity*> pending;
+    auto append = [&behind, &merged, &pending](RS_Entity* anchor) {
+        pending.push_back(anchor);
+        while (!pending.empty()) {
+            RS_Entity* a = pending.back();
+            pending.pop_back();
+            if (a) {
+                merged.append(a);
+            }
+            auto it = behind.find(a);
+            if (it == behind.end()) {
+                continue;
+            }
+            for (auto r = it->second.rbegin(); r != it->second.rend(); ++r) {
+                pending.push_back(r->second);
+            }
+            behind.erase(it);
+        }
+    };
+    append(nullptr);
+    for (RS_Entity* e: entities) {
+        append(e);
+    }
+    entities.swap(merged);
+}
+
+
+/**
+ * Overwritten to refresh the spatial index for entities which were
+ * modified in place before they were added to the undo cycle.
+ */
+void RS_Document::addUndoable(RS_Undoable* u)
+{
+    if (u && u->undoRtti()==RS2::UndoableEntity) {
+        updateSpatialIndex(static_cast<RS_Entity*>(u));
+    }
+    touch();
+
+    RS_Undo::addUndoable(u);
+}
+
+
 /**
  * Overwritten to set modified flag when undo cycle finished with undoable(s).
  */
@@ -59,7 +275,23 @@ void RS_Document::endUndoCycle()
     if (hasUndoable()) {
         setModified(true);
     }
+    // in place transforms are only recorded in the cycle
+    touch();
 
     RS_Undo::endUndoCycle();
 }
 
+
+bool RS_Document::undo()
+{
+    touch();
+    return RS_Undo::undo();
+}
+
+
+bool RS_Document::redo()
+{
+    touch();
+    return RS_Undo::redo();
+}
+
@@ -29,6 +29,9 @@
 #ifndef RS_DOCUMENT_H
 #define RS_DOCUMENT_H
 
+#include <unordered_map>
+#include <vector>
+
 #include "rs_layerlist.h"
 #include "rs_entitycontainer.h"
 #include "rs_undo.h"
@@ -47,7 +50,12 @@ class RS_Document : public RS_EntityContainer,
     public RS_Undo {
 public:
 	RS_Document(RS_EntityContainer* parent=nullptr);
-	virtual ~RS_Document() = default;
+	/**
+	 * Copies the entities and settings, but not the undo state. The undo
+	 * cycles and the undone entities stay with the original document.
+	 */
+	RS_Document(const RS_Document& doc);
+	virtual ~RS_Document();
 
     virtual RS_LayerList* getLayerList() = 0;
     virtual RS_BlockList* getBlockList() = 0;
@@ -70,11 +78,18 @@ public:
      * Removes an entity from the entiy container. Implementation
      * from RS_Undo.
      */
-    virtual void removeUndoable(RS_Undoable* u) {
-        if (u && u->undoRtti()==RS2::UndoableEntity) {
-			removeEntity(static_cast<RS_Entity*>(u));
-        }
-    }
+    virtual void removeUndoable(RS_Undoable* u);
+
+    /**
+     * @return Undone entities of this document. They are kept out of
+     * the entity list until they are redone or removed from the undo list.
+     */
+    std::vector<RS_Entity*> getUndoneEntities() const;
+
+    /**
+     * Overwritten to rename the undone inserts as well.
+     */
+    void renameInserts(const QString& oldName, const QString& newName) override;
 
     /**
      * @return Currently active drawing pen.
@@ -128,17 +143,47 @@ public:
         return modified;
     }
 
+    /**
+     * Overwritten to refresh the spatial index for entities which were
+     * modified in place before they were added to the undo cycle.
+     */
+    virtual void addUndoable(RS_Undoable* u) override;
+
     /**
      * Overwritten to set modified flag when undo cycle finished with undoable(s).
      */
     virtual void endUndoCycle() override;
 
+    virtual bool undo() override;
+    virtual bool redo() override;
+
+    /**
+     * @return Counter which changes whenever entities of the document are
+     * added, edited, undone or redone, to invalidate cached query results.
+     */
+    virtual unsigned long getModificationCount() const {
+        return modificationCount;
+    }
+
+    /**
+     * Bumps the modification counter, for changes which don't pass
+     * addUndoable(), endUndoCycle(), undo() or redo().
+     */
+    void touch() {
+        ++modificationCount;
+    }
+
     void setGraphicView(RS_GraphicView * g) {gv = g;}
     RS_GraphicView* getGraphicView() {return gv;}
 
 protected:
+    void restoreUndoables(const std::set<RS_Undoable*>& undoables) override;
+    void storeUndoables(const std::set<RS_Undoable*>& undoables) override;
+
     /** Flag set if the document was modified and not yet saved. */
     bool modified;
+    /** see getModificationCount() */
+    unsigned long modificationCount = 0;
     /** Active pen. */
     RS_Pen activePen;
     /** File name of the document or empty for a new document. */
@@ -148,6 +193,24 @@ protected:
 	/** Format type */
 	RS2::FormatType formatType;
     RS_GraphicView * gv;//used to read/save current view
+    /**
+     * Position of an undone entity in the entity list: the closest kept
+     * entity before it (nullptr at the front) and, as fallback, its index.
+     * pass counts the storeUndoables() calls, entities stored after the
+     * same anchor by a later pass were behind the earlier ones.
+     */
+    struct UndonePosition {
+        RS_Entity* anchor;
+        int index;
+        unsigned long pass;
+    };
+    /**
+     * Undone entities moved out of the entity list with their former
+     * position. They stay in the spatial index, which skips undone
+     * entities anyway.
+     */
+    std::unordered_map<RS_Entity*, UndonePosition> undoneEntities;
+    unsigned long storePasses = 0;
 
 };
 
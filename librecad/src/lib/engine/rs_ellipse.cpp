@@ -38,6 +38,7 @@
 #include  "lc_quadratic.h"
 #include "rs_painterqt.h"
 #include "rs_debug.h"
+#include "lc_rect.h"
 
 #ifdef EMU_C99
 #include "emu_c99.h" /* C99 math */
@@ -1695,153 +1696,144 @@ double RS_Ellipse::getMinorRadius() const {
 	return data.majorP.magnitude()*data.ratio;
 }
 
-void RS_Ellipse::draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset) {
-	if(isEllipticArc()==false){
-        RS_Ellipse arc(*this);
-        arc.setAngle2(2.*M_PI);
-        arc.setReversed(false);
-        arc.draw(painter,view,patternOffset);
-        return;
-    }
-    //only draw the visible portion of line
-    RS_Vector vpMin(view->toGraph(0,view->getHeight()));
-    RS_Vector vpMax(view->toGraph(view->getWidth(),0));
-    QPolygonF visualBox(QRectF(vpMin.x,vpMin.y,vpMax.x-vpMin.x, vpMax.y-vpMin.y));
-
-    RS_Vector vpStart(isReversed()?getEndpoint():getStartpoint());
-    RS_Vector vpEnd(isReversed()?getStartpoint():getEndpoint());
-
-	std::vector<RS_Vector> vertex(0);
-    for(unsigned short i=0;i<4;i++){
-        const QPointF& vp(visualBox.at(i));
-		vertex.emplace_back(vp.x(),vp.y());
-    }
-    /** angles at cross points */
-	std::vector<double> crossPoints(0);
-
-    double baseAngle=isReversed()?getAngle2():getAngle1();
-    for(unsigned short i=0;i<4;i++){
-		RS_Line line{vertex.at(i),vertex.at((i+1)%4)};
-		auto vpIts=RS_Information::getIntersection(
-                    static_cast<RS_Entity*>(this), &line, true);
-//    std::cout<<"vpIts.size()="<<vpIts.size()<<std::endl;
-        if( vpIts.size()==0) continue;
-		for(const RS_Vector& vp: vpIts){
-			auto ap1=getTangentDirection(vp).angle();
-			auto ap2=line.getTangentDirection(vp).angle();
-            //ignore tangent points, because the arc doesn't cross over
-            if( fabs( remainder(ap2 - ap1, M_PI) ) < RS_TOLERANCE_ANGLE) continue;
-            crossPoints.push_back(
-                        RS_Math::getAngleDifference(baseAngle, getEllipseAngle(vp))
-                        );
-        }
-    }
-    if(vpStart.isInWindowOrdered(vpMin, vpMax)) crossPoints.push_back(0.);
-    if(vpEnd.isInWindowOrdered(vpMin, vpMax)) crossPoints.push_back(
-                RS_Math::getAngleDifference(baseAngle,isReversed()?getAngle1():getAngle2())
-                );
-
-
-    //sorting
-    std::sort(crossPoints.begin(),crossPoints.end());
-    //draw visible
-//    DEBUG_HEADER
-//    std::cout<<"crossPoints.size()="<<crossPoints.size()<<std::endl;
-    RS_Ellipse arc(*this);
-    arc.setSelected(isSelected());
-    arc.setPen(getPen());
-    arc.setReversed(false);
-    if( crossPoints.size() >= 2) {
-		for(size_t i=1;i<crossPoints.size();i+=2){
-			arc.setAngle1(baseAngle+crossPoints[i-1]);
-			arc.setAngle2(baseAngle+crossPoints[i]);
-            arc.drawVisible(painter,view,patternOffset);
-        }
-        return;
-    }
-    //a workaround for buggy equation solver, can be removed, when line-ellipse equation solver is reliable
-    if(isVisibleInWindow(view)){
-        arc.drawVisible(painter,view,patternOffset);
-    }
+bool RS_Ellipse::isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const {
+	if (!isEllipticArc()) {
+		return LC_Rect{v1, v2}.overlapsEllipse(data.center, data.majorP, data.ratio,
+											   0., 0., false);
+	}
+	return LC_Rect{v1, v2}.overlapsEllipse(data.center, data.majorP, data.ratio,
+										   data.angle1, data.angle2, data.reversed);
 }
 
-/** directly draw the arc, assuming the whole arc is within visible window */
-void RS_Ellipse::drawVisible(RS_Painter* painter, RS_GraphicView* view, double& /*patternOffset*/) {
-//    std::cout<<"RS_Ellipse::drawVisible(): begin\n";
-//    std::cout<<*this<<std::endl;
+void RS_Ellipse::draw(RS_Painter* painter, RS_GraphicView* view, double& /*patternOffset*/) {
 	if (!(painter && view)) return;
 
-    //visible in graphic view
-	if(!isVisibleInWindow(view)) return;
-    double ra(getMajorRadius()*view->getFactor().x);
+    RS_Vector const vpMin(view->toGraph(0,view->getHeight()));
+    RS_Vector const vpMax(view->toGraph(view->getWidth(),0));
+	if (!LC_Rect{vpMin, vpMax}.intersects(LC_Rect{minV, maxV})) return;
+
+    double const factor = view->getFactor().x;
+    double ra(getMajorRadius()*factor);
     double rb(getRatio()*ra);
 	if(std::min(ra, rb) < RS_TOLERANCE) {//ellipse too small
         painter->drawLine(view->toGui(minV),view->toGui(maxV));
         return;
     }
-    double mAngle=getAngle();
-    RS_Vector cp(view->toGui(getCenter()));
-	if (!isSelected() && (
-             getPen().getLineType()==RS2::SolidLine ||
-             view->getDrawingMode()==RS2::ModePreview)) {
-        painter->drawEllipse(cp,
-                             ra, rb,
-                             mAngle,
-                             getAngle1(), getAngle2(),
-                             isReversed());
-        return;
-    }
 
     // Pattern:
-	const RS_LineTypePattern* pat = isSelected() ?
-				&RS_LineTypePattern::patternSelected :
-				view->getPattern(getPen().getLineType());
+	const RS_LineTypePattern* pat = nullptr;
+	if (isSelected() || (getPen().getLineType()!=RS2::SolidLine &&
+						 view->getDrawingMode()!=RS2::ModePreview)) {
+		pat = isSelected() ?
+					&RS_LineTypePattern::patternSelected :
+					view->getPattern(getPen().getLineType());
+		if (!pat) {
+			RS_DEBUG->print(RS_Debug::D_WARNING, "Invalid pattern for Ellipse");
+			return;
+		}
+		if (pat->num <= 0) {
+			RS_DEBUG->print(RS_Debug::D_WARNING,"Invalid pattern when drawing ellipse");
+			pat = nullptr;
+		}
+	}
 
-	if (!pat) {
-        RS_DEBUG->print(RS_Debug::D_WARNING, "Invalid pattern for Ellipse");
-        return;
-    }
+	RS_PainterQt* painterQt = static_cast<RS_PainterQt*>(painter);
+	double const dpmm = pat ? painterQt->getDpmm() : 0.;
+	RS_Vector const cp(view->toGui(getCenter()));
+	QPointF const origin(cp.x, cp.y);
+	QRectF const viewport(0., 0., view->getWidth(), view->getHeight());
+
+	// parameter range, always drawn counter-clockwise
+	double a1 = 0.;
+	double a2 = 2.*M_PI;
+	if (isEllipticArc()) {
+		a1 = RS_Math::correctAngle(getAngle1());
+		a2 = RS_Math::correctAngle(getAngle2());
+		if (isReversed()) std::swap(a1,a2);
+		if (a2 < a1+RS_TOLERANCE_ANGLE) a2 += 2.*M_PI;
+	}
 
-    // Pen to draw pattern is always solid:
-    RS_Pen pen = painter->getPen();
-    pen.setLineType(RS2::SolidLine);
-    double a1(RS_Math::correctAngle(getAngle1()));
-    double a2(RS_Math::correctAngle(getAngle2()));
-    if (isReversed()) std::swap(a1,a2);
-	if(a2 <a1+RS_TOLERANCE_ANGLE) a2 += 2.*M_PI;
-    painter->setPen(pen);
-	if(pat->num <= 0){
-		RS_DEBUG->print(RS_Debug::D_WARNING,"Invalid pattern when drawing ellipse");
-		painter->drawEllipse(cp, ra, rb, mAngle, a1, a2, false);
+	if (pat) {
+		// Pen to draw pattern is always solid:
+		RS_Pen pen = painter->getPen();
+		pen.setLineType(RS2::SolidLine);
+		painter->setPen(pen);
+	}
+
+	if (!LC_CurveCache::isCacheable(ra)) {
+		// sample only the visible spans of huge ellipses, patterns restart
+		// at each span
+		curveCache.clear();
+		double const margin = painterQt->pen().widthF() + 1.;
+		LC_CurveCache visible;
+		visible.reset(LC_CurveCache::Key(), factor);
+		for (auto const& span: LC_CurveCache::visibleSpans(origin, ra, rb, getAngle(),
+				 a1, a2 - a1, viewport.adjusted(-margin, -margin, margin, margin))) {
+			if (pat) {
+				addPattern(visible, pat, dpmm, ra, rb, a1 + span.first, a1 + span.second);
+			} else {
+				visible.addEllipse(ra, rb, getAngle(), a1 + span.first,
+								   span.second - span.first);
+			}
+		}
+		visible.draw(painterQt, origin, factor, viewport);
 		return;
 	}
 
-	std::vector<double> ds(pat->num, 0.);
+	LC_CurveCache::Key key;
+	key.zoomBucket = LC_CurveCache::zoomBucket(factor);
+	key.pattern = pat;
+	key.dpmm = dpmm;
+	key.shape = {{data.majorP.x, data.majorP.y, data.ratio,
+				  data.angle1, data.angle2, data.reversed ? 1. : 0.}};
+	if (!curveCache.isValid(key)) {
+		curveCache.reset(key, factor);
+		if (pat) {
+			addPattern(curveCache, pat, dpmm, ra, rb, a1, a2);
+		} else {
+			curveCache.addEllipse(ra, rb, getAngle(), a1, a2 - a1);
+		}
+	}
+	curveCache.draw(painterQt, origin, factor, viewport);
+}
+
+/**
+ * adds the dashes of a line pattern to a curve cache
+ *
+ * @param ra major radius in pixels
+ * @param rb minor radius in pixels
+ * @param a1 ellipse parameter at the start
+ * @param a2 ellipse parameter at the end, greater than a1
+ */
+void RS_Ellipse::addPattern(LC_CurveCache& cache, const RS_LineTypePattern* pat,
+							double dpmm, double ra, double rb,
+							double a1, double a2) const {
+	double const mAngle=getAngle();
 
-	double dpmm=static_cast<RS_PainterQt*>(painter)->getDpmm();
+	std::vector<double> ds(pat->num, 0.);
 	for (size_t i = 0; i < pat->num; i++) {
 		ds[i]= dpmm * pat->pattern[i]; //pattern length
 		if(fabs(ds[i]) < 1.)
 			ds[i] = copysign(1., ds[i]);
 	}
 
-    double curA(a1);
-    bool notDone(true);
+	double curA(a1);
+	bool notDone(true);
 
 	//draw patterned ellipse
 	for (size_t i=0; notDone; i = (i + 1) % pat->num) {
 		double nextA = curA + std::abs(ds[i])/
 				RS_Vector(ra*sin(curA), rb*cos(curA)).magnitude();
-		if (nextA > a2){
+		// steps below the angle resolution finish the span
+		if (nextA >= a2 || nextA <= curA){
 			nextA = a2;
 			notDone = false;
-        }
+		}
 		if (ds[i] > 0.)
-			painter->drawEllipse(cp, ra, rb, mAngle, curA, nextA, false);
-
-        curA=nextA;
-    }
+			cache.addEllipse(ra, rb, mAngle, curA, nextA - curA);
 
+		curA=nextA;
+	}
 }
 
 
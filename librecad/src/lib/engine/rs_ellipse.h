@@ -30,6 +30,7 @@
 #define RS_ELLIPSE_H
 
 #include "rs_atomicentity.h"
+#include "lc_curvecache.h"
 
 class LC_Quadratic;
 
@@ -209,10 +210,13 @@ public:
     /** whether the entity's bounding box intersects with visible portion of graphic view
     */
 	bool isVisibleInWindow(RS_GraphicView* view) const override;
-	//! \{ \brief find visible segments of entity and draw only those visible portion
+	/** @return true, if the ellipse has a point in the window */
+	bool isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const;
+	/**
+	 * draws the ellipse from a screen approximation, which is kept while
+	 * the zoom bucket, the line pattern and the shape stay the same
+	 */
 	void draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset) override;
-	void drawVisible(RS_Painter* painter, RS_GraphicView* view, double& patternOffset);
-	//! \}
 
     friend std::ostream& operator << (std::ostream& os, const RS_Ellipse& a);
 
@@ -240,7 +244,13 @@ public:
 	double areaLineIntegral() const override;
 
 protected:
+	void addPattern(LC_CurveCache& cache, const RS_LineTypePattern* pat,
+					double dpmm, double ra, double rb,
+					double a1, double a2) const;
+
     RS_EllipseData data;
+	//! screen approximation used by draw()
+	mutable LC_CurveCache curveCache;
 };
 
 #endif
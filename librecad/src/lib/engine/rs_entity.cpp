@@ -26,6 +26,7 @@
 **********************************************************************/
 
 
+#include <atomic>
 #include <iostream>
 #include <utility>
 #include <QPolygon>
@@ -94,9 +95,11 @@ void RS_Entity::init() {
 
 /**
  * Gives this entity a new unique id.
+ * Entities are also created by worker threads, e.g. when inserts are
+ * updated in parallel after loading a file.
  */
 void RS_Entity::initId() {
-    static unsigned long int idCounter=0;
+    static std::atomic<unsigned long int> idCounter{0};
     id = idCounter++;
 }
 
@@ -139,6 +142,9 @@ bool RS_Entity::setSelected(bool select) {
     } else {
         delFlag(RS2::FlagSelected);
     }
+    if (parent) {
+        parent->updateSelection(this);
+    }
 
     return true;
 }
@@ -24,9 +24,11 @@
 **
 **********************************************************************/
 
+#include <array>
 #include <iostream>
 #include <cmath>
 #include <set>
+#include <unordered_set>
 #include <QObject>
 
 #include "rs_dialogfactory.h"
@@ -42,11 +44,21 @@
 #include "rs_insert.h"
 #include "rs_spline.h"
 #include "rs_solid.h"
+#include "rs_circle.h"
+#include "lc_splinepoints.h"
 #include "rs_information.h"
 #include "rs_graphicview.h"
+#include "lc_selectionset.h"
+#include "lc_spatialindex.h"
+#include "lc_endpointindex.h"
 
 bool RS_EntityContainer::autoUpdateBorders = true;
 
+namespace {
+//! documents with fewer entities are searched linearly
+constexpr int minIndexedCount = 256;
+}
+
 /**
  * Default constructor.
  *
@@ -66,14 +78,17 @@ RS_EntityContainer::RS_EntityContainer(RS_EntityContainer* parent,
 
 
 /**
- * Copy constructor. Makes a deep copy of all entities.
+ * Copy constructor. Makes a shallow copy of the entity list, the spatial
+ * index is not shared.
+ * @see detach()
  */
-/*
 RS_EntityContainer::RS_EntityContainer(const RS_EntityContainer& ec)
- : RS_Entity(ec) {
-
+    : RS_Entity(ec)
+    , entities(ec.entities)
+    , subContainer(ec.subContainer)
+    , entIdx(ec.entIdx)
+    , autoDelete(ec.autoDelete) {
 }
-*/
 
 
 
@@ -81,6 +96,7 @@ RS_EntityContainer::RS_EntityContainer(const RS_EntityContainer& ec)
  * Destructor.
  */
 RS_EntityContainer::~RS_EntityContainer() {
+    selection.reset();
     if (autoDelete) {
         while (!entities.isEmpty())
             delete entities.takeFirst();
@@ -135,6 +151,8 @@ void RS_EntityContainer::detach() {
         entities.append(e);
         e->reparent(this);
     }
+    invalidateSpatialIndex();
+    selection.reset();
 }
 
 
@@ -237,62 +255,95 @@ bool RS_EntityContainer::toggleSelected() {
 void RS_EntityContainer::selectWindow(RS_Vector v1, RS_Vector v2,
                                       bool select, bool cross) {
 
-    bool included;
-
-	for(auto e: entities){
-
-        included = false;
+    auto selectInWindow = [&](RS_Entity* e) {
+        bool included = false;
 
         if (e->isVisible()) {
             if (e->isInWindow(v1, v2)) {
                 //e->setSelected(select);
                 included = true;
 			} else if (cross) {
-				RS_EntityContainer l;
-				l.addRectangle(v1, v2);
-                RS_VectorSolutions sol;
-
-                if (e->isContainer()) {
-                    RS_EntityContainer* ec = (RS_EntityContainer*)e;
-                    for (RS_Entity* se=ec->firstEntity(RS2::ResolveAll);
-						 se && included==false;
-                         se=ec->nextEntity(RS2::ResolveAll)) {
-
-                        if (se->rtti() == RS2::EntitySolid){
-							included = static_cast<RS_Solid*>(se)->isInCrossWindow(v1,v2);
-                        } else {
-							for (auto line: l) {
-                                sol = RS_Information::getIntersection(
-											se, line, true);
-                                if (sol.hasValid()) {
-                                    included = true;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                } else if (e->rtti() == RS2::EntitySolid){
-					included = static_cast<RS_Solid*>(e)->isInCrossWindow(v1,v2);
-                } else {
-					for (auto line: l) {
-						sol = RS_Information::getIntersection(e, line, true);
-                        if (sol.hasValid()) {
-                            included = true;
-                            break;
-                        }
-                    }
-                }
+				included = isCrossingWindow(e, v1, v2);
             }
         }
 
         if (included) {
             e->setSelected(select);
         }
+    };
+
+    // only entities with extents overlapping the window can be selected
+    const LC_SpatialIndex* index = getSpatialIndex();
+    if (index) {
+        for (RS_Entity* e: index->query(LC_Rect{v1, v2}, false)) {
+            selectInWindow(e);
+        }
+        return;
+    }
+	for(auto e: entities){
+        selectInWindow(e);
     }
 }
 
 
 
+bool RS_EntityContainer::isCrossingWindow(RS_Entity* e, const RS_Vector& v1,
+										  const RS_Vector& v2) {
+	LC_Rect const window{v1, v2};
+	if (e->rtti() != RS2::EntityConstructionLine
+			&& !window.intersects(LC_Rect{e->getMin(), e->getMax()})) {
+		return false;
+	}
+
+	switch (e->rtti()) {
+	case RS2::EntityLine:
+		return static_cast<RS_Line*>(e)->isInCrossWindow(v1, v2);
+	case RS2::EntityArc:
+		return static_cast<RS_Arc*>(e)->isInCrossWindow(v1, v2);
+	case RS2::EntityCircle:
+		return static_cast<RS_Circle*>(e)->isInCrossWindow(v1, v2);
+	case RS2::EntityEllipse:
+		return static_cast<RS_Ellipse*>(e)->isInCrossWindow(v1, v2);
+	case RS2::EntitySplinePoints:
+		return static_cast<LC_SplinePoints*>(e)->isInCrossWindow(v1, v2);
+	case RS2::EntitySolid:
+		return static_cast<RS_Solid*>(e)->isInCrossWindow(v1, v2);
+	case RS2::EntitySpline:
+		return static_cast<RS_Spline*>(e)->isInCrossWindow(v1, v2);
+	case RS2::EntityInsert: {
+		RS_Insert* insert = static_cast<RS_Insert*>(e);
+		if (insert->getGlyph() || (insert->isInstanced() && insert->isEmpty())) {
+			return insert->isInCrossWindow(v1, v2);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+
+	// polylines, texts, dimensions, ...
+	if (e->isContainer()) {
+		for (RS_Entity* se: *static_cast<RS_EntityContainer*>(e)) {
+			if (isCrossingWindow(se, v1, v2)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// other entities: intersect with the borders of the window
+	std::array<RS_Vector, 4> const corners = window.vertices();
+	for (size_t i = 0; i < corners.size(); ++i) {
+		RS_Line const border{nullptr, corners[i], corners[(i + 1) % corners.size()]};
+		if (RS_Information::getIntersection(e, &border, true).hasValid()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
 /**
  * Adds a entity to this container and updates the borders of this
  * entity-container if autoUpdateBorders is true.
@@ -312,12 +363,19 @@ void RS_EntityContainer::addEntity(RS_Entity* entity) {
 
 	if (!entity) return;
 
-    if (entity->rtti()==RS2::EntityImage ||
-            entity->rtti()==RS2::EntityHatch) {
+    bool const prepend = entity->rtti()==RS2::EntityImage ||
+            entity->rtti()==RS2::EntityHatch;
+    if (prepend) {
         entities.prepend(entity);
     } else {
         entities.append(entity);
     }
+    if (spatialIndex) {
+        spatialIndex->insert(entity, prepend);
+    }
+    if (selection && entity->getFlag(RS2::FlagSelected)) {
+        selection->insert(entity);
+    }
     if (autoUpdateBorders) {
         adjustBorders(entity);
     }
@@ -332,6 +390,10 @@ void RS_EntityContainer::appendEntity(RS_Entity* entity){
 	if (!entity)
         return;
     entities.append(entity);
+    if (spatialIndex)
+        spatialIndex->insert(entity);
+    if (selection && entity->getFlag(RS2::FlagSelected))
+        selection->insert(entity);
     if (autoUpdateBorders)
         adjustBorders(entity);
 }
@@ -343,6 +405,10 @@ void RS_EntityContainer::appendEntity(RS_Entity* entity){
 void RS_EntityContainer::prependEntity(RS_Entity* entity){
 	if (!entity) return;
     entities.prepend(entity);
+    if (spatialIndex)
+        spatialIndex->insert(entity, true);
+    if (selection && entity->getFlag(RS2::FlagSelected))
+        selection->insert(entity);
     if (autoUpdateBorders)
         adjustBorders(entity);
 }
@@ -380,6 +446,8 @@ void RS_EntityContainer::moveEntity(int index, QList<RS_Entity *>& entList){
 	for(auto e: entList){
             entities.insert(ci++, e);
     }
+    // the drawing order has changed
+    invalidateSpatialIndex();
 }
 
 /**
@@ -391,6 +459,19 @@ void RS_EntityContainer::insertEntity(int index, RS_Entity* entity) {
 
     entities.insert(index, entity);
 
+    if (spatialIndex) {
+        if (index <= 0) {
+            spatialIndex->insert(entity, true);
+        } else if (index >= entities.size() - 1) {
+            spatialIndex->insert(entity);
+        } else {
+            invalidateSpatialIndex();
+        }
+    }
+    if (selection && entity->getFlag(RS2::FlagSelected)) {
+        selection->insert(entity);
+    }
+
     if (autoUpdateBorders) {
         adjustBorders(entity);
     }
@@ -430,6 +511,12 @@ bool RS_EntityContainer::removeEntity(RS_Entity* entity) {
     bool ret;
     ret = entities.removeOne(entity);
 
+    if (spatialIndex && ret) {
+        spatialIndex->remove(entity);
+    }
+    if (selection && ret) {
+        selection->remove(entity);
+    }
     if (autoDelete && ret) {
         delete entity;
     }
@@ -450,6 +537,8 @@ void RS_EntityContainer::clear() {
             delete entities.takeFirst();
     } else
         entities.clear();
+    invalidateSpatialIndex();
+    selection.reset();
     resetBorders();
 }
 
@@ -478,13 +567,13 @@ unsigned int RS_EntityContainer::countSelected(bool deep, std::initializer_list<
     unsigned int c=0;
 	std::set<RS2::EntityType> type = types;
 
-	for (RS_Entity* t: entities){
+	for (RS_Entity* t: getSelectedEntities()){
 
-		if (t->isSelected())
-			if (!types.size() || type.count(t->rtti()))
-				c++;
+		if (!types.size() || type.count(t->rtti()))
+			c++;
 
-		if (t->isContainer())
+		// sub-entities are selected along with their container
+		if (deep && t->isContainer())
 			c += static_cast<RS_EntityContainer*>(t)->countSelected(deep);
     }
 
@@ -496,12 +585,30 @@ unsigned int RS_EntityContainer::countSelected(bool deep, std::initializer_list<
  */
 double RS_EntityContainer::totalSelectedLength() {
     double ret(0.0);
-	for (RS_Entity* e: entities){
+	for (RS_Entity* e: getSelectedEntities()){
+        double l = e->getLength();
+        if (l>=0.) {
+            ret += l;
+        }
+    }
+    return ret;
+}
 
-        if (e->isVisible() && e->isSelected()) {
-            double l = e->getLength();
-            if (l>=0.) {
-                ret += l;
+
+std::vector<RS_Entity*> RS_EntityContainer::getSelectedEntities() const {
+    std::vector<RS_Entity*> ret;
+    if (const LC_SelectionSet* set = getSelectionSet()) {
+        ret.reserve(set->size());
+        // the set keeps the select flag, hidden entities are not selected
+        set->forEach([&ret](RS_Entity* e) {
+            if (e->isSelected()) {
+                ret.push_back(e);
+            }
+        });
+    } else {
+        for (RS_Entity* e: entities) {
+            if (e->isSelected()) {
+                ret.push_back(e);
             }
         }
     }
@@ -509,6 +616,77 @@ double RS_EntityContainer::totalSelectedLength() {
 }
 
 
+std::vector<RS_Entity*> RS_EntityContainer::getSelectedEntitiesInOrder() const {
+    std::vector<RS_Entity*> ret = getSelectedEntities();
+    if (getSelectionSet()) {
+        // the set orders by selection, window selections by the spatial index
+        sortInContainerOrder(ret);
+    }
+    return ret;
+}
+
+
+void RS_EntityContainer::sortInContainerOrder(std::vector<RS_Entity*>& list) const {
+    if (list.size() < 2) {
+        return;
+    }
+    std::vector<RS_Entity*> unsorted;
+    unsorted.swap(list);
+    std::unordered_set<RS_Entity*> wanted(unsorted.begin(), unsorted.end());
+    size_t const n = wanted.size();
+    for (RS_Entity* e: entities) {
+        if (wanted.erase(e)) {
+            list.push_back(e);
+            if (list.size() == n) {
+                return;
+            }
+        }
+    }
+    // entities of other containers keep their order at the end
+    for (RS_Entity* e: unsorted) {
+        if (wanted.erase(e)) {
+            list.push_back(e);
+        }
+    }
+}
+
+
+void RS_EntityContainer::updateSelection(RS_Entity* entity) {
+    if (!selection || !entity) {
+        return;
+    }
+    if (!entity->getFlag(RS2::FlagSelected)) {
+        selection->remove(entity);
+        return;
+    }
+    if (entity->getParent() != this || selection->contains(entity)) {
+        return;
+    }
+    // clones keep this container as parent before they are added,
+    // only entities of the list are kept
+    const LC_SpatialIndex* index = getSpatialIndex();
+    if (index ? index->contains(entity) : entities.contains(entity)) {
+        selection->insert(entity);
+    }
+}
+
+
+const LC_SelectionSet* RS_EntityContainer::getSelectionSet() const {
+    if (!isDocument()) {
+        return nullptr;
+    }
+    if (!selection) {
+        selection.reset(new LC_SelectionSet);
+        for (RS_Entity* e: entities) {
+            if (e->getFlag(RS2::FlagSelected)) {
+                selection->insert(e);
+            }
+        }
+    }
+    return selection.get();
+}
+
+
 /**
  * Adjusts the borders of this graphic (max/min values)
  */
@@ -518,8 +696,12 @@ void RS_EntityContainer::adjustBorders(RS_Entity* entity) {
 
 	if (entity) {
         // make sure a container is not empty (otherwise the border
-        //   would get extended to 0/0):
-        if (!entity->isContainer() || entity->count()>0) {
+        //   would get extended to 0/0), instanced inserts and splines
+        //   have no entities but their own borders:
+        if (!entity->isContainer() || entity->count()>0
+                || entity->rtti()==RS2::EntitySpline
+                || (entity->rtti()==RS2::EntityInsert
+                    && static_cast<RS_Insert*>(entity)->isInstanced())) {
             minV = RS_Vector::minimum(entity->getMin(),minV);
             maxV = RS_Vector::maximum(entity->getMax(),maxV);
         }
@@ -638,6 +820,7 @@ void RS_EntityContainer::forcedCalculateBorders() {
 void RS_EntityContainer::updateDimensions(bool autoText) {
 
     RS_DEBUG->print("RS_EntityContainer::updateDimensions()");
+    invalidateSpatialIndex();
 
     //for (RS_Entity* e=firstEntity(RS2::ResolveNone);
 	//        e;
@@ -665,6 +848,7 @@ void RS_EntityContainer::updateDimensions(bool autoText) {
 void RS_EntityContainer::updateInserts() {
 
     RS_DEBUG->print("RS_EntityContainer::updateInserts() ID/type: %d/%d", getId(), rtti());
+    invalidateSpatialIndex();
 
     for (RS_Entity* e: entities){
         //// Only update our own inserts and not inserts of inserts
@@ -720,6 +904,7 @@ void RS_EntityContainer::renameInserts(const QString& oldName,
 void RS_EntityContainer::updateSplines() {
 
     RS_DEBUG->print("RS_EntityContainer::updateSplines()");
+    invalidateSpatialIndex();
 
 	for (RS_Entity* e: entities){
         //// Only update our own inserts and not inserts of inserts
@@ -741,6 +926,7 @@ void RS_EntityContainer::update() {
 	for (RS_Entity* e: entities){
 		e->update();
     }
+    invalidateSpatialIndex();
 }
 
 void RS_EntityContainer::addRectangle(RS_Vector const& v0, RS_Vector const& v1)
@@ -1106,6 +1292,8 @@ void RS_EntityContainer::setEntityAt(int index,RS_Entity* en){
 		delete entities.at(index);
 	}
 	entities[index] = en;
+	invalidateSpatialIndex();
+	selection.reset();
 }
 
 /**
@@ -1136,22 +1324,27 @@ RS_Vector RS_EntityContainer::getNearestEndpoint(const RS_Vector& coord,
     double curDist;                 // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
+    long closestOrder = 0;          // container order of the closest entity
 
-	for (RS_Entity* en: entities){
+	visitNearest(coord, [&](RS_Entity* en, long order) {
 
 		if (en->isVisible()
                 && !en->getParent()->ignoredOnModification()
 				){//no end point for Insert, text, Dim
             point = en->getNearestEndpoint(coord, &curDist);
-            if (point.valid && curDist<minDist) {
+            // on equal distance, the first entity in the container wins
+            if (point.valid && (curDist<minDist
+                                || (curDist==minDist && closestPoint.valid && order<closestOrder))) {
                 closestPoint = point;
+                closestOrder = order;
                 minDist = curDist;
 				if (dist) {
                     *dist = minDist;
                 }
             }
         }
-    }
+        return minDist;
+    });
 
     return closestPoint;
 }
@@ -1169,19 +1362,15 @@ RS_Vector RS_EntityContainer::getNearestEndpoint(const RS_Vector& coord,
     double curDist;                 // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
+    long closestOrder = 0;          // container order of the closest entity
 
-    //QListIterator<RS_Entity> it = createIterator();
-    //RS_Entity* en;
-	//while ( (en = it.current())  ) {
-    //    ++it;
-
-    unsigned i0=0;
-	for(auto en: entities){
+	visitNearest(coord, [&](RS_Entity* en, long order) {
         if (!en->getParent()->ignoredOnModification() ){//no end point for Insert, text, Dim
-//            std::cout<<"find nearest for entity "<<i0<<std::endl;
             point = en->getNearestEndpoint(coord, &curDist);
-            if (point.valid && curDist<minDist) {
+            if (point.valid && (curDist<minDist
+                                || (curDist==minDist && closestPoint.valid && order<closestOrder))) {
                 closestPoint = point;
+                closestOrder = order;
                 minDist = curDist;
 				if (dist) {
                     *dist = minDist;
@@ -1191,8 +1380,8 @@ RS_Vector RS_EntityContainer::getNearestEndpoint(const RS_Vector& coord,
                 }
             }
         }
-        i0++;
-    }
+        return minDist;
+    });
 
 //    std::cout<<__FILE__<<" : "<<__func__<<" : line "<<__LINE__<<std::endl;
 //    std::cout<<"count()="<<const_cast<RS_EntityContainer*>(this)->count()<<"\tminDist= "<<minDist<<"\tclosestPoint="<<closestPoint;
@@ -1227,19 +1416,23 @@ RS_Vector RS_EntityContainer::getNearestCenter(const RS_Vector& coord,
     double curDist = RS_MAXDOUBLE;  // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
+    long closestOrder = 0;          // container order of the closest entity
 
-	for(auto en: entities){
+	visitNearest(coord, [&](RS_Entity* en, long order) {
 
         if (en->isVisible()
 				&& !en->getParent()->ignoredSnap()
 				){//no center point for spline, text, Dim
             point = en->getNearestCenter(coord, &curDist);
-            if (point.valid && curDist<minDist) {
+            if (point.valid && (curDist<minDist
+                                || (curDist==minDist && closestPoint.valid && order<closestOrder))) {
                 closestPoint = point;
+                closestOrder = order;
                 minDist = curDist;
             }
         }
-    }
+        return minDist;
+    });
 	if (dist) {
         *dist = minDist;
     }
@@ -1257,19 +1450,23 @@ RS_Vector RS_EntityContainer::getNearestMiddle(const RS_Vector& coord,
     double curDist = RS_MAXDOUBLE;  // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
+    long closestOrder = 0;          // container order of the closest entity
 
-	for(auto en: entities){
+	visitNearest(coord, [&](RS_Entity* en, long order) {
 
         if (en->isVisible()
 				&& !en->getParent()->ignoredSnap()
 				){//no midle point for spline, text, Dim
             point = en->getNearestMiddle(coord, &curDist, middlePoints);
-            if (point.valid && curDist<minDist) {
+            if (point.valid && (curDist<minDist
+                                || (curDist==minDist && closestPoint.valid && order<closestOrder))) {
                 closestPoint = point;
+                closestOrder = order;
                 minDist = curDist;
             }
         }
-    }
+        return minDist;
+    });
 	if (dist) {
         *dist = minDist;
     }
@@ -1313,14 +1510,27 @@ RS_Vector RS_EntityContainer::getNearestIntersection(const RS_Vector& coord,
 	closestEntity = getNearestEntity(coord, nullptr, RS2::ResolveAllButTextImage);
 
 	if (closestEntity) {
-        for (RS_Entity* en = firstEntity(RS2::ResolveAllButTextImage);
-             en;
-             en = nextEntity(RS2::ResolveAllButTextImage)) {
+        // intersections are on the closest entity, so only entities with
+        // extents overlapping its extents need an exact solve
+        LC_SpatialIndex::Item closestBox;
+        bool const bounded = LC_SpatialIndex::extents(closestEntity, closestBox);
+        auto const overlaps = [&](RS_Entity* en) {
+            LC_SpatialIndex::Item box;
+            if (!bounded || !LC_SpatialIndex::extents(en, box)) {
+                return true;
+            }
+            return box.minX <= closestBox.maxX + RS_TOLERANCE
+                    && closestBox.minX <= box.maxX + RS_TOLERANCE
+                    && box.minY <= closestBox.maxY + RS_TOLERANCE
+                    && closestBox.minY <= box.maxY + RS_TOLERANCE;
+        };
+        auto const test = [&](RS_Entity* en) {
             if (
                     !en->isVisible()
 					|| en->getParent()->ignoredSnap()
+                    || !overlaps(en)
                     ){
-                continue;
+                return;
             }
 
             sol = RS_Information::getIntersection(closestEntity,
@@ -1332,7 +1542,31 @@ RS_Vector RS_EntityContainer::getNearestIntersection(const RS_Vector& coord,
                 closestPoint=point;
                 minDist=curDist;
             }
-
+        };
+
+        const LC_SpatialIndex* index = bounded ? getSpatialIndex() : nullptr;
+        if (index) {
+            LC_Rect const area{{closestBox.minX, closestBox.minY},
+                               {closestBox.maxX, closestBox.maxY}};
+            for (RS_Entity* e: index->query(area.increaseBy(RS_TOLERANCE))) {
+                if (e->isContainer() && e->rtti()!=RS2::EntityText
+                        && e->rtti()!=RS2::EntityMText) {
+                    auto ec = static_cast<RS_EntityContainer*>(e);
+                    for (RS_Entity* en = ec->firstEntity(RS2::ResolveAllButTextImage);
+                         en;
+                         en = ec->nextEntity(RS2::ResolveAllButTextImage)) {
+                        test(en);
+                    }
+                } else {
+                    test(e);
+                }
+            }
+        } else {
+            for (RS_Entity* en = firstEntity(RS2::ResolveAllButTextImage);
+                 en;
+                 en = nextEntity(RS2::ResolveAllButTextImage)) {
+                test(en);
+            }
         }
     }
 	if(dist && closestPoint.valid) {
@@ -1351,20 +1585,24 @@ RS_Vector RS_EntityContainer::getNearestRef(const RS_Vector& coord,
     double curDist;                 // currently measured distance
     RS_Vector closestPoint(false);  // closest found endpoint
     RS_Vector point;                // endpoint found
+    long closestOrder = 0;          // container order of the closest entity
 
-	for(auto en: entities){
+	visitNearest(coord, [&](RS_Entity* en, long order) {
 
         if (en->isVisible()) {
             point = en->getNearestRef(coord, &curDist);
-            if (point.valid && curDist<minDist) {
+            if (point.valid && (curDist<minDist
+                                || (curDist==minDist && closestPoint.valid && order<closestOrder))) {
                 closestPoint = point;
+                closestOrder = order;
                 minDist = curDist;
 				if (dist) {
                     *dist = minDist;
                 }
             }
         }
-    }
+        return minDist;
+    });
 
     return closestPoint;
 }
@@ -1408,14 +1646,16 @@ double RS_EntityContainer::getDistanceToPoint(const RS_Vector& coord,
     double curDist;                     // currently measured distance
 	RS_Entity* closestEntity = nullptr;    // closest entity found
 	RS_Entity* subEntity = nullptr;
+    bool found = false;
+    long closestOrder = 0;              // container order of the closest entity
 
-	for(auto e: entities){
+	visitNearest(coord, [&](RS_Entity* e, long order) {
 
         if (e->isVisible()) {
             RS_DEBUG->print("entity: getDistanceToPoint");
             RS_DEBUG->print("entity: %d", e->rtti());
             // bug#426, need to ignore Images to find nearest intersections
-            if(level==RS2::ResolveAllButTextImage && e->rtti()==RS2::EntityImage) continue;
+            if(level==RS2::ResolveAllButTextImage && e->rtti()==RS2::EntityImage) return minDist;
             curDist = e->getDistanceToPoint(coord, &subEntity, level, solidDist);
 
             RS_DEBUG->print("entity: getDistanceToPoint: OK");
@@ -1429,7 +1669,7 @@ double RS_EntityContainer::getDistanceToPoint(const RS_Vector& coord,
 			 * tend to want to reference entities that they see or have recently drawn as opposed
 			 * to deeper more forgotten and invisible ones...
 			 */
-			if (curDist<=minDist)
+			if (curDist<minDist || (curDist==minDist && (!found || order>closestOrder)))
 			{
                 switch(level){
                 case RS2::ResolveAll:
@@ -1440,9 +1680,12 @@ double RS_EntityContainer::getDistanceToPoint(const RS_Vector& coord,
                     closestEntity = e;
                 }
                 minDist = curDist;
+                closestOrder = order;
+                found = true;
             }
         }
-    }
+        return minDist;
+    });
 
 	if (entity) {
         *entity = closestEntity;
@@ -1489,13 +1732,16 @@ RS_Entity* RS_EntityContainer::getNearestEntity(const RS_Vector& coord,
  * Rearranges the atomic entities in this container in a way that connected
  * entities are stored in the right order and direction.
  * Non-recoursive. Only affects atomic entities in this container.
+ * Connected endpoints are looked up in an LC_EndpointIndex.
  *
+ * @param messages If given, gap messages are appended to it instead of
+ * being shown, for calls from worker threads.
  * @retval true all contours were closed
  * @retval false at least one contour is not closed
 
  * to do: find closed contour by flood-fill
  */
-bool RS_EntityContainer::optimizeContours() {
+bool RS_EntityContainer::optimizeContours(QStringList* messages) {
 //    std::cout<<"RS_EntityContainer::optimizeContours: begin"<<std::endl;
 
 //    DEBUG_HEADER
@@ -1507,10 +1753,10 @@ bool RS_EntityContainer::optimizeContours() {
     bool closed=true;
 
     /** accept all full circles **/
-    QList<RS_Entity*> enList;
+    std::unordered_set<RS_Entity*> enList;
 	for(auto e1: entities){
         if (!e1->isEdge() || e1->isContainer() ) {
-            enList<<e1;
+            enList.insert(e1);
             continue;
         }
 
@@ -1523,7 +1769,7 @@ bool RS_EntityContainer::optimizeContours() {
         case RS2::EntityCircle:
             //directly detect circles, bug#3443277
             tmp.addEntity(e1->clone());
-            enList<<e1;
+            enList.insert(e1);
             // fall-through
         default:
             continue;
@@ -1532,86 +1778,111 @@ bool RS_EntityContainer::optimizeContours() {
     }
     //    std::cout<<"RS_EntityContainer::optimizeContours: 1"<<std::endl;
 
-    /** remove unsupported entities */
-    for(RS_Entity* it: enList)
-        removeEntity(it);
+    /** index the endpoints of the remaining edges **/
+    std::vector<RS_Entity*> edges;
+    std::unordered_set<RS_Entity*> used;
+    LC_EndpointIndex index(1e-8);
+    for(auto e1: entities){
+        if (!enList.count(e1)) {
+            edges.push_back(e1);
+            index.insert(e1);
+        }
+    }
+    // the first edge in container order, which is not in a contour yet
+    size_t firstUnused=0;
+    auto takeFirst = [&]() -> RS_Entity* {
+        while (used.count(edges[firstUnused])) ++firstUnused;
+        RS_Entity* e2=edges[firstUnused];
+        used.insert(e2);
+        index.remove(e2);
+        return e2;
+    };
 
     /** check and form a closed contour **/
-//    std::cout<<"RS_EntityContainer::optimizeContours: 2"<<std::endl;
     /** the first entity **/
 	RS_Entity* current(nullptr);
-    if(count()>0) {
-        current=entityAt(0)->clone();
+    if(edges.size()>0) {
+        current=takeFirst()->clone();
         tmp.addEntity(current);
-        removeEntity(entityAt(0));
     }else {
-        if(tmp.count()==0) return false;
+        if(tmp.count()==0) {
+            clear();
+            return false;
+        }
     }
-//    std::cout<<"RS_EntityContainer::optimizeContours: 3"<<std::endl;
     RS_Vector vpStart;
     RS_Vector vpEnd;
 	if(current){
         vpStart=current->getStartpoint();
         vpEnd=current->getEndpoint();
     }
-	RS_Entity* next(nullptr);
-//    std::cout<<"RS_EntityContainer::optimizeContours: 4"<<std::endl;
     /** connect entities **/
     const QString errMsg=QObject::tr("Hatch failed due to a gap=%1 between (%2, %3) and (%4, %5)");
 
-    while(count()>0) {
-        double dist(0.);
-        RS_Vector&& vpTmp=getNearestEndpoint(vpEnd,&dist,&next);
-        if(dist>1e-8) {
+    while(!index.isEmpty()) {
+        LC_EndpointIndex::Endpoint next;
+        if(!index.findNearest(vpEnd, next)) {
             if(vpEnd.squaredTo(vpStart) < 1e-8) {
-                RS_Entity* e2=entityAt(0);
+                RS_Entity* e2=takeFirst();
                 tmp.addEntity(e2->clone());
                 vpStart=e2->getStartpoint();
                 vpEnd=e2->getEndpoint();
-                removeEntity(e2);
                 continue;
             }
             else {
-                QG_DIALOGFACTORY->commandMessage(
-                            errMsg.arg(dist).arg(vpTmp.x).arg(vpTmp.y).arg(vpEnd.x).arg(vpEnd.y)
-                            );
+                // report the gap to the nearest remaining endpoint
+                double dist(RS_MAXDOUBLE);
+                RS_Vector vpTmp;
+                for(RS_Entity* e2: edges){
+                    if (used.count(e2)) continue;
+                    for(const RS_Vector& vp: {e2->getStartpoint(), e2->getEndpoint()}){
+                        if (vp.distanceTo(vpEnd) < dist) {
+                            dist=vp.distanceTo(vpEnd);
+                            vpTmp=vp;
+                        }
+                    }
+                }
+                QString const msg = errMsg.arg(dist).arg(vpTmp.x).arg(vpTmp.y).arg(vpEnd.x).arg(vpEnd.y);
+                if (messages) {
+                    messages->append(msg);
+                } else {
+                    QG_DIALOGFACTORY->commandMessage(msg);
+                }
                 RS_DEBUG->print(RS_Debug::D_ERROR, "RS_EntityContainer::optimizeContours: hatch failed due to a gap");
                 closed=false;
                 break;
             }
         }
-        if(!next) { 	    //workaround if next is nullptr
-//      	    std::cout<<"RS_EntityContainer::optimizeContours: next is nullptr" <<std::endl;
-            RS_DEBUG->print("RS_EntityContainer::optimizeContours: next is nullptr");
-//			closed=false;	//workaround if next is nullptr
-            break;			//workaround if next is nullptr
-        } 					//workaround if next is nullptr
-        if(closed) {
-            next->setProcessed(true);
-            RS_Entity* eTmp = next->clone();
-            if(vpEnd.squaredTo(eTmp->getStartpoint())>vpEnd.squaredTo(eTmp->getEndpoint()))
-                eTmp->revertDirection();
-            vpEnd=eTmp->getEndpoint();
-            tmp.addEntity(eTmp);
-        	removeEntity(next);
+        used.insert(next.entity);
+        index.remove(next.entity);
+        RS_Entity* eTmp = next.entity->clone();
+        if(vpEnd.squaredTo(eTmp->getStartpoint())>vpEnd.squaredTo(eTmp->getEndpoint()))
+            eTmp->revertDirection();
+        vpEnd=eTmp->getEndpoint();
+        tmp.addEntity(eTmp);
+    }
+
+    /** remove connected and unsupported entities, keep the unconnected rest **/
+    QList<RS_Entity*> rest;
+    for(auto e1: entities){
+        if (!enList.count(e1) && !used.count(e1)) {
+            rest<<e1;
+        } else if (autoDelete) {
+            delete e1;
         }
     }
-//    DEBUG_HEADER
-//    if(vpEnd.valid && vpEnd.squaredTo(vpStart) > 1e-8) {
-//		QG_DIALOGFACTORY->commandMessage(errMsg.arg(vpEnd.distanceTo(vpStart))
-//											 .arg(vpStart.x).arg(vpStart.y).arg(vpEnd.x).arg(vpEnd.y));
-//        RS_DEBUG->print("RS_EntityContainer::optimizeContours: hatch failed due to a gap");
-//        closed=false;
-//    }
-//    std::cout<<"RS_EntityContainer::optimizeContours: 5"<<std::endl;
-
+    entities=rest;
+    invalidateSpatialIndex();
+    selection.reset();
+    if (autoUpdateBorders) {
+        calculateBorders();
+    }
 
     // add new sorted entities:
 	for(auto en: tmp){
 		en->setProcessed(false);
         addEntity(en->clone());
     }
-//    std::cout<<"RS_EntityContainer::optimizeContours: 6"<<std::endl;
 
     if(closed) {
         RS_DEBUG->print("RS_EntityContainer::optimizeContours: OK");
@@ -1644,6 +1915,9 @@ void RS_EntityContainer::move(const RS_Vector& offset) {
             e->moveBorders(offset);
         }
     }
+    if (spatialIndex) {
+        spatialIndex->move(offset);
+    }
     if (autoUpdateBorders) {
         moveBorders(offset);
     }
@@ -1657,6 +1931,7 @@ void RS_EntityContainer::rotate(const RS_Vector& center, const double& angle) {
 	for(auto e: entities){
         e->rotate(center, angleVector);
     }
+    invalidateSpatialIndex();
     if (autoUpdateBorders) {
         calculateBorders();
     }
@@ -1668,6 +1943,7 @@ void RS_EntityContainer::rotate(const RS_Vector& center, const RS_Vector& angleV
 	for(auto e: entities){
         e->rotate(center, angleVector);
     }
+    invalidateSpatialIndex();
     if (autoUpdateBorders) {
         calculateBorders();
     }
@@ -1680,6 +1956,7 @@ void RS_EntityContainer::scale(const RS_Vector& center, const RS_Vector& factor)
 		for(auto e: entities){
             e->scale(center, factor);
         }
+        invalidateSpatialIndex();
     }
     if (autoUpdateBorders) {
         calculateBorders();
@@ -1694,6 +1971,7 @@ void RS_EntityContainer::mirror(const RS_Vector& axisPoint1, const RS_Vector& ax
 		for(auto e: entities){
             e->mirror(axisPoint1, axisPoint2);
         }
+        invalidateSpatialIndex();
     }
 }
 
@@ -1711,6 +1989,7 @@ void RS_EntityContainer::stretch(const RS_Vector& firstCorner,
 		for(auto e: entities){
             e->stretch(firstCorner, secondCorner, offset);
         }
+        invalidateSpatialIndex();
     }
 
     // some entitiycontainers might need an update (e.g. RS_Leader):
@@ -1726,6 +2005,7 @@ void RS_EntityContainer::moveRef(const RS_Vector& ref,
 	for(auto e: entities){
         e->moveRef(ref, offset);
     }
+    invalidateSpatialIndex();
     if (autoUpdateBorders) {
         calculateBorders();
     }
@@ -1739,6 +2019,7 @@ void RS_EntityContainer::moveSelectedRef(const RS_Vector& ref,
 	for(auto e: entities){
         e->moveSelectedRef(ref, offset);
     }
+    invalidateSpatialIndex();
     if (autoUpdateBorders) {
         calculateBorders();
     }
@@ -1752,6 +2033,7 @@ void RS_EntityContainer::revertDirection() {
 	for(RS_Entity*const entity: entities) {
 		entity->revertDirection();
 	}
+	invalidateSpatialIndex();
 }
 
 /**
@@ -1936,3 +2218,40 @@ const QList<RS_Entity*>& RS_EntityContainer::getEntityList()
 {
     return entities;
 }
+
+const LC_SpatialIndex* RS_EntityContainer::getSpatialIndex() const
+{
+    if (!isDocument() || entities.size() < minIndexedCount) {
+        return nullptr;
+    }
+    if (!spatialIndex) {
+        spatialIndex.reset(new LC_SpatialIndex);
+        spatialIndex->build(entities.begin(), entities.end());
+    }
+    return spatialIndex.get();
+}
+
+void RS_EntityContainer::updateSpatialIndex(RS_Entity* entity)
+{
+    if (spatialIndex && entity && entity->getParent() == this) {
+        spatialIndex->update(entity);
+    }
+}
+
+void RS_EntityContainer::invalidateSpatialIndex()
+{
+    spatialIndex.reset();
+}
+
+void RS_EntityContainer::visitNearest(const RS_Vector& coord,
+                                      const std::function<double(RS_Entity*, long)>& visitor) const
+{
+    if (const LC_SpatialIndex* index = getSpatialIndex()) {
+        index->visitNearest(coord, visitor);
+        return;
+    }
+    long order = 0;
+    for (RS_Entity* e: entities) {
+        visitor(e, order++);
+    }
+}
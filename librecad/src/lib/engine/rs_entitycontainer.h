@@ -28,9 +28,15 @@
 #ifndef RS_ENTITYCONTAINER_H
 #define RS_ENTITYCONTAINER_H
 
+#include <functional>
+#include <memory>
 #include <vector>
+#include <QStringList>
 #include "rs_entity.h"
 
+class LC_SelectionSet;
+class LC_SpatialIndex;
+
 /**
  * Class representing a tree of entities.
  * Typical entity containers are graphics, polylines, groups, texts, ...)
@@ -43,7 +49,7 @@ class RS_EntityContainer : public RS_Entity {
 public:
 
 	RS_EntityContainer(RS_EntityContainer* parent=nullptr, bool owner=true);
-    //RS_EntityContainer(const RS_EntityContainer& ec);
+	RS_EntityContainer(const RS_EntityContainer& ec);
 	~RS_EntityContainer() override;
 
 	RS_Entity* clone() const override;
@@ -81,6 +87,12 @@ public:
 
 	virtual void selectWindow(RS_Vector v1, RS_Vector v2,
 				bool select=true, bool cross=false);
+	/**
+	 * @return true, if the entity or one of its sub-entities crosses the
+	 * border of the window, used for crossing selections
+	 */
+	static bool isCrossingWindow(RS_Entity* e, const RS_Vector& v1,
+								 const RS_Vector& v2);
 
     virtual void addEntity(RS_Entity* entity);
     virtual void appendEntity(RS_Entity* entity);
@@ -121,6 +133,30 @@ public:
 	*/
 	virtual unsigned countSelected(bool deep=true, std::initializer_list<RS2::EntityType> const& types = {});
     virtual double totalSelectedLength();
+	/**
+	 * @brief getSelectedEntities selected entities of this container without
+	 * resolving into sub-containers. Documents keep a selection set and
+	 * return them in the order they were selected, other containers in
+	 * container order.
+	 */
+	std::vector<RS_Entity*> getSelectedEntities() const;
+	/**
+	 * @brief getSelectedEntitiesInOrder selected entities of this container
+	 * in container order. Used where new entities are created from the
+	 * selection, so clones keep the draw order of their originals.
+	 */
+	std::vector<RS_Entity*> getSelectedEntitiesInOrder() const;
+	/**
+	 * @brief sortInContainerOrder sorts entities of this container by their
+	 * position. Scans the list until all of them are found, so callers
+	 * only use it when new entities are made from them.
+	 */
+	void sortInContainerOrder(std::vector<RS_Entity*>& list) const;
+	/**
+	 * @brief updateSelection keeps the selection set in sync, called when the
+	 * select flag of an entity of this container changes
+	 */
+	void updateSelection(RS_Entity* entity);
 
     /**
      * Enables / disables automatic update of borders on entity removals
@@ -131,7 +167,7 @@ public:
     }
     virtual void adjustBorders(RS_Entity* entity);
 	void calculateBorders() override;
-	void forcedCalculateBorders();
+	virtual void forcedCalculateBorders();
 	void updateDimensions( bool autoText=true);
     virtual void updateInserts();
     virtual void updateSplines();
@@ -174,7 +210,7 @@ public:
                                       RS2::ResolveLevel level=RS2::ResolveNone,
 									  double solidDist = RS_MAXDOUBLE) const override;
 
-    virtual bool optimizeContours();
+    virtual bool optimizeContours(QStringList* messages = nullptr);
 
 	bool hasEndpointsWithinWindow(const RS_Vector& v1, const RS_Vector& v2) override;
 
@@ -229,6 +265,24 @@ public:
 
     const QList<RS_Entity*>& getEntityList();
 
+	/**
+	 * @brief getSpatialIndex R-tree of the entities in this container.
+	 * Documents with many entities build the index on demand, it is kept up
+	 * to date on additions and removals afterwards.
+	 * @return nullptr, if the container is not indexed
+	 */
+	const LC_SpatialIndex* getSpatialIndex() const;
+	/**
+	 * @brief updateSpatialIndex re-reads the extents of an entity which was
+	 * modified in place after it had been added
+	 */
+	void updateSpatialIndex(RS_Entity* entity);
+	/**
+	 * @brief invalidateSpatialIndex discards the spatial index, the next
+	 * query rebuilds it
+	 */
+	void invalidateSpatialIndex();
+
 protected:
 
     /** entities in the container */
@@ -243,7 +297,27 @@ protected:
      */
     static bool autoUpdateBorders;
 
+	/** spatial index, nullptr until the first query */
+	mutable std::unique_ptr<LC_SpatialIndex> spatialIndex;
+	/** selected entities of a document, nullptr until the first query */
+	mutable std::unique_ptr<LC_SelectionSet> selection;
+
 private:
+	/**
+	 * @brief getSelectionSet builds the selection set of a document from the
+	 * select flags on demand
+	 * @return nullptr, if this container is not a document
+	 */
+	const LC_SelectionSet* getSelectionSet() const;
+	/**
+	 * @brief visitNearest calls visitor for all entities which may be nearest
+	 * to coord, the visitor returns the minimum distance found so far
+	 * Entities are visited by the spatial index if available, otherwise in
+	 * container order. The order passed to the visitor follows the container
+	 * order in both cases, so ties can be resolved like a linear scan.
+	 */
+	void visitNearest(const RS_Vector& coord,
+					  const std::function<double(RS_Entity*, long)>& visitor) const;
 	/**
 	 * @brief ignoredSnap whether snapping is ignored
 	 * @return true when entity of this container won't be considered for snapping points
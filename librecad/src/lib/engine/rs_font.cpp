@@ -31,6 +31,7 @@
 #include <QTextCodec>
 
 #include "rs_font.h"
+#include "lc_glyph.h"
 #include "rs_arc.h"
 #include "rs_line.h"
 #include "rs_polyline.h"
@@ -54,6 +55,8 @@ RS_Font::RS_Font(const QString& fileName, bool owner)
     rawLffFontList.clear();
 }
 
+RS_Font::~RS_Font() = default;
+
 
 
 /**
@@ -447,11 +450,25 @@ RS_Block* RS_Font::generateLffFont(const QString& ch){
 }
 
 RS_Block* RS_Font::findLetter(const QString& name) {
+    std::lock_guard<std::recursive_mutex> lock(lettersMutex);
     RS_Block* ret= letterList.find(name);
 	if (ret) return ret;
     return generateLffFont(name);
 
 }
+
+const LC_Glyph* RS_Font::findGlyph(const QString& name) {
+    std::lock_guard<std::recursive_mutex> lock(lettersMutex);
+    auto it = glyphs.find(name);
+    if (it != glyphs.end()) return it->second.get();
+
+    RS_Block* letter = findLetter(name);
+    if (!letter) return nullptr;
+    LC_Glyph* glyph = new LC_Glyph(letter);
+    glyphs[name].reset(glyph);
+    return glyph;
+}
+
 /**
  * Dumps the fonts data to stdout.
  */
@@ -29,10 +29,15 @@
 #define RS_FONT_H
 
 #include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <QStringList>
 #include <QMap>
 #include "rs_blocklist.h"
 
+class LC_Glyph;
+
 /**
  * Class for representing a font. This is implemented as a RS_Graphic
  * with a name (the font name) and several blocks, one for each letter
@@ -43,6 +48,7 @@
 class RS_Font {
 public:
     RS_Font(const QString& name, bool owner=true);
+    ~RS_Font();
     //RS_Font(const char* name);
 
     /** @return the fileName of this font. */
@@ -102,6 +108,11 @@ public:
 //    RS_Block* findLetter(const QString& name) {
 //		return letterList.find(name);
 //	}
+    /**
+     * @return The tessellated letter shared by all texts using this font
+     *   or nullptr if the letter does not exist.
+     */
+    const LC_Glyph* findGlyph(const QString& name);
     unsigned countLetters() {
         return letterList.count();
     }
@@ -125,6 +136,12 @@ private:
         //! block list (letters)
         RS_BlockList letterList;
 
+    //! tessellated letters, created on first use
+    std::map<QString, std::unique_ptr<LC_Glyph>> glyphs;
+    //! guards the letters and glyphs created on first use, texts are
+    //! also updated by worker threads
+    std::recursive_mutex lettersMutex;
+
     //! Font file name
     QString fileName;
 	
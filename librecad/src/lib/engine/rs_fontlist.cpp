@@ -107,15 +107,18 @@ RS_Font* RS_FontList::requestFont(const QString& name) {
     RS_DEBUG->print("name2: %s", name2.toLatin1().data());
 
 	// Search our list of available fonts:
-	for( auto const& f: fonts){
-
-        if (f->getFileName()==name2) {
-            // Make sure this font is loaded into memory:
-            f->loadFont();
-			foundFont = f.get();
-            break;
-        }
-    }
+	{
+		std::lock_guard<std::mutex> lock(loadMutex);
+		for( auto const& f: fonts){
+
+			if (f->getFileName()==name2) {
+				// Make sure this font is loaded into memory:
+				f->loadFont();
+				foundFont = f.get();
+				break;
+			}
+		}
+	}
 
 	if (!foundFont && name!="standard") {
         foundFont = requestFont("standard");
@@ -26,6 +26,7 @@
 #ifndef RS_FONTLIST_H
 #define RS_FONTLIST_H
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class RS_Font;
@@ -65,6 +66,8 @@ private:
 	static RS_FontList* uniqueInstance;
     //! fonts in the graphic
 	std::vector<std::unique_ptr<RS_Font>> fonts;
+	//! fonts are loaded on request, also from worker threads
+	std::mutex loadMutex;
 };
 
 #endif
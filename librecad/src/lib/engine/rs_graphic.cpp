@@ -24,8 +24,12 @@
 **
 **********************************************************************/
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <functional>
+#include <unordered_map>
+#include <vector>
 #include <QDir>
 //#include <QDebug>
 
@@ -39,6 +43,50 @@
 #include "rs_settings.h"
 #include "rs_layer.h"
 #include "rs_block.h"
+#include "rs_insert.h"
+#include "lc_parallel.h"
+
+namespace {
+/** collects the inserts RS_EntityContainer::updateInserts() updates */
+void collectInserts(RS_EntityContainer* container, std::vector<RS_Insert*>& inserts) {
+	container->invalidateSpatialIndex();
+	for (RS_Entity* e: *container) {
+		if (e->rtti() == RS2::EntityInsert) {
+			inserts.push_back(static_cast<RS_Insert*>(e));
+		} else if (e->isContainer() && e->rtti() != RS2::EntityHatch) {
+			collectInserts(static_cast<RS_EntityContainer*>(e), inserts);
+		}
+	}
+}
+
+/** points an entity and its subentities to the copies of their layers */
+void replaceLayers(RS_Entity* e, const QHash<RS_Layer*, RS_Layer*>& layers) {
+	e->setLayer(layers.value(e->getLayer(false)));
+	if (e->isContainer()) {
+		for (RS_Entity* child: *static_cast<RS_EntityContainer*>(e)) {
+			replaceLayers(child, layers);
+		}
+	}
+}
+
+/** copies an entity for RS_Graphic::createSnapshot() */
+RS_Entity* snapshotOf(RS_Entity* e, RS_EntityContainer* parent,
+					  const QHash<RS_Layer*, RS_Layer*>& layers) {
+	RS_Entity* c;
+	if (e->rtti() == RS2::EntityInsert) {
+		// only the insert data is saved, skip cloning the block entities
+		RS_InsertData data = static_cast<RS_Insert*>(e)->getData();
+		data.updateMode = RS2::NoUpdate;
+		c = new RS_Insert(parent, data);
+		c->setPen(e->getPen(false));
+	} else {
+		c = e->clone();
+		c->reparent(parent);
+	}
+	replaceLayers(c, layers);
+	return c;
+}
+}
 
 
 /**
@@ -161,6 +209,19 @@ void RS_Graphic::removeLayer(RS_Layer* layer) {
 			e->setLayer("0");
 		}
 
+		// undone entities are kept out of the entity lists:
+		std::vector<RS_Entity*> undone = getUndoneEntities();
+		for(RS_Block* blk: blockList){
+			if(!blk) continue;
+			std::vector<RS_Entity*> const u = blk->getUndoneEntities();
+			undone.insert(undone.end(), u.begin(), u.end());
+		}
+		for(auto e: undone){
+			if (e->getLayer(false) == layer) {
+				e->setLayer("0");
+			}
+		}
+
         layerList.remove(layer);
     }
 }
@@ -933,6 +994,127 @@ void RS_Graphic::addEntity(RS_Entity* entity)
 }
 
 
+void RS_Graphic::updateInsertsParallel() {
+	RS_DEBUG->print("RS_Graphic::updateInsertsParallel");
+	std::vector<RS_Insert*> inserts;
+	collectInserts(this, inserts);
+
+	// level of a block: one more than the highest level of the blocks it
+	// inserts, 0 for none, -1 while it is visited
+	std::unordered_map<RS_Block*, int> levels;
+	std::vector<std::vector<RS_Block*>> blocksOfLevel;
+	bool cyclic = false;
+	std::function<int(RS_Block*)> levelOf = [&](RS_Block* block) {
+		auto it = levels.find(block);
+		if (it != levels.end()) {
+			cyclic = cyclic || it->second < 0;
+			return it->second;
+		}
+		levels[block] = -1;
+		int level = 0;
+		for (RS_Entity* e: *block) {
+			if (e->rtti() != RS2::EntityInsert) continue;
+			RS_Block* inserted = static_cast<RS_Insert*>(e)->getBlockForInsert();
+			if (inserted) {
+				level = std::max(level, levelOf(inserted) + 1);
+			}
+		}
+		levels[block] = level;
+		if (blocksOfLevel.size() <= (size_t) level) {
+			blocksOfLevel.resize(level + 1);
+		}
+		blocksOfLevel[level].push_back(block);
+		return level;
+	};
+	for (RS_Insert* insert: inserts) {
+		RS_Block* block = insert->getBlockForInsert();
+		if (block) {
+			levelOf(block);
+		}
+	}
+	if (cyclic) {
+		// updateInserts() does not terminate either, keep its behavior
+		RS_DEBUG->print(RS_Debug::D_WARNING,
+						"RS_Graphic::updateInsertsParallel: recursive blocks");
+		updateInserts();
+		return;
+	}
+
+	// blocks of one level only read the blocks of lower levels, instanced
+	// inserts also read the borders of their block
+	for (const auto& blocks: blocksOfLevel) {
+		std::vector<RS_Insert*> blockInserts;
+		for (RS_Block* block: blocks) {
+			block->invalidateSpatialIndex();
+			for (RS_Entity* e: *block) {
+				if (e->rtti() == RS2::EntityInsert) {
+					blockInserts.push_back(static_cast<RS_Insert*>(e));
+				}
+			}
+		}
+		LC_Parallel::forEach(blockInserts.size(), [&](size_t i) {
+			blockInserts[i]->updateFromUpdatedBlock();
+		});
+		LC_Parallel::forEach(blocks.size(), [&](size_t i) {
+			blocks[i]->calculateBorders();
+		});
+	}
+
+	LC_Parallel::forEach(inserts.size(), [&](size_t i) {
+		inserts[i]->updateFromUpdatedBlock();
+	});
+	RS_DEBUG->print("RS_Graphic::updateInsertsParallel: OK");
+}
+
+
+RS_Graphic* RS_Graphic::createSnapshot() {
+	RS_DEBUG->print("RS_Graphic::createSnapshot");
+	RS_Graphic* snapshot = new RS_Graphic();
+	snapshot->getVariableDict() = getVariableDict();
+	snapshot->crosshairType = crosshairType;
+	snapshot->paperScaleFixed = paperScaleFixed;
+	snapshot->filename = filename;
+	snapshot->autosaveFilename = autosaveFilename;
+	snapshot->formatType = formatType;
+
+	QHash<RS_Layer*, RS_Layer*> layers;
+	for (unsigned i = 0; i < layerList.count(); i++) {
+		RS_Layer* l = layerList.at(i);
+		RS_Layer* c = l->clone();
+		layers.insert(l, c);
+		snapshot->addLayer(c);
+	}
+	if (getActiveLayer()) {
+		snapshot->activateLayer(layers.value(getActiveLayer()));
+	}
+
+	for (int i = 0; i < blockList.count(); i++) {
+		RS_Block* blk = blockList.at(i);
+		if (blk->isUndone()) continue;
+		RS_Block* b = new RS_Block(snapshot, RS_BlockData(blk->getName(),
+									blk->getBasePoint(), blk->isFrozen()));
+		for (RS_Entity* e: *blk) {
+			if (!e->isUndone()) {
+				b->addEntity(snapshotOf(e, b, layers));
+			}
+		}
+		snapshot->addBlock(b, false);
+	}
+
+	for (RS_Entity* e: *this) {
+		if (!e->isUndone()) {
+			snapshot->RS_EntityContainer::addEntity(snapshotOf(e, snapshot, layers));
+		}
+	}
+	// the inserts of the copy have no borders
+	snapshot->minV = minV;
+	snapshot->maxV = maxV;
+	snapshot->setModified(true);
+	RS_DEBUG->print("RS_Graphic::createSnapshot: OK");
+	return snapshot;
+}
+
+
 /**
  * Dumps the entities to stdout.
  */
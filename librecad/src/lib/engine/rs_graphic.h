@@ -69,6 +69,13 @@ public:
 
     virtual void newDoc();
     virtual bool save(bool isAutoSave = false);
+    /**
+     * Copies layers, blocks, variables and entities to a new graphic,
+     * which can be saved by another thread while this one is edited.
+     * Inserts are copied without the entities generated from their block
+     * and the copy has no graphic view. The caller owns the copy.
+     */
+    RS_Graphic* createSnapshot();
     virtual bool saveAs(const QString& filename, RS2::FormatType type, bool force = false);
     virtual bool open(const QString& filename, RS2::FormatType type);
     bool loadTemplate(const QString &filename, RS2::FormatType type);
@@ -96,9 +103,17 @@ public:
         layerList.add(layer);
     }
     virtual void addEntity(RS_Entity* entity);
+    /**
+     * Same result as updateInserts(), but the inserts of the used blocks
+     * are updated once, bottom up, instead of for every insert using
+     * them. Inserts are updated by worker threads, see LC_Parallel.
+     */
+    void updateInsertsParallel();
     virtual void removeLayer(RS_Layer* layer);
     virtual void editLayer(RS_Layer* layer, const RS_Layer& source) {
         layerList.edit(layer, source);
+        // the construction flag changes the extents of lines
+        invalidateSpatialIndex();
     }
     RS_Layer* findLayer(const QString& name) {
         return layerList.find(name);
@@ -286,6 +301,14 @@ public:
         layerList.setModified(m);
         blockList.setModified(m);
     }
+    /**
+     * Overwritten to include changes of the layers, which hide or
+     * lock entities.
+     */
+    unsigned long getModificationCount() const override {
+        return RS_Document::getModificationCount() + layerList.getModificationCount();
+    }
+
     virtual QDateTime getModifyTime(void){
         return modifiedTime;
     }
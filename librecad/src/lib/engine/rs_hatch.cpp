@@ -23,13 +23,17 @@
 ** This copyright notice MUST APPEAR in all copies of the script!
 **
 **********************************************************************/
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <functional>
 #include <memory>
+#include <vector>
 #include <QPainterPath>
 #include <QBrush>
 #include <QString>
 #include "rs_hatch.h"
+#include "lc_contourregion.h"
 
 #include "rs_arc.h"
 #include "rs_circle.h"
@@ -64,6 +68,244 @@ std::ostream& operator << (std::ostream& os, const RS_HatchData& td) {
 	return os;
 }
 
+namespace {
+
+/**
+ * @brief The HatchClipper class clips families of parallel pattern lines to
+ * the hatch boundary.
+ *
+ * Every family is processed in a single sweep: the boundary is split into
+ * pieces monotone across the pattern lines, and each pattern line is only
+ * intersected with the pieces it actually crosses. The inside parts of the
+ * pattern lines follow from even-odd parity of the sorted crossings, so
+ * neither temporary entities nor point-in-contour tests are needed.
+ */
+class HatchClipper {
+public:
+	/**
+	 * @brief setBoundary reads the boundary loops of a hatch
+	 * @return false, if the boundary contains entities other than lines,
+	 * arcs, circles or ellipses
+	 */
+	bool setBoundary(const RS_EntityContainer& loops);
+
+	/**
+	 * @brief clip a family of parallel pattern lines
+	 * @param direction unit direction of all lines
+	 * @param lines start and end points of the lines
+	 * @param emit called for every part inside the boundary
+	 */
+	void clip(const RS_Vector& direction,
+			  const std::vector<std::pair<RS_Vector, RS_Vector>>& lines,
+			  const std::function<void(const RS_Vector&, const RS_Vector&)>& emit) const;
+
+private:
+	/**
+	 * a boundary edge, either the straight line from center to center + u,
+	 * or the curve center + u*cos(t) + v*sin(t) for t0 <= t <= t1
+	 */
+	struct Edge {
+		bool straight;
+		RS_Vector center;
+		RS_Vector u;
+		RS_Vector v;
+		double t0;
+		double t1;
+	};
+
+	/**
+	 * part of an edge, along which the distance c to the pattern lines is
+	 * monotone. The piece is crossed by lines with cLow <= c < cHigh, so a
+	 * vertex shared by two pieces is counted once.
+	 */
+	struct Piece {
+		const Edge* edge;
+		double t0;
+		double t1;
+		double cLow;
+		double cHigh;
+	};
+
+	std::vector<Edge> edges;
+};
+
+bool HatchClipper::setBoundary(const RS_EntityContainer& loops)
+{
+	edges.clear();
+	for (auto l: loops) {
+		if (!l->isContainer())
+			continue;
+		for (auto e: *static_cast<RS_EntityContainer*>(l)) {
+			switch (e->rtti()) {
+			case RS2::EntityLine:
+				edges.push_back({true, e->getStartpoint(),
+								 e->getEndpoint() - e->getStartpoint(), {}, 0., 1.});
+				break;
+			case RS2::EntityArc: {
+				auto arc = static_cast<RS_Arc*>(e);
+				double const r = arc->getRadius();
+				double t0 = arc->isReversed() ? arc->getAngle2() : arc->getAngle1();
+				double t1 = arc->isReversed() ? arc->getAngle1() : arc->getAngle2();
+				t1 = t0 + RS_Math::correctAngle(t1 - t0);
+				if (t1 - t0 < RS_TOLERANCE_ANGLE)
+					t1 += 2.*M_PI;
+				edges.push_back({false, arc->getCenter(), {r, 0.}, {0., r}, t0, t1});
+				break;
+			}
+			case RS2::EntityCircle: {
+				auto circle = static_cast<RS_Circle*>(e);
+				double const r = circle->getRadius();
+				edges.push_back({false, circle->getCenter(), {r, 0.}, {0., r}, 0., 2.*M_PI});
+				break;
+			}
+			case RS2::EntityEllipse: {
+				auto ellipse = static_cast<RS_Ellipse*>(e);
+				RS_Vector const u = ellipse->getMajorP();
+				RS_Vector const v = RS_Vector{-u.y, u.x}*ellipse->getRatio();
+				double t0 = 0.;
+				double t1 = 2.*M_PI;
+				if (ellipse->isEllipticArc()) {
+					t0 = ellipse->isReversed() ? ellipse->getAngle2() : ellipse->getAngle1();
+					t1 = ellipse->isReversed() ? ellipse->getAngle1() : ellipse->getAngle2();
+					t1 = t0 + RS_Math::correctAngle(t1 - t0);
+					if (t1 - t0 < RS_TOLERANCE_ANGLE)
+						t1 += 2.*M_PI;
+				}
+				edges.push_back({false, ellipse->getCenter(), u, v, t0, t1});
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void HatchClipper::clip(const RS_Vector& direction,
+						const std::vector<std::pair<RS_Vector, RS_Vector>>& lines,
+						const std::function<void(const RS_Vector&, const RS_Vector&)>& emit) const
+{
+	// coordinates: s along the lines, c across the lines
+	RS_Vector const& d = direction;
+	RS_Vector const n{-d.y, d.x};
+
+	// split the boundary into pieces monotone in c
+	std::vector<Piece> pieces;
+	for (const Edge& e: edges) {
+		double const c0 = n.dotP(e.center);
+		if (e.straight) {
+			double const c1 = c0 + n.dotP(e.u);
+			if (c0 != c1)
+				pieces.push_back({&e, 0., 1., std::min(c0, c1), std::max(c0, c1)});
+			continue;
+		}
+		// c(t) = c0 + r*cos(t - psi), with extremes at t = psi + k*M_PI
+		double const nu = n.dotP(e.u);
+		double const nv = n.dotP(e.v);
+		double const r = hypot(nu, nv);
+		if (r < RS_TOLERANCE)
+			continue;
+		double const psi = atan2(nv, nu);
+		double t = e.t0;
+		for (double k = ceil((e.t0 - psi)/M_PI); t < e.t1; k += 1.) {
+			double const t1 = std::min(e.t1, psi + k*M_PI);
+			if (t1 - t > RS_TOLERANCE_ANGLE) {
+				double const ca = c0 + r*cos(t - psi);
+				double const cb = c0 + r*cos(t1 - psi);
+				if (ca != cb)
+					pieces.push_back({&e, t, t1, std::min(ca, cb), std::max(ca, cb)});
+			}
+			t = std::max(t, t1);
+		}
+	}
+	std::sort(pieces.begin(), pieces.end(), [](const Piece& a, const Piece& b) {
+		return a.cLow < b.cLow;
+	});
+
+	// s of the crossing of a piece with the line at c
+	auto const crossing = [&n, &d](const Piece& p, double c) {
+		const Edge& e = *p.edge;
+		if (e.straight) {
+			double const c0 = n.dotP(e.center);
+			double const t = (c - c0)/n.dotP(e.u);
+			return d.dotP(e.center + e.u*t);
+		}
+		double const nu = n.dotP(e.u);
+		double const nv = n.dotP(e.v);
+		double const psi = atan2(nv, nu);
+		double const w = (c - n.dotP(e.center))/hypot(nu, nv);
+		double const a = acos(std::max(-1., std::min(1., w)));
+		// of the two solutions, take the one within the piece
+		double best = p.t0;
+		double bestError = RS_MAXDOUBLE;
+		for (double t: {psi + a, psi - a}) {
+			double const mid = 0.5*(p.t0 + p.t1);
+			t = mid + remainder(t - mid, 2.*M_PI);
+			double const error = std::max(p.t0 - t, t - p.t1);
+			if (error < bestError) {
+				best = t;
+				bestError = error;
+			}
+		}
+		return d.dotP(e.center + e.u*cos(best) + e.v*sin(best));
+	};
+
+	// the lines in order of c
+	struct Line {
+		double c;
+		double s0;
+		double s1;
+	};
+	std::vector<Line> sorted;
+	sorted.reserve(lines.size());
+	for (const auto& l: lines) {
+		double const s0 = d.dotP(l.first);
+		double const s1 = d.dotP(l.second);
+		sorted.push_back({0.5*(n.dotP(l.first) + n.dotP(l.second)),
+						  std::min(s0, s1), std::max(s0, s1)});
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const Line& a, const Line& b) {
+		return a.c < b.c;
+	});
+
+	std::vector<const Piece*> active;
+	std::vector<double> crossings;
+	size_t next = 0;
+	double lastC = RS_MAXDOUBLE;
+	for (const Line& l: sorted) {
+		double const c = l.c;
+		if (fabs(c - lastC) > RS_TOLERANCE) {
+			// sweep to c and collect the crossings
+			lastC = c;
+			while (next < pieces.size() && pieces[next].cLow <= c) {
+				active.push_back(&pieces[next++]);
+			}
+			active.erase(std::remove_if(active.begin(), active.end(),
+										[c](const Piece* p) {
+				return p->cHigh <= c;
+			}), active.end());
+			crossings.clear();
+			for (const Piece* p: active) {
+				crossings.push_back(crossing(*p, c));
+			}
+			std::sort(crossings.begin(), crossings.end());
+		}
+
+		// inside between crossings 2k and 2k+1
+		bool const dot = l.s1 - l.s0 <= RS_TOLERANCE;
+		for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+			double const lo = std::max(l.s0, crossings[k]);
+			double const hi = std::min(l.s1, crossings[k + 1]);
+			if (dot ? lo <= hi : hi - lo > RS_TOLERANCE) {
+				emit(d*lo + n*c, d*hi + n*c);
+			}
+		}
+	}
+}
+
+}
+
 /**
  * Constructor.
  */
@@ -82,8 +324,10 @@ RS_Hatch::RS_Hatch(RS_EntityContainer* parent,
 
 /**
  * Validates the hatch.
+ *
+ * @param messages see RS_EntityContainer::optimizeContours()
  */
-bool RS_Hatch::validate() {
+bool RS_Hatch::validate(QStringList* messages) {
         bool ret = true;
 
     // loops:
@@ -92,7 +336,7 @@ bool RS_Hatch::validate() {
         if (l->rtti()==RS2::EntityContainer) {
             RS_EntityContainer* loop = (RS_EntityContainer*)l;
 
-            ret = loop->optimizeContours() && ret;
+            ret = loop->optimizeContours(messages) && ret;
         }
     }
 
@@ -154,9 +398,16 @@ void RS_Hatch::calculateBorders() {
  * Refill hatch with pattern. Move, scale, rotate, trim, etc.
  */
 void RS_Hatch::update() {
+    update(nullptr);
+}
+
+
+
+void RS_Hatch::update(QStringList* messages) {
 
     RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update");
 
+    contourRegion.reset();
     updateError = HATCH_OK;
     if (updateRunning) {
         RS_DEBUG->print(RS_Debug::D_NOTICE, "RS_Hatch::update: skip hatch in updating process");
@@ -193,7 +444,7 @@ void RS_Hatch::update() {
         return;
     }
 
-    if (!validate()) {
+    if (!validate(messages)) {
         RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: invalid contour in hatch found");
         updateRunning = false;
         updateError = HATCH_INVALID_CONTOUR;
@@ -256,11 +507,22 @@ void RS_Hatch::update() {
         updateError = HATCH_TOO_SMALL;
         return;
     }
+
+    // pattern lines are clipped by a sweep, only other pattern entities
+    // need a temporary carpet of copies
+    HatchClipper clipper;
+    bool const sweep = clipper.setBoundary(*this);
+    bool const carpet = !sweep
+            || std::any_of(pat->begin(), pat->end(), [](RS_Entity* e) {
+        return e->rtti() != RS2::EntityLine;
+    });
+
     // avoid huge memory consumption:
-    else if ( cSize.x* cSize.y/(pSize.x*pSize.y)>1e4) {
+    if ( cSize.x* cSize.y/(pSize.x*pSize.y) > (carpet ? 1e4 : 1e5)) {
         RS_DEBUG->print(RS_Debug::D_ERROR, "RS_Hatch::update: contour size too large or pattern size too small");
         delete pat;
         delete copy;
+        updateRunning = false;
         updateError = HATCH_AREA_TOO_BIG;
         return;
     }
@@ -279,13 +541,44 @@ void RS_Hatch::update() {
     pat->rotate(rot_center, data.angle);
     pat->move(-rot_center);
 
+    // add the hatch pattern entities
+    hatch = new RS_EntityContainer(this);
+    hatch->setPen(hatch_pen);
+    hatch->setLayer(hatch_layer);
+    hatch->setFlag(RS2::FlagTemp);
+
     RS_EntityContainer tmp;   // container for untrimmed lines
 
     // adding array of patterns to tmp:
     RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Hatch::update: creating pattern carpet");
-    for (int px=px1; px<px2; px++) {
-		for (int py=py1; py<py2; py++) {
-			for(auto e: *pat){
+    std::vector<std::pair<RS_Vector, RS_Vector>> family;
+    for(auto e: *pat){
+        if (sweep && e->rtti() == RS2::EntityLine) {
+            // all copies of a pattern line are parallel
+            RS_Vector const start = e->getStartpoint();
+            RS_Vector const end = e->getEndpoint();
+            RS_Vector direction = end - start;
+            double const length = direction.magnitude();
+            direction = length > RS_TOLERANCE ? direction/length : RS_Vector{1., 0.};
+
+            family.clear();
+            for (int px=px1; px<px2; px++) {
+                for (int py=py1; py<py2; py++) {
+                    RS_Vector const offset = dvx*px + dvy*py;
+                    family.emplace_back(start + offset, end + offset);
+                }
+            }
+            clipper.clip(direction, family,
+                         [this, &hatch_pen, hatch_layer](const RS_Vector& v1, const RS_Vector& v2) {
+                RS_Line* te = new RS_Line{hatch, v1, v2};
+                te->setPen(hatch_pen);
+                te->setLayer(hatch_layer);
+                hatch->addEntity(te);
+            });
+            continue;
+        }
+        for (int px=px1; px<px2; px++) {
+            for (int py=py1; py<py2; py++) {
                 RS_Entity* te=e->clone();
                 te->move(dvx*px + dvy*py);
                 tmp.addEntity(te);
@@ -473,46 +766,37 @@ void RS_Hatch::update() {
 
     //RS_EntityContainer* rubbish = new RS_EntityContainer(getGraphic());
 
-    // add the hatch pattern entities
-    hatch = new RS_EntityContainer(this);
-    hatch->setPen(hatch_pen);
-    hatch->setLayer(hatch_layer);
-    hatch->setFlag(RS2::FlagTemp);
-
     //calculateBorders();
+    // classify two middle points of every piece against the boundary at once
+    std::vector<RS_Entity*> candidates;
+    std::vector<RS_Vector> middlePoints;
 	for(auto e: tmp2){
 
-        RS_Vector middlePoint;
-        RS_Vector middlePoint2;
         if (e->rtti()==RS2::EntityLine) {
 			RS_Line* line = static_cast<RS_Line*>(e);
-            middlePoint = line->getMiddlePoint();
-            middlePoint2 = line->getNearestDist(line->getLength()/2.1,
-                                                line->getStartpoint());
+            middlePoints.push_back(line->getMiddlePoint());
+            middlePoints.push_back(line->getNearestDist(line->getLength()/2.1,
+                                                        line->getStartpoint()));
         } else if (e->rtti()==RS2::EntityArc) {
 			RS_Arc* arc = static_cast<RS_Arc*>(e);
-            middlePoint = arc->getMiddlePoint();
-            middlePoint2 = arc->getNearestDist(arc->getLength()/2.1,
-                                               arc->getStartpoint());
+            middlePoints.push_back(arc->getMiddlePoint());
+            middlePoints.push_back(arc->getNearestDist(arc->getLength()/2.1,
+                                                       arc->getStartpoint()));
         } else {
-			middlePoint = RS_Vector{false};
-			middlePoint2 = RS_Vector{false};
+            continue;
         }
+        candidates.push_back(e);
+    }
 
-        if (middlePoint.valid) {
-            bool onContour=false;
-
-            if (RS_Information::isPointInsideContour(
-                        middlePoint,
-                        this, &onContour) ||
-                    RS_Information::isPointInsideContour(middlePoint2, this)) {
-
-                RS_Entity* te = e->clone();
-                te->setPen(hatch_pen);
-                te->setLayer(hatch_layer);
-                te->reparent(hatch);
-                hatch->addEntity(te);
-            }
+    LC_ContourRegion const region(this);
+    std::vector<char> const inside = region.isInside(middlePoints);
+    for (size_t i=0; i<candidates.size(); ++i) {
+        if (inside[2*i] || inside[2*i+1]) {
+            RS_Entity* te = candidates[i]->clone();
+            te->setPen(hatch_pen);
+            te->setLayer(hatch_layer);
+            te->reparent(hatch);
+            hatch->addEntity(te);
         }
     }
 
@@ -745,10 +1029,11 @@ double RS_Hatch::getDistanceToPoint(
             *entity = const_cast<RS_Hatch*>(this);
         }
 
-        bool onContour;
-        if (RS_Information::isPointInsideContour(
-                    coord,
-                     const_cast<RS_Hatch*>(this), &onContour)) {
+        if (!contourRegion) {
+            contourRegion = std::make_shared<LC_ContourRegion>(
+                        const_cast<RS_Hatch*>(this));
+        }
+        if (contourRegion->isInside(coord)) {
 
             // distance is the snap range:
             return solidDist;
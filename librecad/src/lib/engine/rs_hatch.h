@@ -28,9 +28,13 @@
 #ifndef RS_HATCH_H
 #define RS_HATCH_H
 
+#include <memory>
+
 #include "rs_entity.h"
 #include "rs_entitycontainer.h"
 
+class LC_ContourRegion;
+
 /**
  * Holds the data that defines a hatch entity.
  */
@@ -99,7 +103,7 @@ public:
         return data;
     }
 
-        bool validate();
+        bool validate(QStringList* messages = nullptr);
 
 		int countLoops() const;
 
@@ -135,6 +139,12 @@ public:
 
 		void calculateBorders() override;
 		void update() override;
+		/**
+		 * Updates the hatch like update(), but appends the gap messages of
+		 * its loops to messages instead of showing them. Used for updates
+		 * on worker threads.
+		 */
+		void update(QStringList* messages);
         int getUpdateError() {
                 return updateError;
         }
@@ -170,6 +180,8 @@ protected:
         bool updateRunning;
         bool needOptimization;
         int  updateError;
+        //! boundary of a solid hatch for getDistanceToPoint(), reset by update()
+        mutable std::shared_ptr<LC_ContourRegion> contourRegion;
 };
 
 #endif
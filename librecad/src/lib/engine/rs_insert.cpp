@@ -24,10 +24,15 @@
 **
 **********************************************************************/
 
+#include<algorithm>
+#include<atomic>
 #include<iostream>
 #include<cmath>
+#include<memory>
 #include "rs_insert.h"
 
+#include "lc_glyph.h"
+#include "lc_rect.h"
 #include "rs_arc.h"
 #include "rs_circle.h"
 #include "rs_ellipse.h"
@@ -36,6 +41,8 @@
 #include "rs_layer.h"
 #include "rs_math.h"
 #include "rs_debug.h"
+#include "rs_graphicview.h"
+#include "rs_painter.h"
 
 RS_InsertData::RS_InsertData(const QString& _name,
 							 RS_Vector _insertionPoint,
@@ -61,6 +68,76 @@ std::ostream& operator << (std::ostream& os,
 	   os << "(" << d.name.toLatin1().data() << ")";
 	   return os;
    }
+
+namespace {
+//! entities held by the draw and pick caches of all inserts
+std::atomic<size_t> cachedInstances{0};
+//! inserts beyond this clone the visible block entities on every draw
+size_t const instanceBudget = 250000;
+//! picked entities kept per insert
+size_t const maxPicked = 8;
+
+/** @return true, if a traversal at level visits the entities of e */
+bool resolvesInto(const RS_Entity* e, RS2::ResolveLevel level) {
+	if (!e->isContainer()) {
+		return false;
+	}
+	switch (level) {
+	case RS2::ResolveNone:
+		return false;
+	case RS2::ResolveAllButInserts:
+		return e->rtti()!=RS2::EntityInsert;
+	case RS2::ResolveAllButTexts:
+	case RS2::ResolveAllButTextImage:
+		return e->rtti()!=RS2::EntityText && e->rtti()!=RS2::EntityMText;
+	default:
+		return true;
+	}
+}
+
+/** @return the distance of p to the box, 0 inside */
+double distanceToBox(const LC_Rect& box, const RS_Vector& p) {
+	double const dx = std::max({box.minP().x - p.x, 0., p.x - box.maxP().x});
+	double const dy = std::max({box.minP().y - p.y, 0., p.y - box.maxP().y});
+	return std::hypot(dx, dy);
+}
+}
+
+void RS_Insert::InstanceCache::clear() {
+	clearDrawn();
+	cachedInstances -= picked.size();
+	picked.clear();
+	cursor = -1;
+	cursorEntity.reset();
+	cursorContainer = nullptr;
+}
+
+void RS_Insert::InstanceCache::clearDrawn() {
+	cachedInstances -= drawn.size();
+	drawn.clear();
+}
+
+RS_Entity* RS_Insert::InstanceCache::findPicked(int k) const {
+	for (auto const& p: picked) {
+		if (p.first == k) {
+			return p.second.get();
+		}
+	}
+	return nullptr;
+}
+
+void RS_Insert::InstanceCache::addPicked(int k, std::unique_ptr<RS_Entity> entity) {
+	if (picked.size() >= maxPicked) {
+		if (cursorContainer == picked.front().second.get()) {
+			cursorContainer = nullptr;
+		}
+		picked.erase(picked.begin());
+		--cachedInstances;
+	}
+	picked.emplace_back(k, std::move(entity));
+	++cachedInstances;
+}
+
 /**
  * @param parent The graphic this block belongs to.
  */
@@ -69,6 +146,8 @@ RS_Insert::RS_Insert(RS_EntityContainer* parent,
         : RS_EntityContainer(parent), data(d) {
 
 		block = nullptr;
+		glyph = nullptr;
+		instanced = false;
 
     if (data.updateMode!=RS2::NoUpdate) {
         update();
@@ -91,6 +170,16 @@ RS_Entity* RS_Insert::clone() const{
  * needs to be called whenever the block this insert is based on changes.
  */
 void RS_Insert::update() {
+    regenerate(true);
+}
+
+
+void RS_Insert::updateFromUpdatedBlock() {
+    regenerate(false);
+}
+
+
+void RS_Insert::regenerate(bool updateBlockInserts) {
 
         RS_DEBUG->print("RS_Insert::update");
         RS_DEBUG->print("RS_Insert::update: name: %s", data.name.toLatin1().data());
@@ -102,6 +191,14 @@ void RS_Insert::update() {
         }
 
     clear();
+    instanced = false;
+    instanceCache.clear();
+
+    if (glyph) {
+        // letters of texts share the glyph, nothing to clone:
+        calculateBorders();
+        return;
+    }
 
     RS_Block* blk = getBlockForInsert();
 	if (!blk) {
@@ -120,133 +217,694 @@ void RS_Insert::update() {
                 return;
         }
 
-    RS_Pen tmpPen;
-
-        /*QListIterator<RS_Entity> it = createIterator();
-    RS_Entity* e;
-	while ( (e = it.current())  ) {
-        ++it;*/
+        if (data.updateMode!=RS2::PreviewUpdate &&
+            fabs(fabs(data.scaleFactor.x)-fabs(data.scaleFactor.y))<1.0e-6) {
+                // uniform scale: draw and snap the entities of the block,
+                // the insert only keeps its borders
+                if (updateBlockInserts) {
+                        for (auto e: *blk) {
+                                if (e->rtti()==RS2::EntityInsert)
+                                        static_cast<RS_Insert*>(e)->update();
+                        }
+                        blk->calculateBorders();
+                }
+                instanced = true;
+                calculateInstanceBorders(blk);
+                RS_DEBUG->print("RS_Insert::update: OK (instanced)");
+                return;
+        }
 
         RS_DEBUG->print("RS_Insert::update: cols: %d, rows: %d",
                 data.cols, data.rows);
         RS_DEBUG->print("RS_Insert::update: block has %d entities",
                 blk->count());
-//int i_en_counts=0;
 		for(auto e: *blk){
         for (int c=0; c<data.cols; ++c) {
-//            RS_DEBUG->print("RS_Insert::update: col %d", c);
             for (int r=0; r<data.rows; ++r) {
-//                i_en_counts++;
-//                RS_DEBUG->print("RS_Insert::update: row %d", r);
 
-                if (e->rtti()==RS2::EntityInsert &&
+                if (updateBlockInserts && e->rtti()==RS2::EntityInsert &&
                     data.updateMode!=RS2::PreviewUpdate) {
-
-//                                        RS_DEBUG->print("RS_Insert::update: updating sub-insert");
 					static_cast<RS_Insert*>(e)->update();
                 }
 
-//                                RS_DEBUG->print("RS_Insert::update: cloning entity");
-
-                RS_Entity* ne;
-                if ( (data.scaleFactor.x - data.scaleFactor.y)>1.0e-6) {
-                    if (e->rtti()== RS2::EntityArc) {
-						RS_Arc* a= static_cast<RS_Arc*>(e);
-						ne = new RS_Ellipse{this,
-						{a->getCenter(), {a->getRadius(), 0.},
-								1, a->getAngle1(), a->getAngle2(),
-								a->isReversed()}
-					};
-                        ne->setLayer(e->getLayer());
-                        ne->setPen(e->getPen(false));
-                    } else if (e->rtti()== RS2::EntityCircle) {
-						RS_Circle* a= static_cast<RS_Circle*>(e);
-						ne = new RS_Ellipse{this,
-						{ a->getCenter(), {a->getRadius(), 0.}, 1, 0., 2.*M_PI, false}
-					};
-                        ne->setLayer(e->getLayer());
-                        ne->setPen(e->getPen(false));
-                    } else
-                        ne = e->clone();
-                } else
-                    ne = e->clone();
-                ne->initId();
-                ne->setUpdateEnabled(false);
-                // if entity layer are 0 set to insert layer to allow "1 layer control" bug ID #3602152
-                RS_Layer *l= ne->getLayer();//special fontchar block don't have
-				if (l  && ne->getLayer()->getName() == "0")
-                    ne->setLayer(this->getLayer());
-                ne->setParent(this);
-                ne->setVisible(getFlag(RS2::FlagVisible));
-
-//                                RS_DEBUG->print("RS_Insert::update: transforming entity");
-
-                // Move:
-//                                RS_DEBUG->print("RS_Insert::update: move 1");
-                if (fabs(data.scaleFactor.x)>1.0e-6 &&
-                        fabs(data.scaleFactor.y)>1.0e-6) {
-                    ne->move(data.insertionPoint +
-                             RS_Vector(data.spacing.x/data.scaleFactor.x*c,
-                                       data.spacing.y/data.scaleFactor.y*r));
-                }
-                else {
-                    ne->move(data.insertionPoint);
-                }
-                // Move because of block base point:
-//                                RS_DEBUG->print("RS_Insert::update: move 2");
-                ne->move(blk->getBasePoint()*-1);
-                // Scale:
-//                                RS_DEBUG->print("RS_Insert::update: scale");
-                ne->scale(data.insertionPoint, data.scaleFactor);
-                // Rotate:
-//                                RS_DEBUG->print("RS_Insert::update: rotate");
-                ne->rotate(data.insertionPoint, data.angle);
-                // Select:
-                ne->setSelected(isSelected());
-
-                // individual entities can be on indiv. layers
-                tmpPen = ne->getPen(false);
-
-                // color from block (free floating):
-                if (tmpPen.getColor()==RS_Color(RS2::FlagByBlock)) {
-                    tmpPen.setColor(getPen().getColor());
-                }
+                appendEntity(instanceOf(blk, e, c, r, updateBlockInserts));
+            }
+        }
+    }
+    calculateBorders();
 
-                // line width from block (free floating):
-                if (tmpPen.getWidth()==RS2::WidthByBlock) {
-                    tmpPen.setWidth(getPen().getWidth());
-                }
+        RS_DEBUG->print("RS_Insert::update: OK");
+}
 
-                // line type from block (free floating):
-                if (tmpPen.getLineType()==RS2::LineByBlock) {
-                    tmpPen.setLineType(getPen().getLineType());
-                }
 
-                // now that we've evaluated all flags, let's strip them:
-                // TODO: strip all flags (width, line type)
-                //tmpPen.setColor(tmpPen.getColor().stripFlags());
+/**
+ * Clones one entity of the block and transforms it into a cell of this
+ * insert. The clone is not added to the insert.
+ */
+RS_Entity* RS_Insert::instanceOf(RS_Block* blk, RS_Entity* e, int col, int row,
+								 bool updateBlockInserts) const {
+    RS_Insert* parent = const_cast<RS_Insert*>(this);
+    RS_Entity* ne;
+    if ( (data.scaleFactor.x - data.scaleFactor.y)>1.0e-6) {
+        if (e->rtti()== RS2::EntityArc) {
+			RS_Arc* a= static_cast<RS_Arc*>(e);
+			ne = new RS_Ellipse{parent,
+			{a->getCenter(), {a->getRadius(), 0.},
+					1, a->getAngle1(), a->getAngle2(),
+					a->isReversed()}
+		};
+            ne->setLayer(e->getLayer());
+            ne->setPen(e->getPen(false));
+        } else if (e->rtti()== RS2::EntityCircle) {
+			RS_Circle* a= static_cast<RS_Circle*>(e);
+			ne = new RS_Ellipse{parent,
+			{ a->getCenter(), {a->getRadius(), 0.}, 1, 0., 2.*M_PI, false}
+		};
+            ne->setLayer(e->getLayer());
+            ne->setPen(e->getPen(false));
+        } else
+            ne = e->clone();
+    } else
+        ne = e->clone();
+    ne->initId();
+    ne->setUpdateEnabled(false);
+    // if entity layer are 0 set to insert layer to allow "1 layer control" bug ID #3602152
+    RS_Layer *l= ne->getLayer();//special fontchar block don't have
+	if (l  && ne->getLayer()->getName() == "0")
+        ne->setLayer(getLayer());
+    ne->setParent(parent);
+    ne->setVisible(getFlag(RS2::FlagVisible));
+
+    // Move:
+    if (fabs(data.scaleFactor.x)>1.0e-6 &&
+            fabs(data.scaleFactor.y)>1.0e-6) {
+        ne->move(data.insertionPoint +
+                 RS_Vector(data.spacing.x/data.scaleFactor.x*col,
+                           data.spacing.y/data.scaleFactor.y*row));
+    }
+    else {
+        ne->move(data.insertionPoint);
+    }
+    // Move because of block base point:
+    ne->move(blk->getBasePoint()*-1);
+    // Scale:
+    ne->scale(data.insertionPoint, data.scaleFactor);
+    // Rotate:
+    ne->rotate(data.insertionPoint, data.angle);
+    // Select:
+    ne->setSelected(isSelected());
+
+    // individual entities can be on indiv. layers
+    RS_Pen tmpPen = ne->getPen(false);
+
+    // color from block (free floating):
+    if (tmpPen.getColor()==RS_Color(RS2::FlagByBlock)) {
+        tmpPen.setColor(getPen().getColor());
+    }
+
+    // line width from block (free floating):
+    if (tmpPen.getWidth()==RS2::WidthByBlock) {
+        tmpPen.setWidth(getPen().getWidth());
+    }
 
-                ne->setPen(tmpPen);
+    // line type from block (free floating):
+    if (tmpPen.getLineType()==RS2::LineByBlock) {
+        tmpPen.setLineType(getPen().getLineType());
+    }
 
-                                ne->setUpdateEnabled(true);
+    // now that we've evaluated all flags, let's strip them:
+    // TODO: strip all flags (width, line type)
+    //tmpPen.setColor(tmpPen.getColor().stripFlags());
 
-                                if (data.updateMode!=RS2::PreviewUpdate) {
-//                                        RS_DEBUG->print("RS_Insert::update: updating new entity");
-                                        ne->update();
-                                }
+    ne->setPen(tmpPen);
 
-//                                RS_DEBUG->print("RS_Insert::update: adding new entity");
-                appendEntity(ne);
-//                std::cout<<"done # of entity: "<<i_en_counts<<std::endl;
-            }
-        }
+    ne->setUpdateEnabled(true);
+
+    if (data.updateMode!=RS2::PreviewUpdate) {
+        if (!updateBlockInserts && ne->rtti()==RS2::EntityInsert)
+            static_cast<RS_Insert*>(ne)->regenerate(false);
+        else
+            ne->update();
     }
-    calculateBorders();
+    return ne;
+}
 
-        RS_DEBUG->print("RS_Insert::update: OK");
+
+const std::vector<std::unique_ptr<RS_Entity>>* RS_Insert::drawnInstances(RS_Block* blk) {
+	InstanceCache& cache = instanceCache;
+	RS_Pen const pen = getPen();
+	RS_Layer* const layer = getLayer();
+	bool const selected = isSelected();
+	bool const visible = getFlag(RS2::FlagVisible);
+	if (!cache.drawn.empty() && cache.pen == pen && cache.layer == layer
+			&& cache.selected == selected && cache.visible == visible) {
+		return &cache.drawn;
+	}
+
+	cache.clearDrawn();
+	size_t const n = size_t(blk->count())*data.cols*data.rows;
+	if (cachedInstances + n > instanceBudget) {
+		return nullptr;
+	}
+	cachedInstances += n;
+	cache.drawn.reserve(n);
+	for (auto e: *blk) {
+		for (int c=0; c<data.cols; ++c) {
+			for (int r=0; r<data.rows; ++r) {
+				cache.drawn.emplace_back(instanceOf(blk, e, c, r, false));
+			}
+		}
+	}
+	cache.pen = pen;
+	cache.layer = layer;
+	cache.selected = selected;
+	cache.visible = visible;
+	return &cache.drawn;
 }
 
 
+void RS_Insert::materialize() {
+	if (!instanced || !isEmpty()) {
+		return;
+	}
+	RS_Block* blk = getBlockForInsert();
+	if (!blk) {
+		return;
+	}
+	RS_DEBUG->print("RS_Insert::materialize: name: %s", data.name.toLatin1().data());
+	instanceCache.clearDrawn();
+	for (auto e: *blk) {
+		for (int c=0; c<data.cols; ++c) {
+			for (int r=0; r<data.rows; ++r) {
+				appendEntity(instanceOf(blk, e, c, r, false));
+			}
+		}
+	}
+}
+
+
+RS_Entity* RS_Insert::stepInstances(RS2::ResolveLevel level, int step,
+								   bool restart) {
+	InstanceCache& cache = instanceCache;
+	RS_Block* blk = getBlockForInsert();
+	int const cells = data.cols*data.rows;
+	int const n = (blk && cells > 0) ? int(blk->count())*cells : 0;
+	if (restart) {
+		cache.cursor = step > 0 ? -1 : n;
+	}
+	cache.cursorContainer = nullptr;
+	for (cache.cursor += step; 0 <= cache.cursor && cache.cursor < n;
+		 cache.cursor += step) {
+		int const k = cache.cursor;
+		RS_Entity* ne = cache.findPicked(k);
+		if (ne) {
+			cache.cursorEntity.reset();
+		} else {
+			cache.cursorEntity.reset(instanceOf(blk, blk->entityAt(k / cells),
+												(k % cells) / data.rows,
+												k % data.rows, false));
+			ne = cache.cursorEntity.get();
+		}
+		if (!resolvesInto(ne, level)) {
+			return ne;
+		}
+		auto ec = static_cast<RS_EntityContainer*>(ne);
+		RS_Entity* e = step > 0 ? ec->firstEntity(level) : ec->lastEntity(level);
+		// empty containers are skipped
+		if (e) {
+			cache.cursorContainer = ec;
+			return e;
+		}
+	}
+	cache.cursorEntity.reset();
+	return nullptr;
+}
+
+
+RS_Entity* RS_Insert::firstEntity(RS2::ResolveLevel level) {
+	if (level == RS2::ResolveNone || !instanced || !isEmpty()) {
+		return RS_EntityContainer::firstEntity(level);
+	}
+	return stepInstances(level, 1, true);
+}
+
+
+RS_Entity* RS_Insert::lastEntity(RS2::ResolveLevel level) {
+	if (level == RS2::ResolveNone || !instanced || !isEmpty()) {
+		return RS_EntityContainer::lastEntity(level);
+	}
+	return stepInstances(level, -1, true);
+}
+
+
+RS_Entity* RS_Insert::nextEntity(RS2::ResolveLevel level) {
+	if (level == RS2::ResolveNone || !instanced || !isEmpty()) {
+		return RS_EntityContainer::nextEntity(level);
+	}
+	if (instanceCache.cursorContainer) {
+		RS_Entity* e = instanceCache.cursorContainer->nextEntity(level);
+		if (e) {
+			return e;
+		}
+	}
+	return stepInstances(level, 1, false);
+}
+
+
+RS_Entity* RS_Insert::prevEntity(RS2::ResolveLevel level) {
+	if (level == RS2::ResolveNone || !instanced || !isEmpty()) {
+		return RS_EntityContainer::prevEntity(level);
+	}
+	if (instanceCache.cursorContainer) {
+		RS_Entity* e = instanceCache.cursorContainer->prevEntity(level);
+		if (e) {
+			return e;
+		}
+	}
+	return stepInstances(level, -1, false);
+}
+
+
+/**
+ * Transforms a point of the block the same way the cloned block
+ * entities are transformed: moved to the cell and by the base point,
+ * scaled and rotated around the insertion point.
+ */
+RS_Vector RS_Insert::instanceToWorld(const RS_Vector& p, int col, int row) const {
+	RS_Vector v = p - block->getBasePoint()
+			+ RS_Vector(data.spacing.x/data.scaleFactor.x*col,
+						data.spacing.y/data.scaleFactor.y*row);
+	v = RS_Vector(v.x*data.scaleFactor.x, v.y*data.scaleFactor.y);
+	v.rotate(data.angle);
+	return v + data.insertionPoint;
+}
+
+
+RS_Vector RS_Insert::worldToInstance(const RS_Vector& p, int col, int row) const {
+	RS_Vector v = p - data.insertionPoint;
+	v.rotate(-data.angle);
+	v = RS_Vector(v.x/data.scaleFactor.x, v.y/data.scaleFactor.y);
+	return v + block->getBasePoint()
+			- RS_Vector(data.spacing.x/data.scaleFactor.x*col,
+						data.spacing.y/data.scaleFactor.y*row);
+}
+
+
+LC_Rect RS_Insert::instanceBox(const RS_Vector& minP, const RS_Vector& maxP,
+							   int col, int row) const {
+	LC_Rect box{instanceToWorld(minP, col, row), instanceToWorld(maxP, col, row)};
+	for (const RS_Vector& v: LC_Rect{minP, maxP}.vertices()) {
+		box = box.merge(instanceToWorld(v, col, row));
+	}
+	return box;
+}
+
+
+/**
+ * The borders of the block placed in the corner cells are exact for
+ * multiples of 90 degrees only, inserts at other angles take the
+ * borders of the transformed entities.
+ */
+void RS_Insert::calculateInstanceBorders(RS_Block* blk) {
+	resetBorders();
+	if (data.cols<=0 || data.rows<=0 || blk->isEmpty()) {
+		return;
+	}
+	// only the corner cells of an array add to the borders:
+	int const colStep = std::max(1, data.cols-1);
+	int const rowStep = std::max(1, data.rows-1);
+
+	if (fabs(remainder(data.angle, M_PI_2)) < RS_TOLERANCE_ANGLE) {
+		for (int c=0; c<data.cols; c+=colStep) {
+			for (int r=0; r<data.rows; r+=rowStep) {
+				LC_Rect box = instanceBox(blk->getMin(), blk->getMax(), c, r);
+				minV = RS_Vector::minimum(minV, box.minP());
+				maxV = RS_Vector::maximum(maxV, box.maxP());
+			}
+		}
+		return;
+	}
+
+	for (auto e: *blk) {
+		for (int c=0; c<data.cols; c+=colStep) {
+			for (int r=0; r<data.rows; r+=rowStep) {
+				std::unique_ptr<RS_Entity> ne{instanceOf(blk, e, c, r, false)};
+				RS_Layer* layer = ne->getLayer();
+				if (ne->isVisible() && !(layer && layer->isFrozen())) {
+					adjustBorders(ne.get());
+				}
+			}
+		}
+	}
+}
+
+
+void RS_Insert::calculateBorders() {
+	if (instanced) {
+		// kept from update(), they only change with the block
+		return;
+	}
+	if (!glyph || glyph->isEmpty()) {
+		RS_EntityContainer::calculateBorders();
+		return;
+	}
+
+	resetBorders();
+	for (const auto& stroke: glyph->getStrokes()) {
+		for (const RS_Vector& p: stroke) {
+			RS_Vector v = glyphToWorld(p);
+			minV = RS_Vector::minimum(minV, v);
+			maxV = RS_Vector::maximum(maxV, v);
+		}
+	}
+}
+
+void RS_Insert::forcedCalculateBorders() {
+	if (glyph || instanced) {
+		calculateBorders();
+	} else {
+		RS_EntityContainer::forcedCalculateBorders();
+	}
+}
+
+
+/**
+ * Transforms a point of the glyph the same way update() transforms the
+ * cloned block entities: scale and rotate around the insertion point.
+ */
+RS_Vector RS_Insert::glyphToWorld(const RS_Vector& p) const {
+	RS_Vector v(p.x*data.scaleFactor.x, p.y*data.scaleFactor.y);
+	v.rotate(data.angle);
+	return v + data.insertionPoint;
+}
+
+
+RS_Vector RS_Insert::getNearestGlyphPoint(const RS_Vector& coord,
+										  double* dist) const {
+	double minDist = RS_MAXDOUBLE;
+	RS_Vector closestPoint(false);
+	for (const auto& stroke: glyph->getStrokes()) {
+		RS_Vector p0 = glyphToWorld(stroke.front());
+		if (stroke.size() == 1 && p0.distanceTo(coord) < minDist) {
+			minDist = p0.distanceTo(coord);
+			closestPoint = p0;
+		}
+		for (size_t i = 1; i < stroke.size(); ++i) {
+			RS_Vector p1 = glyphToWorld(stroke[i]);
+			RS_Vector dp = p1 - p0;
+			double l2 = dp.squared();
+			double t = l2 > RS_TOLERANCE2 ? RS_Vector::dotP(coord - p0, dp)/l2 : 0.;
+			RS_Vector p = p0 + dp*std::min(1., std::max(0., t));
+			double d = p.distanceTo(coord);
+			if (d < minDist) {
+				minDist = d;
+				closestPoint = p;
+			}
+			p0 = p1;
+		}
+	}
+	if (dist) {
+		*dist = minDist;
+	}
+	return closestPoint;
+}
+
+
+RS_Vector RS_Insert::getNearestInstancePoint(const RS_Vector& coord, double* dist,
+		const std::function<RS_Vector(RS_Block*, const RS_Vector&)>& query) const {
+	double minDist = RS_MAXDOUBLE;
+	RS_Vector closestPoint(false);
+	RS_Block* blk = getBlockForInsert();
+	if (blk) {
+		for (int c=0; c<data.cols; ++c) {
+			for (int r=0; r<data.rows; ++r) {
+				RS_Vector p = query(blk, worldToInstance(coord, c, r));
+				if (!p.valid) {
+					continue;
+				}
+				p = instanceToWorld(p, c, r);
+				double d = p.distanceTo(coord);
+				if (d < minDist) {
+					minDist = d;
+					closestPoint = p;
+				}
+			}
+		}
+	}
+	if (dist) {
+		*dist = minDist;
+	}
+	return closestPoint;
+}
+
+
+RS_Vector RS_Insert::getNearestEndpoint(const RS_Vector& coord,
+										double* dist) const {
+	if (!instanced) {
+		return RS_EntityContainer::getNearestEndpoint(coord, dist);
+	}
+	return getNearestInstancePoint(coord, dist,
+								   [](RS_Block* blk, const RS_Vector& p) {
+		return blk->getNearestEndpoint(p);
+	});
+}
+
+
+RS_Vector RS_Insert::getNearestPointOnEntity(const RS_Vector& coord,
+											 bool onEntity, double* dist,
+											 RS_Entity** entity) const {
+	if (!glyph && !instanced) {
+		return RS_EntityContainer::getNearestPointOnEntity(coord, onEntity,
+														   dist, entity);
+	}
+	if (entity) {
+		*entity = const_cast<RS_Insert*>(this);
+	}
+	if (glyph) {
+		return getNearestGlyphPoint(coord, dist);
+	}
+	return getNearestInstancePoint(coord, dist,
+								   [onEntity](RS_Block* blk, const RS_Vector& p) {
+		return blk->getNearestPointOnEntity(p, onEntity);
+	});
+}
+
+
+RS_Vector RS_Insert::getNearestCenter(const RS_Vector& coord,
+									  double* dist) const {
+	if (!instanced) {
+		return RS_EntityContainer::getNearestCenter(coord, dist);
+	}
+	return getNearestInstancePoint(coord, dist,
+								   [](RS_Block* blk, const RS_Vector& p) {
+		return blk->getNearestCenter(p);
+	});
+}
+
+
+RS_Vector RS_Insert::getNearestMiddle(const RS_Vector& coord,
+									  double* dist,
+									  int middlePoints) const {
+	if (!instanced) {
+		return RS_EntityContainer::getNearestMiddle(coord, dist, middlePoints);
+	}
+	return getNearestInstancePoint(coord, dist,
+								   [middlePoints](RS_Block* blk, const RS_Vector& p) {
+		return blk->getNearestMiddle(p, nullptr, middlePoints);
+	});
+}
+
+
+RS_Vector RS_Insert::getNearestDist(double distance,
+									const RS_Vector& coord,
+									double* dist) const {
+	if (!instanced) {
+		return RS_EntityContainer::getNearestDist(distance, coord, dist);
+	}
+	// distances along the block entities are scaled:
+	double const blockDistance = distance/fabs(data.scaleFactor.x);
+	return getNearestInstancePoint(coord, dist,
+								   [blockDistance](RS_Block* blk, const RS_Vector& p) {
+		return blk->getNearestDist(blockDistance, p);
+	});
+}
+
+
+/**
+ * Instanced inserts have no entities. All cells are translated copies of
+ * each other, so the transformed block entities of one cell are measured.
+ */
+double RS_Insert::getLength() const {
+	if (!instanced || !isEmpty()) {
+		return RS_EntityContainer::getLength();
+	}
+	RS_Block* blk = getBlockForInsert();
+	int const cells = data.cols*data.rows;
+	if (!blk || cells <= 0) {
+		return 0.;
+	}
+	double ret = 0.;
+	for (auto e: *blk) {
+		std::unique_ptr<RS_Entity> ne{instanceOf(blk, e, 0, 0, false)};
+		if (!ne->isVisible()) {
+			continue;
+		}
+		double const l = ne->getLength();
+		if (l < 0.) {
+			return -1.;
+		}
+		ret += l;
+	}
+	return ret*cells;
+}
+
+
+/**
+ * Resolving levels return the single entities of the insert, instanced
+ * inserts transform their block entities for that, see
+ * getDistanceToInstances().
+ */
+double RS_Insert::getDistanceToPoint(const RS_Vector& coord,
+									 RS_Entity** entity,
+									 RS2::ResolveLevel level,
+									 double solidDist) const {
+	if (!glyph && !(instanced && isEmpty())) {
+		return RS_EntityContainer::getDistanceToPoint(coord, entity, level,
+													  solidDist);
+	}
+	if (instanced && entity && level != RS2::ResolveNone
+			&& level != RS2::ResolveAllButInserts) {
+		return getDistanceToInstances(coord, entity, level, solidDist);
+	}
+	if (entity) {
+		*entity = const_cast<RS_Insert*>(this);
+	}
+	double dist = RS_MAXDOUBLE;
+	if (glyph) {
+		getNearestGlyphPoint(coord, &dist);
+	} else {
+		getNearestInstancePoint(coord, &dist,
+								[](RS_Block* blk, const RS_Vector& p) {
+			return blk->getNearestPointOnEntity(p, true);
+		});
+	}
+	return dist;
+}
+
+
+/**
+ * Block entities whose transformed box is farther than the closest entity
+ * found so far are skipped, the others are transformed one at a time.
+ * Like a container, the later of two equally close entities wins. The
+ * closest one is kept, so the entity returned stays valid until the
+ * next update() or until eight other instances were picked. Picks count
+ * against the entity budget of the draw caches.
+ */
+double RS_Insert::getDistanceToInstances(const RS_Vector& coord,
+										 RS_Entity** entity,
+										 RS2::ResolveLevel level,
+										 double solidDist) const {
+	InstanceCache& cache = instanceCache;
+	double minDist = RS_MAXDOUBLE;
+	*entity = nullptr;
+	RS_Block* blk = getBlockForInsert();
+	int const cells = data.cols*data.rows;
+	if (!blk || cells <= 0) {
+		return minDist;
+	}
+
+	int closest = -1;
+	std::unique_ptr<RS_Entity> closestEntity;
+	int const n = int(blk->count())*cells;
+	for (int k = 0; k < n; ++k) {
+		RS_Entity* e = blk->entityAt(k / cells);
+		int const c = (k % cells) / data.rows;
+		int const r = k % data.rows;
+		// bug#426, need to ignore Images to find nearest intersections
+		if (level==RS2::ResolveAllButTextImage && e->rtti()==RS2::EntityImage) {
+			continue;
+		}
+		if (e->rtti() != RS2::EntityConstructionLine
+				&& distanceToBox(instanceBox(e->getMin(), e->getMax(), c, r), coord) > minDist) {
+			continue;
+		}
+
+		std::unique_ptr<RS_Entity> temp;
+		RS_Entity* ne = cache.findPicked(k);
+		if (!ne) {
+			temp.reset(instanceOf(blk, e, c, r, false));
+			ne = temp.get();
+		}
+		if (!ne->isVisible()) {
+			continue;
+		}
+		RS_Entity* subEntity = nullptr;
+		double const dist = ne->getDistanceToPoint(coord, &subEntity, level, solidDist);
+		if (dist <= minDist) {
+			minDist = dist;
+			closest = k;
+			closestEntity = std::move(temp);
+			*entity = (level==RS2::ResolveAll || level==RS2::ResolveAllButTextImage)
+					? subEntity : ne;
+		}
+	}
+	if (closestEntity) {
+		cache.addPicked(closest, std::move(closestEntity));
+	}
+	return minDist;
+}
+
+
+bool RS_Insert::isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const {
+	LC_Rect window{v1, v2};
+	if (instanced) {
+		RS_Block* blk = getBlockForInsert();
+		if (!blk) {
+			return false;
+		}
+		for (auto e: *blk) {
+			for (int c=0; c<data.cols; ++c) {
+				for (int r=0; r<data.rows; ++r) {
+					if (e->rtti() != RS2::EntityConstructionLine) {
+						LC_Rect const box = instanceBox(e->getMin(), e->getMax(), c, r);
+						if (!box.overlaps(window)) {
+							continue;
+						}
+						// the transformed block bounds are in the window
+						if (box.inArea(window)) {
+							return true;
+						}
+					}
+					std::unique_ptr<RS_Entity> ne{instanceOf(blk, e, c, r, false)};
+					if (RS_EntityContainer::isCrossingWindow(ne.get(), v1, v2)) {
+						return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
+	if (!glyph) {
+		return false;
+	}
+	for (const auto& stroke: glyph->getStrokes()) {
+		RS_Vector p0 = glyphToWorld(stroke.front());
+		if (window.inArea(p0)) {
+			return true;
+		}
+		for (size_t i = 1; i < stroke.size(); ++i) {
+			RS_Vector p1 = glyphToWorld(stroke[i]);
+			double t0 = 0.;
+			double t1 = 1.;
+			if (window.clipLine(p0, p1, t0, t1)) {
+				return true;
+			}
+			p0 = p1;
+		}
+	}
+	return false;
+}
+
 
 /**
  * @return Pointer to the block associated with this Insert or
@@ -388,6 +1046,79 @@ void RS_Insert::mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2)
 }
 
 
+/**
+ * Draws the glyph strokes of a letter, the block entities otherwise.
+ * Glyphs are always drawn with continuous lines, line types are not
+ * applied to text.
+ * Instanced inserts draw the transformed block entities kept in their
+ * cache. Without room in the cache, the block entities in the viewport
+ * are transformed one by one while drawing. Inserts of a few pixels only
+ * show their borders.
+ */
+void RS_Insert::draw(RS_Painter* painter, RS_GraphicView* view,
+					 double& patternOffset) {
+	if (!glyph && !(instanced && isEmpty())) {
+		RS_EntityContainer::draw(painter, view, patternOffset);
+		return;
+	}
+	if (!(painter && view)) {
+		return;
+	}
+
+	if (instanced) {
+		RS_Block* blk = getBlockForInsert();
+		if (!blk) {
+			return;
+		}
+		if (!view->isPrintPreview() && !view->isPrinting()
+				&& view->toGuiDX(getSize().x) < 2 && view->toGuiDY(getSize().y) < 2) {
+			painter->drawRect(view->toGui(getMin()), view->toGui(getMax()));
+			return;
+		}
+
+		LC_Rect const viewport{view->toGraph(0, 0),
+							   view->toGraph(view->getWidth(), view->getHeight())};
+		if (auto drawn = drawnInstances(blk)) {
+			for (auto const& ne: *drawn) {
+				if (!view->isPrinting()
+						&& ne->rtti() != RS2::EntityConstructionLine
+						&& !LC_Rect{ne->getMin(), ne->getMax()}.overlaps(viewport)) {
+					continue;
+				}
+				view->drawEntity(painter, ne.get());
+			}
+			return;
+		}
+		for (auto e: *blk) {
+			for (int c=0; c<data.cols; ++c) {
+				for (int r=0; r<data.rows; ++r) {
+					if (!view->isPrinting()
+							&& e->rtti() != RS2::EntityConstructionLine
+							&& !instanceBox(e->getMin(), e->getMax(), c, r).overlaps(viewport)) {
+						continue;
+					}
+					std::unique_ptr<RS_Entity> ne{instanceOf(blk, e, c, r, false)};
+					view->drawEntity(painter, ne.get());
+				}
+			}
+		}
+		return;
+	}
+
+	for (const auto& stroke: glyph->getStrokes()) {
+		RS_Vector p0 = view->toGui(glyphToWorld(stroke.front()));
+		if (stroke.size() == 1) {
+			painter->drawLine(p0, p0);
+		}
+		for (size_t i = 1; i < stroke.size(); ++i) {
+			RS_Vector p1 = view->toGui(glyphToWorld(stroke[i]));
+			painter->drawLine(p0, p1);
+			p0 = p1;
+		}
+	}
+}
+
+
 std::ostream& operator << (std::ostream& os, const RS_Insert& i) {
     os << " Insert: " << i.getData() << std::endl;
     return os;
@@ -28,9 +28,16 @@
 #ifndef RS_INSERT_H
 #define RS_INSERT_H
 
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lc_rect.h"
 #include "rs_entitycontainer.h"
 
 class RS_BlockList;
+class LC_Glyph;
 
 /**
  * Holds the data that defines an insert.
@@ -117,7 +124,59 @@ public:
 
 	RS_Block* getBlockForInsert() const;
 
+    /**
+     * Lets this insert draw a glyph shared with all other letters of
+     * the font instead of cloning the entities of the letter block.
+     * Used by texts, only exploding materializes the letter entities.
+     *
+     * @param g The glyph of the block or nullptr to clone the block.
+     */
+    void setGlyph(const LC_Glyph* g) {
+        glyph = g;
+    }
+    const LC_Glyph* getGlyph() const {
+        return glyph;
+    }
+
+    /**
+     * @return true, if the insert holds no clones of the block entities,
+     * but draws and snaps the entities of its block through its
+     * transformation. All inserts with a uniform scale are instanced.
+     */
+    bool isInstanced() const {
+        return instanced;
+    }
+    /**
+     * Clones the block entities into an instanced insert, as needed to
+     * explode or edit it. The clones are dropped by the next update().
+     */
+    void materialize();
+    /**
+     * @return the box of an area of the block placed in one cell of the
+     * insert
+     */
+    LC_Rect instanceBox(const RS_Vector& minP, const RS_Vector& maxP,
+                        int col, int row) const;
+
+    /**
+     * Resolving levels visit the block entities of instanced inserts as
+     * temporary transformed entities, one at a time. An entity returned
+     * is valid until the traversal moves on.
+     */
+    virtual RS_Entity* firstEntity(RS2::ResolveLevel level=RS2::ResolveNone);
+    virtual RS_Entity* lastEntity(RS2::ResolveLevel level=RS2::ResolveNone);
+    virtual RS_Entity* nextEntity(RS2::ResolveLevel level=RS2::ResolveNone);
+    virtual RS_Entity* prevEntity(RS2::ResolveLevel level=RS2::ResolveNone);
+
     virtual void update();
+    /**
+     * Like update(), but the inserts of the block are taken as up to date
+     * and only read. Inserts of the same block can be updated by several
+     * threads this way, once the blocks were updated bottom up.
+     */
+    void updateFromUpdatedBlock();
+    virtual void calculateBorders();
+    virtual void forcedCalculateBorders();
 
     QString getName() const {
         return data.name;
@@ -179,6 +238,34 @@ public:
     }
     virtual RS_Vector getNearestRef(const RS_Vector& coord,
 									 double* dist = nullptr) const;
+    virtual RS_Vector getNearestEndpoint(const RS_Vector& coord,
+                                         double* dist = nullptr) const;
+    virtual RS_Vector getNearestPointOnEntity(const RS_Vector& coord,
+                                              bool onEntity = true,
+                                              double* dist = nullptr,
+                                              RS_Entity** entity = nullptr) const;
+    virtual RS_Vector getNearestCenter(const RS_Vector& coord,
+                                       double* dist = nullptr) const;
+    virtual RS_Vector getNearestMiddle(const RS_Vector& coord,
+                                       double* dist = nullptr,
+                                       int middlePoints = 1) const;
+    virtual RS_Vector getNearestDist(double distance,
+                                     const RS_Vector& coord,
+                                     double* dist = nullptr) const;
+    virtual double getDistanceToPoint(const RS_Vector& coord,
+                                      RS_Entity** entity,
+                                      RS2::ResolveLevel level=RS2::ResolveNone,
+                                      double solidDist = RS_MAXDOUBLE) const;
+    /**
+     * @return total length of the entities, the transformed block
+     * entities of all cells for instanced inserts
+     */
+    double getLength() const override;
+    /**
+     * @return true, if a stroke of the glyph or an entity of the
+     * instanced block crosses the window
+     */
+    bool isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const;
 
     virtual void move(const RS_Vector& offset);
     virtual void rotate(const RS_Vector& center, const double& angle);
@@ -186,11 +273,103 @@ public:
     virtual void scale(const RS_Vector& center, const RS_Vector& factor);
     virtual void mirror(const RS_Vector& axisPoint1, const RS_Vector& axisPoint2);
 
+    virtual void draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset);
+
     friend std::ostream& operator << (std::ostream& os, const RS_Insert& i);
 
 protected:
+    /** @return a point of the glyph transformed to drawing coordinates */
+    RS_Vector glyphToWorld(const RS_Vector& p) const;
+    RS_Vector getNearestGlyphPoint(const RS_Vector& coord, double* dist) const;
+    /** @param updateBlockInserts update the inserts of the block first */
+    void regenerate(bool updateBlockInserts);
+
+    /** @return a point of the block transformed to one cell of the insert */
+    RS_Vector instanceToWorld(const RS_Vector& p, int col, int row) const;
+    /** @return a point of the drawing transformed back into the block */
+    RS_Vector worldToInstance(const RS_Vector& p, int col, int row) const;
+    /**
+     * @return the closest of the points found by a query of the block,
+     * the query is run once per cell with coord transformed into the block
+     */
+    RS_Vector getNearestInstancePoint(const RS_Vector& coord, double* dist,
+            const std::function<RS_Vector(RS_Block*, const RS_Vector&)>& query) const;
+    void calculateInstanceBorders(RS_Block* blk);
+    /**
+     * @return a new entity of the block transformed to one cell, with
+     * the pen and layer resolved for this insert
+     */
+    RS_Entity* instanceOf(RS_Block* blk, RS_Entity* e, int col, int row,
+                          bool updateBlockInserts) const;
+
+    /**
+     * Block entities transformed to the cells of an instanced insert, kept
+     * for drawing and queries until the next update(). Copies of an insert
+     * start without them. Instances are numbered in the order of
+     * materialize().
+     */
+    struct InstanceCache {
+        InstanceCache() = default;
+        InstanceCache(const InstanceCache&) {}
+        InstanceCache& operator = (const InstanceCache&) {
+            clear();
+            return *this;
+        }
+        ~InstanceCache() {
+            clear();
+        }
+        void clear();
+        void clearDrawn();
+        //! @return the picked entity of instance k, nullptr if there is none
+        RS_Entity* findPicked(int k) const;
+        //! keeps a picked entity, the oldest pick is dropped beyond a few
+        void addPicked(int k, std::unique_ptr<RS_Entity> entity);
+
+        //! entities in the order of materialize()
+        std::vector<std::unique_ptr<RS_Entity>> drawn;
+        //! attributes of the insert the entities were made with
+        RS_Pen pen;
+        RS_Layer* layer = nullptr;
+        bool selected = false;
+        bool visible = false;
+
+        //! entities returned by getDistanceToPoint() with their instance,
+        //! the most recent last
+        std::vector<std::pair<int, std::unique_ptr<RS_Entity>>> picked;
+        //! instance visited by firstEntity() and friends
+        int cursor = -1;
+        //! the temporary entity at the cursor, unless it was picked
+        std::unique_ptr<RS_Entity> cursorEntity;
+        //! the container at the cursor while its entities are visited
+        RS_EntityContainer* cursorContainer = nullptr;
+    };
+    /**
+     * @return the cached entities to draw, rebuilt if the pen, layer,
+     * selection or visibility of the insert changed. nullptr, if all
+     * inserts together would cache too many entities.
+     */
+    const std::vector<std::unique_ptr<RS_Entity>>* drawnInstances(RS_Block* blk);
+    /**
+     * Moves the cursor of a resolving traversal by step instances, or
+     * starts it at the first or last instance, and returns the entity
+     * found there.
+     */
+    RS_Entity* stepInstances(RS2::ResolveLevel level, int step, bool restart);
+    /**
+     * getDistanceToPoint() at resolving levels: the closest entity is
+     * kept in the cache along with the last few picks, the others are
+     * temporary.
+     */
+    double getDistanceToInstances(const RS_Vector& coord, RS_Entity** entity,
+                                  RS2::ResolveLevel level,
+                                  double solidDist) const;
+
     RS_InsertData data;
 	mutable RS_Block* block;
+    const LC_Glyph* glyph;
+    //! the block entities are not cloned, see isInstanced()
+    bool instanced;
+    mutable InstanceCache instanceCache;
 };
 
 
@@ -46,6 +46,7 @@ RS_LayerList::RS_LayerList() {
  */
 void RS_LayerList::clear() {
     layers.clear();
+    layerByName.clear();
 	setModified(true);
 }
 
@@ -154,6 +155,7 @@ void RS_LayerList::add(RS_Layer* layer) {
     RS_Layer* l = find(layer->getName());
     if (l==NULL) {
         layers.append(layer);
+        layerByName.insert(layer->getName(), layer);
         this->sort();
         // notify listeners
         for (int i=0; i<layerListListeners.size(); ++i) {
@@ -200,6 +202,9 @@ void RS_LayerList::remove(RS_Layer* layer) {
 
     // here the layer is removed from the list but not deleted
     layers.removeOne(layer);
+    if (layerByName.value(layer->getName()) == layer) {
+        layerByName.remove(layer->getName());
+    }
 
     for (int i=0; i<layerListListeners.size(); ++i) {
         RS_LayerListListener* l = layerListListeners.at(i);
@@ -229,7 +234,11 @@ void RS_LayerList::edit(RS_Layer* layer, const RS_Layer& source) {
         return;
     }
 
+    if (layerByName.value(layer->getName()) == layer) {
+        layerByName.remove(layer->getName());
+    }
     *layer = source;
+    layerByName.insert(layer->getName(), layer);
 
     for (int i=0; i<layerListListeners.size(); ++i) {
         RS_LayerListListener* l = layerListListeners.at(i);
@@ -247,21 +256,7 @@ void RS_LayerList::edit(RS_Layer* layer, const RS_Layer& source) {
  * \p NULL if no such layer was found.
  */
 RS_Layer* RS_LayerList::find(const QString& name) {
-    //RS_DEBUG->print("RS_LayerList::find begin");
-
-    RS_Layer* ret = NULL;
-
-    for (int i=0; i<layers.size(); ++i) {
-        RS_Layer* l = layers.at(i);
-        if (l->getName()==name) {
-            ret = l;
-            break;
-        }
-    }
-
-    //RS_DEBUG->print("RS_LayerList::find end");
-
-    return ret;
+    return layerByName.value(name, NULL);
 }
 
 
@@ -271,22 +266,8 @@ RS_Layer* RS_LayerList::find(const QString& name) {
  * was not found.
  */
 int RS_LayerList::getIndex(const QString& name) {
-    //RS_DEBUG->print("RS_LayerList::find begin");
-
-    int ret = -1;
-
-    for (int i=0; i<layers.size(); i++) {
-        RS_Layer* l = layers.at(i);
-
-        if (l->getName()==name) {
-            ret = i;
-            break;
-        }
-    }
-
-    //RS_DEBUG->print("RS_LayerList::find end");
-
-    return ret;
+    RS_Layer* l = find(name);
+    return l ? layers.indexOf(l) : -1;
 }
 
 
@@ -29,6 +29,7 @@
 #ifndef RS_LAYERLIST_H
 #define RS_LAYERLIST_H
 
+#include <QHash>
 #include <QList>
 #include "rs_layer.h"
 
@@ -112,6 +113,17 @@ public:
      */
     void setModified(bool m) {
         modified = m;
+        if (m) {
+            ++modificationCount;
+        }
+    }
+
+    /**
+     * @return Counter which changes whenever the layer list is modified,
+     * unlike isModified() it isn't reset by saving.
+     */
+    unsigned long getModificationCount() const {
+        return modificationCount;
     }
 
     /**
@@ -131,6 +143,8 @@ public:
 private:
     //! layers in the graphic
     QList<RS_Layer*> layers;
+    //! layers by name, for find()
+    QHash<QString, RS_Layer*> layerByName;
     //! List of registered LayerListListeners
     QList<RS_LayerListListener*> layerListListeners;
     QG_LayerWidget* layerWidget;
@@ -138,6 +152,7 @@ private:
     RS_Layer* activeLayer;
     /** Flag set if the layer list was modified and not yet saved. */
     bool modified;
+    unsigned long modificationCount = 0;
 };
 
 #endif
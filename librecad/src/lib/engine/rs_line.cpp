@@ -564,96 +564,52 @@ void RS_Line::moveRef(const RS_Vector& ref, const RS_Vector& offset) {
 }
 
 
+bool RS_Line::isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const {
+	double t0 = 0.;
+	double t1 = 1.;
+	return LC_Rect{v1, v2}.clipLine(data.startpoint, data.endpoint, t0, t1);
+}
+
+
 void RS_Line::draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset) {
 	if (! (painter && view)) {
         return;
     }
 
-    auto viewportRect = view->getViewRect();
-    RS_VectorSolutions endPoints(0);
-    endPoints.push_back(getStartpoint());
-    endPoints.push_back(getEndpoint());
-
-    RS_EntityContainer ec(nullptr);
-    ec.addRectangle(viewportRect.minP(), viewportRect.maxP());
-
-//    if (viewportRect.inArea(getStartpoint(), RS_TOLERANCE))
-//         endPoints.push_back(getStartpoint());
-//    if (viewportRect.inArea(getEndpoint(), RS_TOLERANCE))
-//         endPoints.push_back(getEndpoint());
-
-//    if (endPoints.size() < 2){
-//        RS_VectorSolutions vpIts;
-//        for(auto p: ec) {
-//            auto const sol=RS_Information::getIntersection(this, p, true);
-//            for (auto const& vp: sol) {
-//                if (vpIts.getClosestDistance(vp) <= RS_TOLERANCE * 10.)
-//                    continue;
-//                vpIts.push_back(vp);
-//            }
-//        }
-//        for (auto const& vp: vpIts) {
-//            if (endPoints.getClosestDistance(vp) <= RS_TOLERANCE * 10.)
-//                continue;
-//            endPoints.push_back(vp);
-//        }
-//    }
-
-//    if (endPoints.size()<2) return;
-
-    if ((endPoints[0] - getStartpoint()).squared() >
-            (endPoints[1] - getStartpoint()).squared() )
-    {
-        std::swap(endPoints[0],endPoints[1]);
-    }
-
-	RS_Vector pStart{view->toGui(endPoints.at(0))};
-	RS_Vector pEnd{view->toGui(endPoints.at(1))};
-    //    std::cout<<"draw line: "<<pStart<<" to "<<pEnd<<std::endl;
+	RS_Vector pStart{view->toGui(getStartpoint())};
+	RS_Vector pEnd{view->toGui(getEndpoint())};
 	RS_Vector direction = pEnd-pStart;
 
-	if (isConstruction(true) && direction.squared() > RS_TOLERANCE){
-        //extend line on a construction layer to fill the whole view
-		RS_VectorSolutions vpIts;
-		for(auto p: ec) {
-            auto const sol=RS_Information::getIntersection(this, p, true);
-			for (auto const& vp: sol) {
-				if (vpIts.getClosestDistance(vp) <= RS_TOLERANCE * 10.)
-					continue;
-				vpIts.push_back(vp);
-			}
-		}
+	// visible part of the line, as parameter range from pStart to pEnd
+	LC_Rect const viewportRect{{0., 0.}, {double(view->getWidth()), double(view->getHeight())}};
+	double t0 = 0.;
+	double t1 = 1.;
 
-		//draw construction lines up to viewport border
-		switch (vpIts.size()) {
-		case 2:
-			// no need to sort intersections
-			break;
-		case 3:
-		case 4: {
-			// will use the inner two points
-			size_t i{0};
-			for (size_t j = 0; j < vpIts.size(); ++j)
-				if (viewportRect.inArea(vpIts.at(j), RS_TOLERANCE * 10.))
-					std::swap(vpIts[j], vpIts[i++]);
-
-		}
-			break;
-		default:
-			//should not happen
+	if (isConstruction(true) && direction.squared() > RS_TOLERANCE){
+		//extend line on a construction layer to fill the whole view
+		t0 = -RS_MAXDOUBLE;
+		t1 = RS_MAXDOUBLE;
+		if (!viewportRect.clipLine(pStart, pEnd, t0, t1))
 			return;
-		}
-		pStart=view->toGui(vpIts.get(0));
-		pEnd=view->toGui(vpIts.get(1));
-		direction=pEnd-pStart;
-    }
+		//draw construction lines up to viewport border
+		pEnd = pStart + direction*t1;
+		pStart += direction*t0;
+		direction = pEnd-pStart;
+		t0 = 0.;
+		t1 = 1.;
+	} else if (!view->isPrinting()
+			   && !viewportRect.clipLine(pStart, pEnd, t0, t1)) {
+		// completely outside of the viewport
+		patternOffset -= direction.magnitude();
+		return;
+	}
     double  length=direction.magnitude();
     patternOffset -= length;
     if (( !isSelected() && (
               getPen().getLineType()==RS2::SolidLine ||
               view->getDrawingMode()==RS2::ModePreview)) ) {
         //if length is too small, attempt to draw the line, could be a potential bug
-        painter->drawLine(pStart,pEnd);
+        painter->drawLine(pStart + direction*t0, pStart + direction*t1);
         return;
     }
     //    double styleFactor = getStyleFactor(view);
@@ -711,8 +667,18 @@ void RS_Line::draw(RS_Painter* painter, RS_GraphicView* view, double& patternOff
 	double total= remainder(patternOffset-0.5*patternSegmentLength,patternSegmentLength) -0.5*patternSegmentLength;
     //    double total= patternOffset-patternSegmentLength;
 
+	// skip whole pattern periods in front of the visible part of the line,
+	// so the pattern phase stays the same as for an unclipped line
+	double const visibleStart = t0*length;
+	double const visibleEnd = t1*length;
+	double period = 0.;
+	for (double d: ds)
+		period += fabs(d);
+	if (visibleStart - total > period)
+		total += period*floor((visibleStart - total)/period);
+
 	RS_Vector curP{pStart+direction*total};
-	for (int j=0; total<length; j=(j+1)%pat->num) {
+	for (int j=0; total<visibleEnd; j=(j+1)%pat->num) {
 
         // line segment (otherwise space segment)
 		double const t2=total+fabs(ds[j]);
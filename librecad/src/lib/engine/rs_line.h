@@ -201,6 +201,8 @@ public:
                  const RS_Vector& offset) override;
     void moveRef(const RS_Vector& ref, const RS_Vector& offset) override;
 
+    /** @return true, if the line has a point in the window */
+    bool isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const;
     /** whether the entity's bounding box intersects with visible portion of graphic view */
     void draw(RS_Painter* painter, RS_GraphicView* view, double& patternOffset) override;
 
@@ -418,6 +418,7 @@ void RS_MText::update() {
                                     font->getLetterList(), RS2::NoUpdate);
 
                     RS_Insert* letter = new RS_Insert(this, d);
+                    letter->setGlyph(font->findGlyph(letterText));
                     RS_Vector letterWidth;
                     letter->setPen(RS_Pen(RS2::FlagInvalid));
                     letter->setLayer(NULL);
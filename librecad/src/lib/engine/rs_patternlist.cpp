@@ -74,6 +74,7 @@ RS_Pattern* RS_PatternList::requestPattern(const QString& name) {
     QString name2 = name.toLower();
 
 	RS_DEBUG->print("name2: %s", name2.toLatin1().data());
+	std::lock_guard<std::mutex> lock(loadMutex);
 	if (patterns.count(name2)) {
 		if (!patterns[name2]) {
 			RS_Pattern* p = new RS_Pattern(name2);
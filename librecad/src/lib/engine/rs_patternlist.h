@@ -30,6 +30,7 @@
 
 #include<map>
 #include<memory>
+#include<mutex>
 
 class RS_Pattern;
 class QString;
@@ -89,6 +90,8 @@ public:
 private:
     //! patterns in the graphic
 	PTN_MAP patterns;
+	//! patterns are loaded on request, also from worker threads
+	std::mutex loadMutex;
 };
 
 #endif
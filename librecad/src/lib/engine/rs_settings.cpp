@@ -30,6 +30,7 @@
 
 RS_Settings* RS_Settings::uniqueInstance = nullptr;
 bool RS_Settings::save_is_allowed = true;
+thread_local QString RS_Settings::group;
 
 RS_Settings::RS_Settings():
 	initialized(false)
@@ -94,6 +95,7 @@ bool RS_Settings::writeEntry(const QString& key, double value) {
 }
 
 bool RS_Settings::writeEntry(const QString& key, const QVariant& value) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
 	QSettings s(companyKey, appKey);
     // RVT_PORT not supported anymore s.insertSearchPath(QSettings::Windows, companyKey);
 
@@ -106,6 +108,7 @@ bool RS_Settings::writeEntry(const QString& key, const QVariant& value) {
 QString RS_Settings::readEntry(const QString& key,
                                  const QString& def,
                                  bool* ok) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
 	
     // lookup:
     QVariant ret = readEntryCache(key);
@@ -129,6 +132,7 @@ QString RS_Settings::readEntry(const QString& key,
 QByteArray RS_Settings::readByteArrayEntry(const QString& key,
                     const QString& def,
                     bool* ok) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     QVariant ret = readEntryCache(key);
     if (!ret.isValid()) {
 
@@ -149,6 +153,7 @@ QByteArray RS_Settings::readByteArrayEntry(const QString& key,
 
 int RS_Settings::readNumEntry(const QString& key, int def)
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
 	QVariant value = readEntryCache(key);
 	if (!value.isValid())
 	{
@@ -174,6 +179,7 @@ void RS_Settings::addToCache(const QString& key, const QVariant& value) {
 
 void RS_Settings::clear_all()
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     QSettings s(companyKey, appKey);
     s.clear();
     save_is_allowed = false;
@@ -181,6 +187,7 @@ void RS_Settings::clear_all()
 
 void RS_Settings::clear_geometry()
 {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
     QSettings s(companyKey, appKey);
     s.remove("/Geometry");
     save_is_allowed = false;
@@ -30,6 +30,7 @@
 
 #include <QString>
 #include <map>
+#include <mutex>
 
 class QVariant;
 
@@ -61,6 +62,8 @@ namespace Colors
  * work as one would expect. That's why this class overwrites
  * most of the default behaviour.
  * 
+ * Settings can be read and written from several threads, every
+ * thread has its own current group.
  */
 class RS_Settings {
 
@@ -110,7 +113,10 @@ protected:
 	std::map<QString, QVariant> cache;
     QString companyKey;
     QString appKey;
-    QString group;
+    //! current group of the calling thread
+    static thread_local QString group;
+    //! guards the cache and the settings storage
+    std::recursive_mutex mutex;
     bool initialized;
 };
 
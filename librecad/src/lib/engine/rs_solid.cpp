@@ -34,6 +34,7 @@
 #include "rs_painter.h"
 #include "rs_information.h"
 #include "rs_debug.h"
+#include "lc_rect.h"
 
 RS_SolidData::RS_SolidData():
     corner{{RS_Vector(false), RS_Vector(false), RS_Vector(false), RS_Vector(false)}}
@@ -165,86 +166,20 @@ RS_Vector RS_Solid::getNearestEndpoint(const RS_Vector& coord, double* dist /*=
 
 bool RS_Solid::isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const
 {
-    RS_Vector vBL;
-    RS_Vector vTR;
-    RS_VectorSolutions sol;
-
-    //sort input vectors to BottomLeft & TopRight
-    if (v1.x < v2.x) {
-        vBL.x = v1.x;
-        vTR.x = v2.x;
-    }
-    else {
-        vBL.x = v2.x;
-        vTR.x = v1.x;
-    }
-    if (v1.y < v2.y) {
-        vBL.y = v1.y;
-        vTR.y = v2.y;
-    }
-    else {
-        vBL.y = v2.y;
-        vTR.y = v1.y;
-    }
+    LC_Rect const window{v1, v2};
 
     //Check if entity is out of window
-    if (getMin().x > vTR.x
-        || getMax().x < vBL.x
-        || getMin().y > vTR.y
-        || getMax().y < vBL.y) {
+    if (!window.intersects(LC_Rect{getMin(), getMax()})) {
         return false;
     }
 
-    std::vector<RS_Line> border;
-    border.emplace_back( data.corner[0], data.corner[1]);
-    border.emplace_back( data.corner[1], data.corner[2]);
-    if (isTriangle()) {
-        border.emplace_back( data.corner[2], data.corner[0]);
-    }
-    else {
-        border.emplace_back( data.corner[2], data.corner[3]);
-        border.emplace_back( data.corner[3], data.corner[0]);
-    }
-
-    //Find crossing edge
-    if (getMax().x > vBL.x
-        && getMin().x < vBL.x) {    //left
-        RS_Line edge {vBL, {vBL.x, vTR.y}};
-        for (auto const& line: border) {
-            sol = RS_Information::getIntersection(&edge, &line, true);
-            if (sol.hasValid()) {
-                return true;
-            }
-        }
-    }
-    if (getMax().x > vTR.x
-        && getMin().x < vTR.x) {    //right
-        RS_Line edge {{vTR.x, vBL.y}, vTR};
-        for (auto const& line: border) {
-            sol = RS_Information::getIntersection(&edge, &line, true);
-            if (sol.hasValid()) {
-                return true;
-            }
-        }
-    }
-    if (getMax().y > vBL.y
-        && getMin().y < vBL.y) {    //bottom
-        RS_Line edge {vBL, {vTR.x, vBL.y}};
-        for(auto const& line: border) {
-            sol = RS_Information::getIntersection(&edge, &line, true);
-            if (sol.hasValid()) {
-                return true;
-            }
-        }
-    }
-    if(getMax().y > vTR.y
-       && getMin().y < vTR.y) { //top
-        RS_Line edge {{vBL.x, vTR.y}, vTR};
-        for(auto const& line: border) {
-            sol = RS_Information::getIntersection(&edge, &line, true);
-            if (sol.hasValid()) {
-                return true;
-            }
+    //Find an edge with a point in the window
+    int const corners = isTriangle() ? 3 : 4;
+    for (int i = 0; i < corners; ++i) {
+        double t0 = 0.;
+        double t1 = 1.;
+        if (window.clipLine(data.corner[i], data.corner[(i + 1) % corners], t0, t1)) {
+            return true;
         }
     }
 
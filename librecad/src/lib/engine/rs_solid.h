@@ -141,7 +141,7 @@ public:
     void calculateBorders() override;
 
     /** Check if is intersected by v1, v2 window.
-    * @return true if is crossed false otherwise.
+    * @return true if an edge has a point in the window, false otherwise.
     **/
     bool isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const;
 
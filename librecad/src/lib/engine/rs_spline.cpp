@@ -24,8 +24,10 @@
 **
 **********************************************************************/
 
+#include<algorithm>
 #include<iostream>
 #include<cmath>
+#include<limits>
 #include<numeric>
 
 #include "rs_spline.h"
@@ -36,7 +38,14 @@
 #include "rs_graphicview.h"
 #include "rs_painter.h"
 #include "rs_graphic.h"
+#include "lc_rect.h"
 
+namespace {
+//! curveBucket of a spline without curve points
+constexpr int noCurve = std::numeric_limits<int>::min();
+//! bisections of one parameter interval by RS_Spline::tessellate()
+constexpr int maxBisections = 10;
+}
 
 RS_SplineData::RS_SplineData(int _degree, bool _closed):
 	degree(_degree)
@@ -68,8 +77,7 @@ std::ostream& operator << (std::ostream& os, const RS_SplineData& ld) {
  */
 RS_Spline::RS_Spline(RS_EntityContainer* parent,
                      const RS_SplineData& d)
-        :RS_EntityContainer(parent), data(d) {
-    calculateBorders();
+        :RS_EntityContainer(parent), data(d), curveBucket(noCurve) {
 }
 
 RS_Entity* RS_Spline::clone() const{
@@ -83,17 +91,11 @@ RS_Entity* RS_Spline::clone() const{
 
 
 void RS_Spline::calculateBorders() {
-    /*minV = RS_Vector::minimum(data.startpoint, data.endpoint);
-    maxV = RS_Vector::maximum(data.startpoint, data.endpoint);
-
-    QList<RS_Vector>::iterator it;
-    for (it = data.controlPoints.begin();
-    it!=data.controlPoints.end(); ++it) {
-
-    minV = RS_Vector::minimum(*it, minV);
-    maxV = RS_Vector::maximum(*it, maxV);
-}
-    */
+	resetBorders();
+	for (const RS_Vector& vp: getCurvePoints()) {
+		minV = RS_Vector::minimum(vp, minV);
+		maxV = RS_Vector::maximum(vp, maxV);
+	}
 }
 
 
@@ -158,6 +160,9 @@ void RS_Spline::update() {
     RS_DEBUG->print("RS_Spline::update");
 
     clear();
+    curvePoints.clear();
+    curveBucket = noCurve;
+    geometryPoints.clear();
 
     if (isUndone()) {
         return;
@@ -173,32 +178,67 @@ void RS_Spline::update() {
         return;
     }
 
-    resetBorders();
+    calculateBorders();
+}
 
-	std::vector<RS_Vector> tControlPoints = data.controlPoints;
 
-    if (data.closed) {
-		for (size_t i=0; i<data.degree; ++i) {
-			tControlPoints.push_back(data.controlPoints.at(i));
-        }
-    }
+double RS_Spline::getControlSize() const {
+	if (data.controlPoints.empty()) {
+		return 0.;
+	}
+	RS_Vector vMin = data.controlPoints.front();
+	RS_Vector vMax = vMin;
+	for (const RS_Vector& vp: data.controlPoints) {
+		vMin = RS_Vector::minimum(vp, vMin);
+		vMax = RS_Vector::maximum(vp, vMax);
+	}
+	return vMin.distanceTo(vMax);
+}
 
-	const size_t npts = tControlPoints.size();
-    // order:
-	const size_t  k = data.degree+1;
-    // resolution:
-	const size_t  p1 = getGraphicVariableInt("$SPLINESEGS", 8) * npts;
-
-	std::vector<double> h(npts+1, 1.);
-	std::vector<RS_Vector> p(p1, {0., 0.});
-    if (data.closed) {
-		rbsplinu(npts,k,p1,tControlPoints,h,p);
-    } else {
-		rbspline(npts,k,p1,tControlPoints,h,p);
-    }
 
-	RS_Vector prev{};
-	for (auto const& vp: p) {
+const std::vector<RS_Vector>& RS_Spline::getCurvePoints(double tolerance) const {
+	// below a millionth of the size the polygon only grows
+	double const size = std::max(getControlSize(), RS_TOLERANCE);
+	if (!(tolerance > size*1.0e-6)) {
+		tolerance = size*1.0e-6;
+	}
+	tolerance = std::min(tolerance, size);
+
+	int const bucket = static_cast<int>(std::floor(std::log2(tolerance)));
+	if (bucket != curveBucket) {
+		tessellate(std::ldexp(1., bucket), curvePoints);
+		curveBucket = bucket;
+	}
+	return curvePoints;
+}
+
+
+const std::vector<RS_Vector>& RS_Spline::getCurvePoints() const {
+	if (geometryPoints.empty()) {
+		tessellate(std::max(getControlSize(), RS_TOLERANCE)*1.0e-4, geometryPoints);
+	}
+	return geometryPoints;
+}
+
+
+RS_Entity* RS_Spline::firstEntity(RS2::ResolveLevel level) {
+	addSegments();
+	return RS_EntityContainer::firstEntity(level);
+}
+
+
+RS_Entity* RS_Spline::lastEntity(RS2::ResolveLevel level) {
+	addSegments();
+	return RS_EntityContainer::lastEntity(level);
+}
+
+
+void RS_Spline::addSegments() {
+	if (!isEmpty()) {
+		return;
+	}
+	RS_Vector prev{false};
+	for (auto const& vp: getCurvePoints()) {
 		if (prev.valid) {
 			RS_Line* line = new RS_Line{this, prev, vp};
 			line->setLayer(nullptr);
@@ -206,19 +246,20 @@ void RS_Spline::update() {
 			addEntity(line);
 		}
 		prev = vp;
-		minV = RS_Vector::minimum(prev, minV);
-		maxV = RS_Vector::maximum(prev, maxV);
 	}
 }
 
+
 RS_Vector RS_Spline::getStartpoint() const {
-   if (data.closed) return RS_Vector(false);
-   return static_cast<RS_Line*>(const_cast<RS_Spline*>(this)->firstEntity())->getStartpoint();
+	const auto& points = getCurvePoints();
+	if (data.closed || points.empty()) return RS_Vector(false);
+	return points.front();
 }
 
 RS_Vector RS_Spline::getEndpoint() const {
-   if (data.closed) return RS_Vector(false);
-   return static_cast<RS_Line*>(const_cast<RS_Spline*>(this)->lastEntity())->getEndpoint();
+	const auto& points = getCurvePoints();
+	if (data.closed || points.empty()) return RS_Vector(false);
+	return points.back();
 }
 
 
@@ -226,7 +267,7 @@ RS_Vector RS_Spline::getNearestEndpoint(const RS_Vector& coord,
                                         double* dist)const {
     double minDist = RS_MAXDOUBLE;
     RS_Vector ret(false);
-    if(! data.closed) { // no endpoint for closed spline
+    if(! data.closed && !getCurvePoints().empty()) { // no endpoint for closed spline
        RS_Vector vp1(getStartpoint());
        RS_Vector vp2(getEndpoint());
        double d1( (coord-vp1).squared());
@@ -238,14 +279,6 @@ RS_Vector RS_Spline::getNearestEndpoint(const RS_Vector& coord,
            ret=vp2;
            minDist=sqrt(d2);
        }
-//        for (int i=0; i<data.controlPoints.count(); i++) {
-//            d = (data.controlPoints.at(i)).distanceTo(coord);
-
-//            if (d<minDist) {
-//                minDist = d;
-//                ret = data.controlPoints.at(i);
-//            }
-//        }
     }
 	if (dist) {
         *dist = minDist;
@@ -255,13 +288,73 @@ RS_Vector RS_Spline::getNearestEndpoint(const RS_Vector& coord,
 
 
 
-/*
-// The default implementation of RS_EntityContainer is inaccurate but
-//   has to do for now..
 RS_Vector RS_Spline::getNearestPointOnEntity(const RS_Vector& coord,
-        bool onEntity, double* dist, RS_Entity** entity) {
+		bool /*onEntity*/, double* dist, RS_Entity** entity) const {
+	if (entity) {
+		*entity = const_cast<RS_Spline*>(this);
+	}
+	double minDist = RS_MAXDOUBLE;
+	RS_Vector closestPoint(false);
+	const auto& points = getCurvePoints();
+	for (size_t i = 1; i < points.size(); ++i) {
+		RS_Vector const dp = points[i] - points[i-1];
+		double const l2 = dp.squared();
+		double const t = l2 > RS_TOLERANCE2 ? RS_Vector::dotP(coord - points[i-1], dp)/l2 : 0.;
+		RS_Vector const p = points[i-1] + dp*std::min(1., std::max(0., t));
+		double const d = p.distanceTo(coord);
+		if (d < minDist) {
+			minDist = d;
+			closestPoint = p;
+		}
+	}
+	if (dist) {
+		*dist = minDist;
+	}
+	return closestPoint;
+}
+
+
+/**
+ * Resolving levels return a segment of the curve, the segments are
+ * created for that.
+ */
+double RS_Spline::getDistanceToPoint(const RS_Vector& coord,
+									 RS_Entity** entity,
+									 RS2::ResolveLevel level,
+									 double solidDist) const {
+	if (level != RS2::ResolveNone) {
+		const_cast<RS_Spline*>(this)->addSegments();
+		return RS_EntityContainer::getDistanceToPoint(coord, entity, level,
+													  solidDist);
+	}
+	double dist = RS_MAXDOUBLE;
+	getNearestPointOnEntity(coord, true, &dist, entity);
+	return dist;
+}
+
+
+double RS_Spline::getLength() const {
+	const auto& points = getCurvePoints();
+	double length = 0.;
+	for (size_t i = 1; i < points.size(); ++i) {
+		length += points[i-1].distanceTo(points[i]);
+	}
+	return length;
+}
+
+
+bool RS_Spline::isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const {
+	LC_Rect const window{v1, v2};
+	const auto& points = getCurvePoints();
+	for (size_t i = 1; i < points.size(); ++i) {
+		double t0 = 0.;
+		double t1 = 1.;
+		if (window.clipLine(points[i-1], points[i], t0, t1)) {
+			return true;
+		}
+	}
+	return false;
 }
-*/
 
 
 
@@ -306,6 +399,12 @@ void RS_Spline::move(const RS_Vector& offset) {
 	for (RS_Vector& vp: data.controlPoints) {
 		vp.move(offset);
     }
+	for (RS_Vector& vp: curvePoints) {
+		vp.move(offset);
+	}
+	for (RS_Vector& vp: geometryPoints) {
+		vp.move(offset);
+	}
 //    update();
 }
 
@@ -318,10 +417,17 @@ void RS_Spline::rotate(const RS_Vector& center, const double& angle) {
 
 
 void RS_Spline::rotate(const RS_Vector& center, const RS_Vector& angleVector) {
-	RS_EntityContainer::rotate(center, angleVector);
 	for (RS_Vector& vp: data.controlPoints) {
 		vp.rotate(center, angleVector);
 	}
+	for (RS_Vector& vp: curvePoints) {
+		vp.rotate(center, angleVector);
+	}
+	for (RS_Vector& vp: geometryPoints) {
+		vp.rotate(center, angleVector);
+	}
+	// the borders follow the rotated curve points
+	RS_EntityContainer::rotate(center, angleVector);
 //    update();
 }
 
@@ -357,33 +463,39 @@ void RS_Spline::moveRef(const RS_Vector& ref, const RS_Vector& offset) {
 
 void RS_Spline::revertDirection() {
 	std::reverse(data.controlPoints.begin(), data.controlPoints.end());
+	std::reverse(curvePoints.begin(), curvePoints.end());
+	std::reverse(geometryPoints.begin(), geometryPoints.end());
 }
 
 
 
 
+/**
+ * Draws the curve points of the zoom of the view, one line at a time
+ * to continue the line pattern along the curve.
+ */
 void RS_Spline::draw(RS_Painter* painter, RS_GraphicView* view, double& /*patternOffset*/) {
 
 	if (!(painter && view)) {
         return;
     }
 
+	// a chord error of half a pixel is not visible
+	const auto& points = getCurvePoints(0.5/view->getFactor().x);
+	if (points.size() < 2) {
+		return;
+	}
 
-    RS_Entity* e=firstEntity(RS2::ResolveNone);
-	if (e) {
-        RS_Pen p=this->getPen(true);
-        e->setPen(p);
-        double patternOffset(0.0);
-        view->drawEntity(painter, e, patternOffset);
-        //RS_DEBUG->print("offset: %f\nlength was: %f", offset, e->getLength());
-
-        e = nextEntity(RS2::ResolveNone);
-		while(e) {
-            view->drawEntityPlain(painter, e, patternOffset);
-            e = nextEntity(RS2::ResolveNone);
-            //RS_DEBUG->print("offset: %f\nlength was: %f", offset, e->getLength());
-        }
-    }
+	RS_Line segment{this, points.front(), points.front()};
+	segment.setLayer(nullptr);
+	segment.setPen(getPen(true));
+	segment.setSelected(isSelected());
+	double patternOffset(0.0);
+	for (size_t i = 1; i < points.size(); ++i) {
+		segment.setStartpoint(points[i-1]);
+		segment.setEndpoint(points[i]);
+		view->drawEntityPlain(painter, &segment, patternOffset);
+	}
 }
 
 
@@ -552,39 +664,6 @@ std::vector<double> rbasis(int c, double t, int npts,
 }
 
 
-/**
- * Generates a rational B-spline curve using a uniform open knot vector.
- */
-void RS_Spline::rbspline(size_t npts, size_t k, size_t p1,
-                         const std::vector<RS_Vector>& b,
-                         const std::vector<double>& h,
-                         std::vector<RS_Vector>& p) const{
-	size_t const nplusc = npts + k;
-
-	// generate the open knot vector
-	auto const x = knot(npts, k);
-
-    // calculate the points on the rational B-spline curve
-    double t {x[0]};
-    double const step {(x[nplusc-1] - t) / (p1-1)};
-
-	for (auto& vp: p) {
-		if (x[nplusc-1] - t < 5e-6) t = x[nplusc-1];
-
-        // generate the basis function for this value of t
-		auto const nbasis = rbasis(k, t, npts, x, h);
-
-        // generate a point on the curve
-		for (size_t i = 0; i < npts; i++)
-			vp += b[i] * nbasis[i];
-
-		t += step;
-    }
-
-}
-
-
-
 std::vector<double> RS_Spline::knotu(size_t num, size_t order) const{
 	if (data.knotslist.size() == num + order) {
 		//use custom knot vector
@@ -597,31 +676,70 @@ std::vector<double> RS_Spline::knotu(size_t num, size_t order) const{
 
 
 
-void RS_Spline::rbsplinu(size_t npts, size_t k, size_t p1,
-                         const std::vector<RS_Vector>& b,
-                         const std::vector<double>& h,
-                         std::vector<RS_Vector>& p) const{
-	size_t const nplusc = npts + k;
-
-	/* generate the periodic knot vector */
-	std::vector<double> const x = knotu(npts, k);
-
-    /*    calculate the points on the rational B-spline curve */
-	double t = k-1;
-	double const step = double(npts - k + 1)/(p1 - 1);
-
-	for (auto& vp: p) {
-		if (x[nplusc-1] - t < 5e-6) t = x[nplusc-1];
+void RS_Spline::tessellate(double tolerance, std::vector<RS_Vector>& points) const {
+	points.clear();
+	if (data.degree<1 || data.degree>3
+			|| data.controlPoints.size() < data.degree+1) {
+		return;
+	}
 
-		/* generate the basis function for this value of t */
+	std::vector<RS_Vector> b = data.controlPoints;
+	if (data.closed) {
+		for (size_t i=0; i<data.degree; ++i) {
+			b.push_back(data.controlPoints.at(i));
+		}
+	}
+	int const npts = b.size();
+	// order:
+	int const k = data.degree+1;
+	std::vector<double> const h(npts+1, 1.);
+	// periodic splines run over the knots between the first and the
+	// last degree knots of the periodic knot vector
+	std::vector<double> const x = data.closed ? knotu(npts, k) : knot(npts, k);
+	double const tStart = data.closed ? k-1 : x[0];
+	double const tEnd = data.closed ? npts : x[npts+k-1];
+
+	auto const pointAt = [&](double t) {
+		if (tEnd - t < 5e-6) t = tEnd;
 		auto const nbasis = rbasis(k, t, npts, x, h);
-		/* generate a point on the curve, for x, y, z */
-		for (size_t i = 0; i < npts; i++)
+		RS_Vector vp{0., 0.};
+		for (int i = 0; i < npts; i++)
 			vp += b[i] * nbasis[i];
-
-		t += step;
-    }
-
+		return vp;
+	};
+
+	struct Sample {
+		double t;
+		RS_Vector p;
+		int bisections;
+	};
+
+	// some samples per knot span, a curve turning back within one
+	// interval would not move the middle of the interval off its chord
+	int const intervals = 4*(npts - k + 1);
+	double t0 = tStart;
+	RS_Vector p0 = pointAt(t0);
+	points.push_back(p0);
+	std::vector<Sample> samples;
+	for (int i = 1; i <= intervals; ++i) {
+		double const t = tStart + (tEnd - tStart)*i/intervals;
+		samples.push_back({t, pointAt(t), 0});
+		while (!samples.empty()) {
+			Sample& s1 = samples.back();
+			double const tm = 0.5*(t0 + s1.t);
+			RS_Vector const pm = pointAt(tm);
+			if (s1.bisections < maxBisections
+					&& pm.distanceTo((p0 + s1.p)*0.5) > tolerance) {
+				++s1.bisections;
+				samples.push_back({tm, pm, s1.bisections});
+				continue;
+			}
+			t0 = s1.t;
+			p0 = s1.p;
+			points.push_back(p0);
+			samples.pop_back();
+		}
+	}
 }
 
 
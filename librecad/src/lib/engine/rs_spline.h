@@ -118,10 +118,39 @@ public:
     /** Sets the endpoint */
 	void update() override;
 
+	/**
+	 * @return Points of the curve for drawing. The chord error of the
+	 * polygon stays below the tolerance, rounded down to a power of two.
+	 * The points are kept until the next update(), so views zooming within
+	 * a factor of two share them.
+	 */
+	const std::vector<RS_Vector>& getCurvePoints(double tolerance) const;
+	/**
+	 * @return Points of the curve with a chord error relative to the size
+	 * of the spline, independent of any view. Used for snapping, borders,
+	 * intersections and export.
+	 */
+	const std::vector<RS_Vector>& getCurvePoints() const;
+
+	/**
+	 * The segments of the curve are only created as entities when they
+	 * are iterated, e.g. to intersect them.
+	 */
+	RS_Entity* firstEntity(RS2::ResolveLevel level=RS2::ResolveNone) override;
+	RS_Entity* lastEntity(RS2::ResolveLevel level=RS2::ResolveNone) override;
+
 	RS_Vector getNearestEndpoint(const RS_Vector& coord,
 										 double* dist = nullptr)const override;
-	//RS_Vector getNearestPointOnEntity(const RS_Vector& coord,
-	//        bool onEntity=true, double* dist = nullptr, RS_Entity** entity=nullptr);
+	RS_Vector getNearestPointOnEntity(const RS_Vector& coord,
+			bool onEntity=true, double* dist = nullptr,
+			RS_Entity** entity=nullptr) const override;
+	double getDistanceToPoint(const RS_Vector& coord,
+			RS_Entity** entity,
+			RS2::ResolveLevel level=RS2::ResolveNone,
+			double solidDist = RS_MAXDOUBLE) const override;
+	double getLength() const override;
+	/** @return true, if the curve crosses the window */
+	bool isInCrossWindow(const RS_Vector& v1, const RS_Vector& v2) const;
 	RS_Vector getNearestCenter(const RS_Vector& coord,
 									   double* dist = nullptr)const override;
 	RS_Vector getNearestMiddle(const RS_Vector& coord,
@@ -152,19 +181,26 @@ public:
 
 private:
 		std::vector<double> knot(size_t num, size_t order) const;
-		void rbspline(size_t npts, size_t k, size_t p1,
-		              const std::vector<RS_Vector>& b,
-		              const std::vector<double>& h,
-		              std::vector<RS_Vector>& p) const;
-
 		std::vector<double> knotu(size_t num, size_t order) const;
-		void rbsplinu(size_t npts, size_t k, size_t p1,
-		              const std::vector<RS_Vector>& b,
-		              const std::vector<double>& h,
-		              std::vector<RS_Vector>& p) const;
+		/**
+		 * Samples the curve by bisecting parameter intervals until the
+		 * curve point in the middle of an interval is closer to the middle
+		 * of its chord than the tolerance.
+		 */
+		void tessellate(double tolerance, std::vector<RS_Vector>& points) const;
+		/** @return diagonal of the box of the control points */
+		double getControlSize() const;
+		/** creates the line entities of the curve points once */
+		void addSegments();
 
 protected:
 		RS_SplineData data;
+		//! points of the curve for drawing, see getCurvePoints(double)
+		mutable std::vector<RS_Vector> curvePoints;
+		//! the tolerance of curvePoints is 2^curveBucket
+		mutable int curveBucket;
+		//! points of the curve for geometry, see getCurvePoints()
+		mutable std::vector<RS_Vector> geometryPoints;
 }
 ;
 
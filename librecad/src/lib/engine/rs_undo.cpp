@@ -29,7 +29,9 @@
 #include "qc_applicationwindow.h"
 #include "rs_undocycle.h"
 #include "rs_undo.h"
+#include "lc_undotransform.h"
 #include "rs_debug.h"
+#include "rs_settings.h"
 
 /**
  * @return Number of Cycles that can be undone.
@@ -78,12 +80,79 @@ void RS_Undo::addUndoCycle(std::shared_ptr<RS_UndoCycle> const& i) {
 
 //    undoList.insert(++undoPointer, i);
 	undoList.insert(undoList.begin() + (++undoPointer), i);
+	for (RS_Undoable* u: i->getUndoables()) {
+		++cycleCounts[u];
+	}
+	for (auto const& t: i->getTransforms()) {
+		for (RS_Entity* e: t->getEntities()) {
+			++cycleCounts[e];
+		}
+	}
+	undoableCount += i->size();
 
     RS_DEBUG->print("RS_Undo::addUndoCycle: ok");
 }
 
 
 
+void RS_Undo::removeUndoCycles(size_t first, size_t last)
+{
+	std::vector<RS_Undoable*> obsolete;
+	auto release = [this, &obsolete](RS_Undoable* u) {
+		auto it = cycleCounts.find(u);
+		if (it == cycleCounts.end() || --it->second > 0) {
+			return;
+		}
+		cycleCounts.erase(it);
+		// undoables which are alive stay in the document
+		if (u->isUndone()) {
+			obsolete.push_back(u);
+		}
+	};
+	for (size_t i = first; i < last; ++i) {
+		undoableCount -= undoList[i]->size();
+		for (RS_Undoable* u: undoList[i]->getUndoables()) {
+			release(u);
+		}
+		for (auto const& t: undoList[i]->getTransforms()) {
+			for (RS_Entity* e: t->getEntities()) {
+				release(e);
+			}
+		}
+	}
+	undoList.erase(undoList.begin() + first, undoList.begin() + last);
+
+	for (RS_Undoable* u: obsolete) {
+		removeUndoable(u);
+	}
+}
+
+
+
+void RS_Undo::trimUndoList()
+{
+	RS_SETTINGS->beginGroup("/Defaults");
+	size_t maxSteps = RS_SETTINGS->readNumEntry("/MaxUndoSteps", 0);
+	size_t maxUndoables = 1000 * (size_t) RS_SETTINGS->readNumEntry("/UndoBudget", 1000);
+	RS_SETTINGS->endGroup();
+
+	// only cycles which are not undone can be dropped, the last one is kept
+	size_t drop = 0;
+	size_t count = undoableCount;
+	while ((int) drop < undoPointer
+		   && ((maxSteps > 0 && undoList.size() - drop > maxSteps)
+			   || (maxUndoables > 0 && count > maxUndoables))) {
+		count -= undoList[drop++]->size();
+	}
+	if (drop > 0) {
+		RS_DEBUG->print("RS_Undo::trimUndoList: dropping %d cycles", (int) drop);
+		removeUndoCycles(0, drop);
+		undoPointer -= (int) drop;
+	}
+}
+
+
+
 /**
  * Starts a new cycle for one undo step. Every undoable that is
  * added after calling this method goes into this cycle.
@@ -99,37 +168,7 @@ void RS_Undo::startUndoCycle()
     // if there are undo cycles behind undoPointer
     // remove obsolete entities and undoCycles
     if (undoList.size() > removePointer) {
-        // collect remaining undoables
-        std::list<RS_Undoable*> keep;
-        for (auto it = undoList.begin(); it != undoList.begin() + removePointer; ++it) {
-            for (auto u: (*it)->getUndoables()){
-                keep.push_back( u);
-            }
-        }
-        keep.unique();
-
-        // collect obsolete undoables
-        std::list<RS_Undoable*> obsolete;
-        for (auto it = undoList.begin() + removePointer; it != undoList.end(); ++it) {
-            for (auto u: (*it)->getUndoables()){
-                obsolete.push_back( u);
-            }
-        }
-        // unique() only works correct on sorted list!
-        obsolete.sort();
-        obsolete.unique();
-
-        // delete obsolte undoables which are not in keep list
-        for (auto it = obsolete.begin(); it != obsolete.end(); ++it) {
-            if (keep.end() == std::find( keep.begin(), keep.end(), *it)) {
-                removeUndoable( *it);
-            }
-        }
-
-        // clean up obsolete undoCycles
-        while (undoList.size() > removePointer) {
-            undoList.pop_back();
-        }
+        removeUndoCycles(removePointer, undoList.size());
     }
 
     // alloc new undoCycle
@@ -154,6 +193,20 @@ void RS_Undo::addUndoable(RS_Undoable* u) {
 
 
 
+/**
+ * Adds a transform record to the current undo cycle.
+ */
+void RS_Undo::addTransform(std::unique_ptr<LC_UndoTransform> t) {
+    if( nullptr == currentCycle) {
+        RS_DEBUG->print( RS_Debug::D_CRITICAL, "RS_Undo::%s(): invalid currentCycle, possibly missing startUndoCycle()", __func__);
+        return;
+    }
+
+    currentCycle->addTransform(std::move(t));
+}
+
+
+
 /**
  * Ends the current undo cycle.
  */
@@ -174,6 +227,8 @@ void RS_Undo::endUndoCycle()
     if (hasUndoable()) {
         // only keep the undoCycle, when it contains undoables
         addUndoCycle(currentCycle);
+        storeUndoables(currentCycle->getUndoables());
+        trimUndoList();
     }
 
     setGUIButtons();
@@ -193,7 +248,9 @@ bool RS_Undo::undo() {
 	std::shared_ptr<RS_UndoCycle> uc = undoList[undoPointer--];
 
 	setGUIButtons();
+	restoreUndoables(uc->getUndoables());
 	uc->changeUndoState();
+	storeUndoables(uc->getUndoables());
 	return true;
 }
 
@@ -209,7 +266,9 @@ bool RS_Undo::redo() {
 		std::shared_ptr<RS_UndoCycle> uc = undoList[++undoPointer];
 
 		setGUIButtons();
+		restoreUndoables(uc->getUndoables());
 		uc->changeUndoState();
+		storeUndoables(uc->getUndoables());
 		return true;
 	}
     return false;
@@ -30,8 +30,11 @@
 #define RS_UNDO_H
 
 #include <memory>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
+class LC_UndoTransform;
 class RS_UndoCycle;
 class RS_Undoable;
 
@@ -39,6 +42,10 @@ class RS_Undoable;
  * Undo / redo functionality. The internal undo list consists of
  * RS_UndoCycle entries.
  *
+ * The list is bounded by the settings /Defaults/MaxUndoSteps (number of
+ * cycles) and /Defaults/UndoBudget (thousands of undoables in all cycles),
+ * 0 means no limit. The oldest cycles are dropped when a limit is exceeded.
+ *
  * @see RS_UndoCycle
  * @author Andrew Mustun
  */
@@ -58,6 +65,11 @@ public:
 
     virtual void startUndoCycle();
     virtual void addUndoable(RS_Undoable* u);
+    /**
+     * Adds a record of entities transformed in place to the current
+     * undo cycle. The transform was applied already.
+     */
+    void addTransform(std::unique_ptr<LC_UndoTransform> t);
     virtual void endUndoCycle();
 
     /**
@@ -77,9 +89,31 @@ public:
 
     static bool test();
 
+protected:
+    /**
+     * Called before the undo state of the given undoables is changed by
+     * undo() or redo(). Undoables moved away by storeUndoables() must be
+     * put back here. Does nothing by default.
+     */
+    virtual void restoreUndoables(const std::set<RS_Undoable*>& /*undoables*/) {}
+    /**
+     * Called after the undo state of the given undoables was changed by
+     * endUndoCycle(), undo() or redo(). Implementations can move the
+     * undone ones out of the way until they are restored or removed.
+     * Does nothing by default.
+     */
+    virtual void storeUndoables(const std::set<RS_Undoable*>& /*undoables*/) {}
+
 private:
 
 	void addUndoCycle(std::shared_ptr<RS_UndoCycle> const& i);
+	/**
+	 * Removes the cycles [first, last) from the undo list. Undone
+	 * undoables which are not part of any other cycle are removed.
+	 */
+	void removeUndoCycles(size_t first, size_t last);
+	/** drops the oldest cycles exceeding the undo limits */
+	void trimUndoList();
     //! List of undo list items. every item is something that can be undone.
 	std::vector<std::shared_ptr<RS_UndoCycle>> undoList;
 
@@ -97,6 +131,12 @@ private:
     std::shared_ptr<RS_UndoCycle> currentCycle {nullptr};
 
     int refCount {0}; ///< reference counter for nested start/end calls
+
+    //! number of cycles in the undo list containing an undoable, either
+    //! as undoable or as transformed entity
+    std::unordered_map<RS_Undoable*, int> cycleCounts;
+    //! sum of the sizes of the cycles in the undo list
+    size_t undoableCount {0};
 };
 
 
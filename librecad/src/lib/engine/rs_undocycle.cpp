@@ -28,6 +28,9 @@
 
 #include <ostream>
 #include"rs_undocycle.h"
+#include "lc_undotransform.h"
+
+RS_UndoCycle::~RS_UndoCycle() = default;
 
 /**
  * Adds an Undoable to this Undo Cycle. Every Cycle can contain one or
@@ -50,18 +53,41 @@ void RS_UndoCycle::removeUndoable(RS_Undoable* u) {
     undoables.erase(u);
 }
 
+void RS_UndoCycle::addTransform(std::unique_ptr<LC_UndoTransform> t) {
+    if (!t || t->isEmpty())
+        return;
+
+    transforms.push_back(std::move(t));
+}
+
 /**
- * Return number of undoables in cycle
+ * Return number of undoables and transformed entities in cycle,
+ * each entity of a transform record counts like an undoable
  */
 size_t RS_UndoCycle::size()
 {
-    return undoables.size();
+    size_t ret = undoables.size();
+    for (auto const& t: transforms) {
+        ret += t->getEntities().size();
+    }
+    return ret;
 }
 
 void RS_UndoCycle::changeUndoState()
 {
 	for (RS_Undoable* u: undoables)
 		u->changeUndoState();
+
+	if (transforms.empty())
+		return;
+	// undo the last transform first
+	if (transforms.front()->isUndone()) {
+		for (auto& t: transforms)
+			t->changeUndoState();
+	} else {
+		for (auto it = transforms.rbegin(); it != transforms.rend(); ++it)
+			(*it)->changeUndoState();
+	}
 }
 
 std::set<RS_Undoable*> const& RS_UndoCycle::getUndoables() const
@@ -69,6 +95,11 @@ std::set<RS_Undoable*> const& RS_UndoCycle::getUndoables() const
     return undoables;
 }
 
+std::vector<std::unique_ptr<LC_UndoTransform>> const& RS_UndoCycle::getTransforms() const
+{
+    return transforms;
+}
+
 
 std::ostream& operator << (std::ostream& os,
 								  RS_UndoCycle& uc) {
@@ -92,6 +123,9 @@ std::ostream& operator << (std::ostream& os,
 		}
 
 	}
+	if (!uc.transforms.empty()) {
+		os << "  Transforms: " << uc.transforms.size();
+	}
 
 	return os;
 }
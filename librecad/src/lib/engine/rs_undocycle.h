@@ -30,11 +30,15 @@
 #define RS_UNDOLISTITEM_H
 
 #include <iosfwd>
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "rs_entity.h"
 #include "rs_undoable.h"
 
+class LC_UndoTransform;
+
 /**
  * An Undo Cycle represents an action that was triggered and can
  * be undone. It stores all the pointers to the Undoables affected by
@@ -54,6 +58,7 @@ public:
      * @param type Type of undo item.
      */
 	RS_UndoCycle(/*RS2::UndoType type*/)=default;
+	~RS_UndoCycle();
 
     /**
      * Adds an Undoable to this Undo Cycle. Every Cycle can contain one or
@@ -67,7 +72,15 @@ public:
     void removeUndoable(RS_Undoable* u);
 
     /**
-     * Return number of undoables in cycle
+     * Adds a record of entities transformed in place, the cycle owns it.
+     * Transforms are undone in reverse order.
+     */
+    void addTransform(std::unique_ptr<LC_UndoTransform> t);
+
+    /**
+     * Return number of undoables and transformed entities in cycle.
+     * Cycles don't change once they are in the undo list, so RS_Undo
+     * keeps the sum of all sizes.
      */
     size_t size(void);
 
@@ -80,12 +93,15 @@ public:
     friend class RS_Undo;
 
     std::set<RS_Undoable*> const& getUndoables() const;
+    std::vector<std::unique_ptr<LC_UndoTransform>> const& getTransforms() const;
 
 private:
     //! Undo type:
     //RS2::UndoType type;
     //! List of entity id's that were affected by this action
     std::set<RS_Undoable*> undoables;
+    //! entities transformed in place, in the order of the transforms
+    std::vector<std::unique_ptr<LC_UndoTransform>> transforms;
 };
 
 #endif
@@ -0,0 +1,344 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "lc_dxfpipeline.h"
+#include "libdxfrw.h"
+
+namespace {
+//! calls handed over at once
+constexpr size_t batchSize = 256;
+//! batches queued at most, bounds the memory used for copies
+constexpr size_t queueSize = 64;
+
+/** the parsed data is gone after the callback returns, keep a copy */
+template<class T>
+std::shared_ptr<const T> copyOf(const T& data) {
+	return std::make_shared<const T>(data);
+}
+}
+
+LC_DxfPipeline::LC_DxfPipeline(DRW_Interface* target):
+	target(target)
+{
+	batch.reserve(batchSize);
+}
+
+LC_DxfPipeline::~LC_DxfPipeline() = default;
+
+bool LC_DxfPipeline::read(dxfRW& reader, bool ext) {
+	finished = false;
+	bool success = false;
+	std::thread parser([&]() {
+		success = reader.read(this, ext);
+		flushBatch();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			finished = true;
+		}
+		changed.notify_all();
+	});
+
+	for (;;) {
+		std::vector<std::function<void()>> calls;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [this]() { return !queue.empty() || finished; });
+			if (queue.empty()) {
+				break;
+			}
+			calls = std::move(queue.front());
+			queue.pop_front();
+		}
+		changed.notify_all();
+		for (const auto& call: calls) {
+			call();
+		}
+	}
+
+	parser.join();
+	return success;
+}
+
+void LC_DxfPipeline::post(std::function<void()>&& call) {
+	batch.push_back(std::move(call));
+	if (batch.size() >= batchSize) {
+		flushBatch();
+	}
+}
+
+void LC_DxfPipeline::flushBatch() {
+	if (batch.empty()) {
+		return;
+	}
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		changed.wait(lock, [this]() { return queue.size() < queueSize; });
+		queue.push_back(std::move(batch));
+	}
+	changed.notify_all();
+	batch = std::vector<std::function<void()>>();
+	batch.reserve(batchSize);
+}
+
+void LC_DxfPipeline::addHeader(const DRW_Header* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addHeader(copy.get()); });
+}
+
+void LC_DxfPipeline::addLType(const DRW_LType& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addLType(*copy); });
+}
+
+void LC_DxfPipeline::addLayer(const DRW_Layer& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addLayer(*copy); });
+}
+
+void LC_DxfPipeline::addDimStyle(const DRW_Dimstyle& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addDimStyle(*copy); });
+}
+
+void LC_DxfPipeline::addVport(const DRW_Vport& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addVport(*copy); });
+}
+
+void LC_DxfPipeline::addTextStyle(const DRW_Textstyle& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addTextStyle(*copy); });
+}
+
+void LC_DxfPipeline::addAppId(const DRW_AppId& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addAppId(*copy); });
+}
+
+void LC_DxfPipeline::addBlock(const DRW_Block& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addBlock(*copy); });
+}
+
+void LC_DxfPipeline::setBlock(const int handle) {
+	post([this, handle]() { target->setBlock(handle); });
+}
+
+void LC_DxfPipeline::endBlock() {
+	post([this]() { target->endBlock(); });
+}
+
+void LC_DxfPipeline::addPoint(const DRW_Point& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addPoint(*copy); });
+}
+
+void LC_DxfPipeline::addLine(const DRW_Line& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addLine(*copy); });
+}
+
+void LC_DxfPipeline::addRay(const DRW_Ray& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addRay(*copy); });
+}
+
+void LC_DxfPipeline::addXline(const DRW_Xline& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addXline(*copy); });
+}
+
+void LC_DxfPipeline::addArc(const DRW_Arc& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addArc(*copy); });
+}
+
+void LC_DxfPipeline::addCircle(const DRW_Circle& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addCircle(*copy); });
+}
+
+void LC_DxfPipeline::addEllipse(const DRW_Ellipse& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addEllipse(*copy); });
+}
+
+void LC_DxfPipeline::addLWPolyline(const DRW_LWPolyline& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addLWPolyline(*copy); });
+}
+
+void LC_DxfPipeline::addPolyline(const DRW_Polyline& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addPolyline(*copy); });
+}
+
+void LC_DxfPipeline::addSpline(const DRW_Spline* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addSpline(copy.get()); });
+}
+
+/** not called by dxfRW::read(), DRW_Entity is abstract and can't be copied */
+void LC_DxfPipeline::addKnot(const DRW_Entity& /*data*/) {
+}
+
+void LC_DxfPipeline::addInsert(const DRW_Insert& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addInsert(*copy); });
+}
+
+void LC_DxfPipeline::addTrace(const DRW_Trace& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addTrace(*copy); });
+}
+
+void LC_DxfPipeline::add3dFace(const DRW_3Dface& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->add3dFace(*copy); });
+}
+
+void LC_DxfPipeline::addSolid(const DRW_Solid& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addSolid(*copy); });
+}
+
+void LC_DxfPipeline::addMText(const DRW_MText& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addMText(*copy); });
+}
+
+void LC_DxfPipeline::addText(const DRW_Text& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addText(*copy); });
+}
+
+void LC_DxfPipeline::addDimAlign(const DRW_DimAligned* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addDimAlign(copy.get()); });
+}
+
+void LC_DxfPipeline::addDimLinear(const DRW_DimLinear* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addDimLinear(copy.get()); });
+}
+
+void LC_DxfPipeline::addDimRadial(const DRW_DimRadial* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addDimRadial(copy.get()); });
+}
+
+void LC_DxfPipeline::addDimDiametric(const DRW_DimDiametric* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addDimDiametric(copy.get()); });
+}
+
+void LC_DxfPipeline::addDimAngular(const DRW_DimAngular* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addDimAngular(copy.get()); });
+}
+
+void LC_DxfPipeline::addDimAngular3P(const DRW_DimAngular3p* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addDimAngular3P(copy.get()); });
+}
+
+void LC_DxfPipeline::addDimOrdinate(const DRW_DimOrdinate* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addDimOrdinate(copy.get()); });
+}
+
+void LC_DxfPipeline::addLeader(const DRW_Leader* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addLeader(copy.get()); });
+}
+
+void LC_DxfPipeline::addHatch(const DRW_Hatch* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addHatch(copy.get()); });
+}
+
+void LC_DxfPipeline::addViewport(const DRW_Viewport& data) {
+	auto copy = copyOf(data);
+	post([this, copy]() { target->addViewport(*copy); });
+}
+
+void LC_DxfPipeline::addImage(const DRW_Image* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->addImage(copy.get()); });
+}
+
+void LC_DxfPipeline::linkImage(const DRW_ImageDef* data) {
+	auto copy = copyOf(*data);
+	post([this, copy]() { target->linkImage(copy.get()); });
+}
+
+void LC_DxfPipeline::addComment(const char* comment) {
+	std::string copy(comment);
+	post([this, copy]() { target->addComment(copy.c_str()); });
+}
+
+void LC_DxfPipeline::writeHeader(DRW_Header& data) {
+	target->writeHeader(data);
+}
+
+void LC_DxfPipeline::writeBlocks() {
+	target->writeBlocks();
+}
+
+void LC_DxfPipeline::writeBlockRecords() {
+	target->writeBlockRecords();
+}
+
+void LC_DxfPipeline::writeEntities() {
+	target->writeEntities();
+}
+
+void LC_DxfPipeline::writeLTypes() {
+	target->writeLTypes();
+}
+
+void LC_DxfPipeline::writeLayers() {
+	target->writeLayers();
+}
+
+void LC_DxfPipeline::writeTextstyles() {
+	target->writeTextstyles();
+}
+
+void LC_DxfPipeline::writeVports() {
+	target->writeVports();
+}
+
+void LC_DxfPipeline::writeDimstyles() {
+	target->writeDimstyles();
+}
+
+void LC_DxfPipeline::writeAppId() {
+	target->writeAppId();
+}
@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#ifndef LC_DXFPIPELINE_H
+#define LC_DXFPIPELINE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "drw_interface.h"
+
+class dxfRW;
+
+/**
+ * \brief Reads a DXF file with the parser and the receiver on two threads
+ *
+ * dxfRW::read() runs on a worker thread with this interface, which copies
+ * the parsed data and queues the calls. The calling thread makes the
+ * queued calls of the target interface in file order, while the worker
+ * parses the next part of the file. The target is only ever called by
+ * the calling thread, so it may create entities, layers and blocks and
+ * talk to the GUI as with a plain dxfRW::read().
+ */
+class LC_DxfPipeline : public DRW_Interface {
+public:
+	explicit LC_DxfPipeline(DRW_Interface* target);
+	~LC_DxfPipeline();
+	LC_DxfPipeline(const LC_DxfPipeline&) = delete;
+	LC_DxfPipeline& operator = (const LC_DxfPipeline&) = delete;
+
+	/** @return the result of dxfRW::read(), after all calls were made */
+	bool read(dxfRW& reader, bool ext);
+
+	// called by the parser thread:
+	void addHeader(const DRW_Header* data) override;
+	void addLType(const DRW_LType& data) override;
+	void addLayer(const DRW_Layer& data) override;
+	void addDimStyle(const DRW_Dimstyle& data) override;
+	void addVport(const DRW_Vport& data) override;
+	void addTextStyle(const DRW_Textstyle& data) override;
+	void addAppId(const DRW_AppId& data) override;
+	void addBlock(const DRW_Block& data) override;
+	void setBlock(const int handle) override;
+	void endBlock() override;
+	void addPoint(const DRW_Point& data) override;
+	void addLine(const DRW_Line& data) override;
+	void addRay(const DRW_Ray& data) override;
+	void addXline(const DRW_Xline& data) override;
+	void addArc(const DRW_Arc& data) override;
+	void addCircle(const DRW_Circle& data) override;
+	void addEllipse(const DRW_Ellipse& data) override;
+	void addLWPolyline(const DRW_LWPolyline& data) override;
+	void addPolyline(const DRW_Polyline& data) override;
+	void addSpline(const DRW_Spline* data) override;
+	void addKnot(const DRW_Entity& data) override;
+	void addInsert(const DRW_Insert& data) override;
+	void addTrace(const DRW_Trace& data) override;
+	void add3dFace(const DRW_3Dface& data) override;
+	void addSolid(const DRW_Solid& data) override;
+	void addMText(const DRW_MText& data) override;
+	void addText(const DRW_Text& data) override;
+	void addDimAlign(const DRW_DimAligned* data) override;
+	void addDimLinear(const DRW_DimLinear* data) override;
+	void addDimRadial(const DRW_DimRadial* data) override;
+	void addDimDiametric(const DRW_DimDiametric* data) override;
+	void addDimAngular(const DRW_DimAngular* data) override;
+	void addDimAngular3P(const DRW_DimAngular3p* data) override;
+	void addDimOrdinate(const DRW_DimOrdinate* data) override;
+	void addLeader(const DRW_Leader* data) override;
+	void addHatch(const DRW_Hatch* data) override;
+	void addViewport(const DRW_Viewport& data) override;
+	void addImage(const DRW_Image* data) override;
+	void linkImage(const DRW_ImageDef* data) override;
+	void addComment(const char* comment) override;
+
+	// writing is not pipelined, forwarded as is
+	void writeHeader(DRW_Header& data) override;
+	void writeBlocks() override;
+	void writeBlockRecords() override;
+	void writeEntities() override;
+	void writeLTypes() override;
+	void writeLayers() override;
+	void writeTextstyles() override;
+	void writeVports() override;
+	void writeDimstyles() override;
+	void writeAppId() override;
+
+private:
+	/** queues a call, the queue is handed over in batches */
+	void post(std::function<void()>&& call);
+	/** hands the batch over, waits while the queue is full */
+	void flushBatch();
+
+	DRW_Interface* target;
+	//! calls collected by the parser thread
+	std::vector<std::function<void()>> batch;
+	//! batches waiting for the calling thread
+	std::deque<std::vector<std::function<void()>>> queue;
+	std::mutex mutex;
+	std::condition_variable changed;
+	bool finished = false;
+};
+
+#endif // LC_DXFPIPELINE_H
@@ -49,6 +49,8 @@
 #include "rs_solid.h"
 #include "rs_spline.h"
 #include "lc_splinepoints.h"
+#include "lc_dxfpipeline.h"
+#include "lc_parallel.h"
 #include "rs_system.h"
 #include "rs_text.h"
 #include "rs_graphicview.h"
@@ -114,6 +116,7 @@ bool RS_FilterDXFRW::fileImport(RS_Graphic& g, const QString& file, RS2::FormatT
     graphic = &g;
     currentContainer = graphic;
 	dummyContainer = new RS_EntityContainer(nullptr, true);
+    hatches.clear();
 
     this->file = file;
     // add some variables that need to be there for DXF drawings:
@@ -146,7 +149,14 @@ bool RS_FilterDXFRW::fileImport(RS_Graphic& g, const QString& file, RS2::FormatT
         dxfRW dxfR(QFile::encodeName(file));
 
         RS_DEBUG->print("RS_FilterDXFRW::fileImport: reading file");
-        bool success = dxfR.read(this, true);
+        bool success;
+        if (LC_Parallel::threadCount() > 1) {
+            // parse on a worker thread while the entities are created here
+            LC_DxfPipeline pipeline(this);
+            success = pipeline.read(dxfR, true);
+        } else {
+            success = dxfR.read(this, true);
+        }
         RS_DEBUG->print("RS_FilterDXFRW::fileImport: reading file: OK");
         //graphic->setAutoUpdateBorders(true);
 
@@ -159,6 +169,19 @@ bool RS_FilterDXFRW::fileImport(RS_Graphic& g, const QString& file, RS2::FormatT
     }
 #endif
 
+    RS_DEBUG->print("RS_FilterDXFRW::fileImport: updating hatches");
+    // gap messages are collected per hatch and shown from this thread
+    std::vector<QStringList> hatchMessages(hatches.size());
+    LC_Parallel::forEach(hatches.size(), [this, &hatchMessages](size_t i) {
+        hatches.at(i)->update(&hatchMessages[i]);
+    });
+    hatches.clear();
+    for (const QStringList& messages: hatchMessages) {
+        for (const QString& msg: messages) {
+            RS_DIALOGFACTORY->commandMessage(msg);
+        }
+    }
+
     delete dummyContainer;
     /*set current layer */
     RS_Layer* cl = graphic->findLayer(graphic->getVariableString("$CLAYER", "0"));
@@ -167,7 +190,7 @@ bool RS_FilterDXFRW::fileImport(RS_Graphic& g, const QString& file, RS2::FormatT
         graphic->getLayerList()->activate(cl, true);
     }
     RS_DEBUG->print("RS_FilterDXFRW::fileImport: updating inserts");
-    graphic->updateInserts();
+    graphic->updateInsertsParallel();
 
     RS_DEBUG->print("RS_FilterDXFRW::fileImport OK");
 
@@ -327,8 +350,13 @@ void RS_FilterDXFRW::endBlock() {
         RS_Block *bk = (RS_Block *)currentContainer;
         //remove unnamed blocks *D only if version != R12
         if (version!=1009) {
-            if (bk->getName().startsWith("*D") )
+            if (bk->getName().startsWith("*D") ) {
+                for (int i = hatches.size() - 1; i >= 0; --i) {
+                    if (hatches.at(i)->getParent() == bk)
+                        hatches.removeAt(i);
+                }
                 graphic->removeBlock(bk);
+            }
         }
     }
     currentContainer = graphic;
@@ -1154,9 +1182,9 @@ void RS_FilterDXFRW::addHatch(const DRW_Hatch *data) {
 
     }
 
-    RS_DEBUG->print("hatch->update()");
     if (hatch->validate()) {
-        hatch->update();
+        // updated in parallel with the other hatches when the file is read
+        hatches.append(hatch);
     } else {
         graphic->removeEntity(hatch);
         RS_DEBUG->print(RS_Debug::D_ERROR,
@@ -1379,6 +1407,7 @@ bool RS_FilterDXFRW::fileExport(RS_Graphic& g, const QString& file, RS2::FormatT
     }
 
     dxfW = new dxfRW(QFile::encodeName(file));
+    dxfW->setBuffered(bufferedWriting);
     bool success = dxfW->write(this, exportVersion, false); //ascii
 //    bool success = dxf->write(this, exportVersion, true); //binary
     delete dxfW;
@@ -2240,17 +2269,15 @@ void RS_FilterDXFRW::writeSpline(RS_Spline *s) {
     // version 12 do not support Spline write as polyline
     if (version==1009) {
         DRW_Polyline pol;
-        RS_Entity* e;
-        for (e=s->firstEntity(RS2::ResolveNone);
-             e; e=s->nextEntity(RS2::ResolveNone)) {
-            pol.addVertex( DRW_Vertex(e->getStartpoint().x,
-                                      e->getStartpoint().y, 0.0, 0.0));
+        const std::vector<RS_Vector>& points = s->getCurvePoints();
+        // the last point of a closed spline is its first point
+        size_t const count = s->isClosed() && !points.empty()
+                ? points.size() - 1 : points.size();
+        for (size_t i = 0; i < count; ++i) {
+            pol.addVertex( DRW_Vertex(points[i].x, points[i].y, 0.0, 0.0));
         }
         if (s->isClosed()) {
             pol.flags = 1;
-        } else {
-            pol.addVertex( DRW_Vertex(s->getEndpoint().x,
-                                      s->getEndpoint().y, 0.0, 0.0));
         }
         getEntityAttributes(&pol, s);
         dxfW->writePolyline(&pol);
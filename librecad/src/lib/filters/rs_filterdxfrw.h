@@ -124,6 +124,8 @@ public:
 
     // Export:
     virtual bool fileExport(RS_Graphic& g, const QString& file, RS2::FormatType type);
+    /** Ascii files are written through a large buffer, default true. */
+    void setBufferedWriting(bool b) {bufferedWriting = b;}
 
     virtual void writeHeader(DRW_Header& data);
     virtual void writeEntities();
@@ -222,12 +224,15 @@ private:
     QHash <QString, QString> fontList;
     bool oldMText;
     dxfRW *dxfW;
+    bool bufferedWriting {true};
     /** If saved version are 2004 or above can save color in RGB value. */
     bool exactColor;
     /** hash of block containers and handleBlock numbers to read dwg files */
     QHash<int, RS_EntityContainer*> blockHash;
     /** Pointer to entity container to store possible orphan entities like paper space */
     RS_EntityContainer* dummyContainer;
+    /** Hatches to update once all entities are read */
+    QList<RS_Hatch*> hatches;
 };
 
 #endif
@@ -49,6 +49,7 @@
 #include "rs_layer.h"
 #include "rs_math.h"
 #include "rs_debug.h"
+#include "lc_spatialindex.h"
 
 #ifdef EMU_C99
 #include "emu_c99.h"
@@ -769,7 +770,7 @@ void RS_GraphicView::zoomPan(int dx, int dy) {
 	//adjustZoomControls();
 	//    updateGrid();
 
-	redraw();
+	redrawPanned(dx, dy);
 }
 
 
@@ -778,24 +779,37 @@ void RS_GraphicView::zoomPan(int dx, int dy) {
  * Scrolls in the given direction.
  */
 void RS_GraphicView::zoomScroll(RS2::Direction direction) {
+	int dx = 0;
+	int dy = 0;
 	switch (direction) {
 	case RS2::Up:
-		offsetY-=50;
+		dy = 50;
 		break;
 	case RS2::Down:
-		offsetY+=50;
+		dy = -50;
 		break;
 	case RS2::Right:
-		offsetX+=50;
+		dx = 50;
 		break;
 	case RS2::Left:
-		offsetX-=50;
+		dx = -50;
 		break;
 	}
+	offsetX += dx;
+	offsetY -= dy;
 	adjustOffsetControls();
 	adjustZoomControls();
 	//    updateGrid();
 
+	redrawPanned(dx, dy);
+}
+
+
+
+/**
+ * The default implementation redraws everything.
+ */
+void RS_GraphicView::redrawPanned(int /*dx*/, int /*dy*/) {
 	redraw();
 }
 
@@ -927,7 +941,8 @@ void RS_GraphicView::drawLayer1(RS_Painter *painter) {
 
 void RS_GraphicView::drawLayer2(RS_Painter *painter)
 {
-	drawEntity(painter, container);	//	Draw all entities.
+	//	Draw all entities.
+	drawEntities(painter, LC_Rect{{0., 0.}, {double(getWidth()), double(getHeight())}});
 
 	//	If not in print preview, draw the absolute zero reference.
 	//	----------------------------------------------------------
@@ -936,6 +951,33 @@ void RS_GraphicView::drawLayer2(RS_Painter *painter)
 }
 
 
+/**
+ * Draws the entities visible in an area of the view, given in screen
+ * coordinates. Unselected entities are drawn first, so selected entities
+ * end up on top. Both passes share a single spatial index query.
+ */
+void RS_GraphicView::drawEntities(RS_Painter *painter, const LC_Rect& guiArea)
+{
+	const LC_SpatialIndex* index = (container && !isPrinting())
+			? container->getSpatialIndex() : nullptr;
+	if (index) {
+		std::vector<RS_Entity*> const visible = index->query(
+					LC_Rect(toGraph(guiArea.minP()), toGraph(guiArea.maxP())));
+		for (bool selected: {false, true}) {
+			painter->setDrawSelectedOnly(selected);
+			for (RS_Entity* e: visible) {
+				drawEntity(painter, e);
+			}
+		}
+	} else {
+		for (bool selected: {false, true}) {
+			painter->setDrawSelectedOnly(selected);
+			drawEntity(painter, container);
+		}
+	}
+}
+
+
 void RS_GraphicView::drawLayer3(RS_Painter *painter) {
 	// drawing zero points:
 	if (!isPrintPreview()) {
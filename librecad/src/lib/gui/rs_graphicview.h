@@ -111,6 +111,9 @@ public:
 	/** This virtual method must be overwritten to redraw
 	  the widget. */
 	virtual void redraw(RS2::RedrawMethod method=RS2::RedrawAll) = 0;
+	/** Redraws after the drawing was moved by (dx, dy) pixels without
+	  zooming. The default is a full redraw. */
+	virtual void redrawPanned(int dx, int dy);
 	/** This virtual method must be overwritten and is then
 	  called whenever the view changed */
     virtual void adjustOffsetControls() = 0;
@@ -264,6 +267,7 @@ public:
 	virtual void drawWindow_DEPRECATED(RS_Vector v1, RS_Vector v2);
 	virtual void drawLayer1(RS_Painter *painter);
 	virtual void drawLayer2(RS_Painter *painter);
+	void drawEntities(RS_Painter *painter, const LC_Rect& guiArea);
 	virtual void drawLayer3(RS_Painter *painter);
 	virtual void deleteEntity(RS_Entity* e);
 	virtual void drawEntity(RS_Painter *painter, RS_Entity* e, double& patternOffset);
@@ -86,6 +86,60 @@ Qt::PenStyle rsToQtLineType(RS2::LineType t) {
 RS_PainterQt::RS_PainterQt( QPaintDevice* pd)
         : QPainter(pd), RS_Painter() {}
 
+RS_PainterQt::~RS_PainterQt() {
+    flush();
+}
+
+void RS_PainterQt::setBatching(bool on) {
+    if (!on) {
+        flush();
+    }
+    batching = on;
+}
+
+bool RS_PainterQt::isBatching() const {
+    return batching;
+}
+
+void RS_PainterQt::flush() {
+    if (lineBatch.isEmpty()) {
+        return;
+    }
+    if (isActive()) {
+        QPainter::drawLines(lineBatch);
+    }
+    lineBatch.clear();
+}
+
+/**
+ * Draws a polyline, in batching mode the segments are collected.
+ */
+void RS_PainterQt::drawPolylineBatched(const QPolygon& pa) {
+    if (!batching) {
+        drawPolyline(pa);
+        return;
+    }
+    for (int i = 1; i < pa.size(); ++i) {
+        lineBatch.append(QLineF(pa.at(i - 1), pa.at(i)));
+    }
+}
+
+void RS_PainterQt::drawPolylineBatched(const QPolygonF& pa,
+                                       const QPointF& offset, double scale) {
+    if (!batching) {
+        QPolygonF screen(pa.size());
+        for (int i = 0; i < pa.size(); ++i) {
+            screen[i] = offset + pa.at(i) * scale;
+        }
+        QPainter::drawPolyline(screen);
+        return;
+    }
+    for (int i = 1; i < pa.size(); ++i) {
+        lineBatch.append(QLineF(offset + pa.at(i - 1) * scale,
+                                offset + pa.at(i) * scale));
+    }
+}
+
 void RS_PainterQt::moveTo(int x, int y) {
         //RVT_PORT changed from QPainter::moveTo(x,y);
         rememberX=x;
@@ -95,6 +149,7 @@ void RS_PainterQt::moveTo(int x, int y) {
 
 void RS_PainterQt::lineTo(int x, int y) {
         // RVT_PORT changed from QPainter::lineTo(x, y);
+        flush();
         QPainterPath path;
         path.moveTo(rememberX,rememberY);
         path.lineTo(x,y);
@@ -107,6 +162,7 @@ void RS_PainterQt::lineTo(int x, int y) {
  * Draws a grid point at (x1, y1).
  */
 void RS_PainterQt::drawGridPoint(const RS_Vector& p) {
+    flush();
     QPainter::drawPoint(toScreenX(p.x), toScreenY(p.y));
 }
 
@@ -116,6 +172,7 @@ void RS_PainterQt::drawGridPoint(const RS_Vector& p) {
  * Draws a point at (x1, y1).
  */
 void RS_PainterQt::drawPoint(const RS_Vector& p) {
+    flush();
     QPainter::drawLine(toScreenX(p.x-1), toScreenY(p.y),
                        toScreenX(p.x+1), toScreenY(p.y));
     QPainter::drawLine(toScreenX(p.x), toScreenY(p.y-1),
@@ -129,6 +186,11 @@ void RS_PainterQt::drawPoint(const RS_Vector& p) {
  */
 void RS_PainterQt::drawLine(const RS_Vector& p1, const RS_Vector& p2)
 {
+    if (batching) {
+        lineBatch.append(QLineF(toScreenX(p1.x), toScreenY(p1.y),
+                                toScreenX(p2.x), toScreenY(p2.y)));
+        return;
+    }
     QPainter::drawLine(toScreenX(p1.x), toScreenY(p1.y),
                        toScreenX(p2.x), toScreenY(p2.y));
 }
@@ -225,7 +287,7 @@ void RS_PainterQt::drawArc(const RS_Vector& cp, double radius,
             //lineTo(toScreenX(p2.x), toScreenY(p2.y));
             pa.resize(i+1);
             pa.setPoint(i++, toScreenX(p2.x), toScreenY(p2.y));
-            drawPolyline(pa);
+            drawPolylineBatched(pa);
         } else {
             // Arc Clockwise:
             if(a1<a2+1.0e-10) {
@@ -246,7 +308,7 @@ void RS_PainterQt::drawArc(const RS_Vector& cp, double radius,
             //lineTo(toScreenX(p2.x), toScreenY(p2.y));
             pa.resize(i+1);
             pa.setPoint(i++, toScreenX(p2.x), toScreenY(p2.y));
-            drawPolyline(pa);
+            drawPolylineBatched(pa);
         }
     }
 }
@@ -274,7 +336,7 @@ void RS_PainterQt::drawArc(const RS_Vector& cp, double radius,
 #else
         QPolygon pa;
         createArc(pa, cp, radius, a1, a2, reversed);
-        drawPolyline(pa);
+        drawPolylineBatched(pa);
 #endif
     }
 }
@@ -294,6 +356,7 @@ void RS_PainterQt::drawArcMac(const RS_Vector& cp, double radius,
                            double a1, double a2,
                            bool reversed) {
         RS_DEBUG->print("RS_PainterQt::drawArcMac");
+    flush();
     if(radius<=0.5) {
         drawGridPoint(cp);
     } else {
@@ -379,6 +442,7 @@ void RS_PainterQt::drawArcMac(const RS_Vector& cp, double radius,
  */
 void RS_PainterQt::drawCircle(const RS_Vector& cp, double radius)
 {
+    flush();
     QPainter::drawEllipse(QPointF(cp.x, cp.y), radius, radius);
 }
 
@@ -394,7 +458,7 @@ void RS_PainterQt::drawEllipse(const RS_Vector& cp,
                                bool reversed) {
     QPolygon pa;
     createEllipse(pa, cp, radius1, radius2, angle, a1, a2, reversed);
-    drawPolyline(pa);
+    drawPolylineBatched(pa);
 }
 
 
@@ -404,6 +468,7 @@ void RS_PainterQt::drawEllipse(const RS_Vector& cp,
  */
 void RS_PainterQt::drawImg(QImage& img, const RS_Vector& pos,
                            double angle, const RS_Vector& factor) {
+    flush();
     save();
 
     // Render smooth only at close zooms
@@ -431,6 +496,7 @@ void RS_PainterQt::drawImg(QImage& img, const RS_Vector& pos,
 void RS_PainterQt::drawTextH(int x1, int y1,
                              int x2, int y2,
                              const QString& text) {
+    flush();
     drawText(x1, y1, x2, y2,
              Qt::AlignRight|Qt::AlignVCenter,
              text);
@@ -441,6 +507,7 @@ void RS_PainterQt::drawTextH(int x1, int y1,
 void RS_PainterQt::drawTextV(int x1, int y1,
                              int x2, int y2,
                              const QString& text) {
+    flush();
     save();
     QMatrix wm = worldMatrix();
     wm.rotate(-90.0);
@@ -456,6 +523,7 @@ void RS_PainterQt::drawTextV(int x1, int y1,
 
 void RS_PainterQt::fillRect(int x1, int y1, int w, int h,
                             const RS_Color& col) {
+    flush();
     QPainter::fillRect(x1, y1, w, h, col);
 }
 
@@ -464,6 +532,7 @@ void RS_PainterQt::fillTriangle(const RS_Vector& p1,
                                 const RS_Vector& p2,
                                 const RS_Vector& p3) {
 
+    flush();
     QPolygon arr(3);
     QBrush brushSaved=brush();
     arr.putPoints(0, 3,
@@ -477,6 +546,7 @@ void RS_PainterQt::fillTriangle(const RS_Vector& p1,
 
 
 void RS_PainterQt::erase() {
+    flush();
     QPainter::eraseRect(0,0,getWidth(),getHeight());
 }
 
@@ -522,10 +592,16 @@ void RS_PainterQt::setPen(const RS_Pen& pen) {
 		   rsToQtLineType(lpen.getLineType()));
     p.setJoinStyle(Qt::RoundJoin);
     p.setCapStyle(Qt::RoundCap);
+    if (batching && p == pen()) {
+        // consecutive entities with the same resolved pen share a batch
+        return;
+    }
+    flush();
     QPainter::setPen(p);
 }
 
 void RS_PainterQt::setPen(const RS_Color& color) {
+    flush();
     if (drawingMode==RS2::ModeBW) {
         lpen.setColor(RS_Color(0,0,0));
         QPainter::setPen(RS_Color(0,0,0));
@@ -544,6 +620,7 @@ void RS_PainterQt::setPen(int r, int g, int b) {
 }
 
 void RS_PainterQt::disablePen() {
+    flush();
     lpen = RS_Pen(RS2::FlagInvalid);
     QPainter::setPen(Qt::NoPen);
 }
@@ -561,24 +638,29 @@ void RS_PainterQt::setBrush(const QBrush& color) {
 }
 
 void RS_PainterQt::drawPolygon(const QPolygon& a, Qt::FillRule rule) {
+    flush();
     QPainter::drawPolygon(a,rule);
 }
 
 void RS_PainterQt::drawPath ( const QPainterPath & path ) {
+    flush();
     QPainter::drawPath(path);
 }
 
 
 void RS_PainterQt::setClipRect(int x, int y, int w, int h) {
+    flush();
     QPainter::setClipRect(x, y, w, h);
     setClipping(true);
 }
 
 void RS_PainterQt::resetClipping() {
+    flush();
     setClipping(false);
 }
 
 void RS_PainterQt::fillRect ( const QRectF & rectangle, const RS_Color & color ) {
+        flush();
 
         double x1=rectangle.left();
         double x2=rectangle.right();
@@ -588,6 +670,7 @@ void RS_PainterQt::fillRect ( const QRectF & rectangle, const RS_Color & color )
         QPainter::fillRect(toScreenX(x1),toScreenY(y1),toScreenX(x2)-toScreenX(x1),toScreenY(y2)-toScreenX(y1), color);
 }
 void RS_PainterQt::fillRect ( const QRectF & rectangle, const QBrush & brush ) {
+        flush();
         double x1=rectangle.left();
         double x2=rectangle.right();
         double y1=rectangle.top();
@@ -29,6 +29,7 @@
 #define RS_PAINTERQT_H
 
 #include <QPainter>
+#include <QVector>
 
 #include "rs_painter.h"
 #include "rs_pen.h"
@@ -42,7 +43,25 @@ class RS_PainterQt: public QPainter, public RS_Painter {
 
 public:
     RS_PainterQt( QPaintDevice* pd);
-    virtual ~RS_PainterQt()=default;
+    virtual ~RS_PainterQt();
+
+    /**
+     * In batching mode, lines and polylines are collected and drawn with
+     * a single QPainter::drawLines() call, once the pen changes, any other
+     * primitive is drawn or flush() is called. setPen() with the pen already
+     * in use doesn't interrupt a batch. Users have to call flush() before
+     * QPainter::end(), only the destructor flushes on its own.
+     */
+    void setBatching(bool on);
+    bool isBatching() const;
+    /** draws the collected lines, drops them if the painter isn't active */
+    void flush();
+    /**
+     * Draws a polyline scaled and moved to screen coordinates, in
+     * batching mode the segments are collected.
+     */
+    void drawPolylineBatched(const QPolygonF& pa, const QPointF& offset,
+                             double scale);
 
     virtual void moveTo(int x, int y);
     virtual void lineTo(int x, int y);
@@ -108,7 +127,11 @@ public:
     virtual void resetClipping();
 
 protected:
+    void drawPolylineBatched(const QPolygon& pa);
+
     RS_Pen lpen;
+    bool batching{false};
+    QVector<QLineF> lineBatch;
     long rememberX; // Used for the moment because QPainter doesn't support moveTo anymore, thus we need to remember ourselves the moveTo positions
     long rememberY;
 };
@@ -40,6 +40,7 @@
 #include "lc_splinepoints.h"
 #include "rs_math.h"
 #include "lc_rect.h"
+#include "lc_contourregion.h"
 #include "rs_debug.h"
 
 /**
@@ -750,6 +751,7 @@ RS_VectorSolutions RS_Information::getIntersectionEllipseLine(RS_Line* line,
  *         The entities don't need to be in a specific order.
  * @param onContour Will be set to true if the given point it exactly
  *         on the contour.
+ * @see LC_ContourRegion
  */
 bool RS_Information::isPointInsideContour(const RS_Vector& point,
         RS_EntityContainer* contour, bool* onContour) {
@@ -765,169 +767,8 @@ bool RS_Information::isPointInsideContour(const RS_Vector& point,
         return false;
     }
 
-    double width = contour->getSize().x+1.0;
-
-    bool sure;
-    int counter;
-    int tries = 0;
-    double rayAngle = 0.0;
-    do {
-        sure = true;
-
-        // create ray:
-		RS_Vector v = RS_Vector::polar(width*10.0, rayAngle);
-		RS_Line ray{point, point+v};
-        counter = 0;
-        RS_VectorSolutions sol;
-
-		if (onContour) {
-            *onContour = false;
-        }
-
-        for (RS_Entity* e = contour->firstEntity(RS2::ResolveAll);
-				e;
-                e = contour->nextEntity(RS2::ResolveAll)) {
-
-            // intersection(s) from ray with contour entity:
-            sol = RS_Information::getIntersection(&ray, e, true);
-
-            for (int i=0; i<=1; ++i) {
-                RS_Vector p = sol.get(i);
-
-                if (p.valid) {
-                    // point is on the contour itself
-                    if (p.distanceTo(point)<1.0e-5) {
-						if (onContour) {
-                            *onContour = true;
-                        }
-                    } else {
-                        if (e->rtti()==RS2::EntityLine) {
-                            RS_Line* line = (RS_Line*)e;
-
-                            // ray goes through startpoint of line:
-                            if (p.distanceTo(line->getStartpoint())<1.0e-4) {
-                                if (RS_Math::correctAngle(line->getAngle1())<M_PI) {
-                                    sure = false;
-                                }
-                            }
-
-                            // ray goes through endpoint of line:
-                            else if (p.distanceTo(line->getEndpoint())<1.0e-4) {
-                                if (RS_Math::correctAngle(line->getAngle2())<M_PI) {
-                                    sure = false;
-                                }
-                            }
-                            // else: ray goes through the line
-
-
-                                counter++;
-                            
-                        } else if (e->rtti()==RS2::EntityArc) {
-                            RS_Arc* arc = (RS_Arc*)e;
-
-                            if (p.distanceTo(arc->getStartpoint())<1.0e-4) {
-                                double dir = arc->getDirection1();
-                                if ((dir<M_PI && dir>=1.0e-5) ||
-                                        ((dir>2*M_PI-1.0e-5 || dir<1.0e-5) &&
-                                         arc->getCenter().y>p.y)) {
-                                    counter++;
-                                    sure = false;
-                                }
-                            }
-                            else if (p.distanceTo(arc->getEndpoint())<1.0e-4) {
-                                double dir = arc->getDirection2();
-                                if ((dir<M_PI && dir>=1.0e-5) ||
-                                        ((dir>2*M_PI-1.0e-5 || dir<1.0e-5) &&
-                                         arc->getCenter().y>p.y)) {
-                                    counter++;
-                                    sure = false;
-                                }
-                            } else {
-                                counter++;
-                            }
-                        } else if (e->rtti()==RS2::EntityCircle) {
-                            // tangent:
-                            if (i==0 && sol.get(1).valid==false) {
-                                if (!sol.isTangent()) {
-                                    counter++;
-                                } else {
-                                    sure = false;
-                                }
-                            } else if (i==1 || sol.get(1).valid==true) {
-                                counter++;
-                            }
-                        } else if (e->rtti()==RS2::EntityEllipse) {
-                            RS_Ellipse* ellipse=static_cast<RS_Ellipse*>(e);
-                            if(ellipse->isArc()){
-                                if (p.distanceTo(ellipse->getStartpoint())<1.0e-4) {
-                                    double dir = ellipse->getDirection1();
-                                    if ((dir<M_PI && dir>=1.0e-5) ||
-                                            ((dir>2*M_PI-1.0e-5 || dir<1.0e-5) &&
-                                             ellipse->getCenter().y>p.y)) {
-                                        counter++;
-                                        sure = false;
-                                    }
-                                }
-                                else if (p.distanceTo(ellipse->getEndpoint())<1.0e-4) {
-                                    double dir = ellipse->getDirection2();
-                                    if ((dir<M_PI && dir>=1.0e-5) ||
-                                            ((dir>2*M_PI-1.0e-5 || dir<1.0e-5) &&
-                                             ellipse->getCenter().y>p.y)) {
-                                        counter++;
-                                        sure = false;
-                                    }
-                                } else {
-                                    counter++;
-                                }
-                            }else{
-                                // tangent:
-                                if (i==0 && sol.get(1).valid==false) {
-                                    if (!sol.isTangent()) {
-                                        counter++;
-                                    } else {
-                                        sure = false;
-                                    }
-                                } else if (i==1 || sol.get(1).valid==true) {
-                                    counter++;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-
-        rayAngle+=0.02;
-        tries++;
-    }
-    while (!sure && rayAngle<2*M_PI && tries<6);
-
-    // remove double intersections:
-    /*
-       QList<RS_Vector> is2;
-       bool done;
-    RS_Vector* av;
-       do {
-           done = true;
-           double minDist = RS_MAXDOUBLE;
-           double dist;
-		av = nullptr;
-		   for (RS_Vector* v = is.first(); v; v = is.next()) {
-               dist = point.distanceTo(*v);
-               if (dist<minDist) {
-                   minDist = dist;
-                   done = false;
-                        av = v;
-               }
-           }
-
-		if (!done && av) {
-                is2.append(*av);
-        }
-       } while (!done);
-    */
-
-    return ((counter%2)==1);
+    // for many queries against the same contour, keep an LC_ContourRegion
+    return LC_ContourRegion(contour).isInside(point, onContour);
 }
 
 
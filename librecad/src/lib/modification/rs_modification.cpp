@@ -24,6 +24,7 @@
 **
 **********************************************************************/
 #include<cmath>
+#include<memory>
 #include "rs_modification.h"
 
 #include "rs_arc.h"
@@ -46,11 +47,33 @@
 #include "rs_debug.h"
 #include "rs_dialogfactory.h"
 #include "lc_undosection.h"
+#include "lc_undotransform.h"
 
 #ifdef EMU_C99
 #include "emu_c99.h"
 #endif
 
+namespace {
+/**
+ * Letters of texts share the glyphs of their font and have no entities,
+ * clone the letter blocks to have entities to explode.
+ */
+void materializeLetters(RS_EntityContainer* ec) {
+	for (RS_Entity* e: *ec) {
+		if (e->rtti() == RS2::EntityInsert) {
+			RS_Insert* letter = static_cast<RS_Insert*>(e);
+			if (letter->getGlyph()) {
+				letter->setGlyph(nullptr);
+				letter->update();
+				letter->materialize();
+			}
+		} else if (e->isContainer()) {
+			materializeLetters(static_cast<RS_EntityContainer*>(e));
+		}
+	}
+}
+}
+
 RS_PasteData::RS_PasteData(RS_Vector _insertionPoint,
 		double _factor,
 		double _angle,
@@ -99,15 +122,10 @@ void RS_Modification::remove() {
     }
 
     LC_UndoSection undo( document);
-	// not safe (?)
-    for(auto e: *container) {
-        if (e && e->isSelected()) {
-            e->setSelected(false);
-            e->changeUndoState();
-            undo.addUndoable(e);
-        } else {
-            RS_DEBUG->print(RS_Debug::D_WARNING, "RS_Modification::remove: no valid container is selected");
-        }
+    for(auto e: container->getSelectedEntities()) {
+        e->setSelected(false);
+        e->changeUndoState();
+        undo.addUndoable(e);
     }
 
     graphicView->redraw(RS2::RedrawDrawing);
@@ -130,14 +148,10 @@ void RS_Modification::revertDirection() {
 	}
 
 	std::vector<RS_Entity*> addList;
-    for(auto e: *container) {
-		if (e && e->isSelected()) {
-			RS_Entity* ec = e->clone();
-			ec->revertDirection();
-			addList.push_back(ec);
-        } else {
-        RS_DEBUG->print(RS_Debug::D_WARNING, "RS_Modification::revertDirection: no valid container is selected");
-        }
+    for(auto e: container->getSelectedEntitiesInOrder()) {
+		RS_Entity* ec = e->clone();
+		ec->revertDirection();
+		addList.push_back(ec);
 	}
 
     LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
@@ -218,52 +232,45 @@ bool RS_Modification::changeAttributes(RS_AttributesData& data) {
     LC_UndoSection  undo(document);
     std::vector<RS_Entity*> addList;
 
-    for(auto e: *container) {
-//        for (unsigned i=0; i<container->count(); ++i) {
-//        RS_Entity* e = container->entityAt(i);
-        if (e && e->isSelected()) {
-
-            e->setSelected(false);
-            RS_Pen pen = e->getPen(false);
+    for(auto e: container->getSelectedEntitiesInOrder()) {
+        e->setSelected(false);
+        RS_Pen pen = e->getPen(false);
 
-            if (data.changeLayer==true) {
-                e->setLayer(data.layer);
-            }
+        if (data.changeLayer==true) {
+            e->setLayer(data.layer);
+        }
 
-            if (data.changeColor==true) {
-                pen.setColor(data.pen.getColor());
-            }
-            if (data.changeLineType==true) {
-                pen.setLineType(data.pen.getLineType());
-            }
-            if (data.changeWidth==true) {
-                pen.setWidth(data.pen.getWidth());
-            }
-            e->setPen(pen);
+        if (data.changeColor==true) {
+            pen.setColor(data.pen.getColor());
+        }
+        if (data.changeLineType==true) {
+            pen.setLineType(data.pen.getLineType());
+        }
+        if (data.changeWidth==true) {
+            pen.setWidth(data.pen.getWidth());
+        }
+        e->setPen(pen);
 
-            if (e->isContainer()) {
-                if (e->rtti() == RS2::EntityInsert) {
-                    RS_Block* eb = static_cast<RS_Insert*>(e)->getBlockForInsert();
-                    changeAttributes(data, (RS_EntityContainer*)eb, addList);
-                } else {
-                    changeAttributes(data, (RS_EntityContainer*)e, addList);
-                }
+        if (e->isContainer()) {
+            if (e->rtti() == RS2::EntityInsert) {
+                RS_Block* eb = static_cast<RS_Insert*>(e)->getBlockForInsert();
+                changeAttributes(data, (RS_EntityContainer*)eb, addList);
+            } else {
+                changeAttributes(data, (RS_EntityContainer*)e, addList);
             }
+        }
 
-            e->update();
+        e->update();
 
-            //if (data.useCurrentLayer) {
-            //    ec->setLayerToActive();
-            //}
-            //if (data.useCurrentAttributes) {
-            //    ec->setPenToActive();
-            //}
-            //if (ec->rtti()==RS2::EntityInsert) {
-            //    ((RS_Insert*)ec)->update();
-            //}
-        } else {
-            RS_DEBUG->print(RS_Debug::D_NOTICE, "RS_Modification::changeAttributes: no valid container is selected");
-        }
+        //if (data.useCurrentLayer) {
+        //    ec->setLayerToActive();
+        //}
+        //if (data.useCurrentAttributes) {
+        //    ec->setPenToActive();
+        //}
+        //if (ec->rtti()==RS2::EntityInsert) {
+        //    ((RS_Insert*)ec)->update();
+        //}
     }
 
     deselectOriginals(true);
@@ -307,14 +314,8 @@ void RS_Modification::copy(const RS_Vector& ref, const bool cut) {
     LC_UndoSection undo( document, cut && handleUndo);
 
 	// copy entities / layers / blocks
-	for(auto e: *container){
-        //for (unsigned i=0; i<container->count(); ++i) {
-        //RS_Entity* e = container->entityAt(i);
-        if (e && e->isSelected()) {
-            copyEntity(e, ref, cut);
-        } else {
-            RS_DEBUG->print(RS_Debug::D_NOTICE, "RS_Modification::copy: no valid container is selected");
-        }
+	for(auto e: container->getSelectedEntitiesInOrder()){
+        copyEntity(e, ref, cut);
     }
 
     RS_DEBUG->print(RS_Debug::D_DEBUGGING, "RS_Modification::copy: OK");
@@ -1616,7 +1617,17 @@ bool RS_Modification::move(RS_MoveData& data) {
         return false;
     }
 
+    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
 	std::vector<RS_Entity*> addList;
+	std::vector<RS_Entity*> selected = container->getSelectedEntities();
+	if (data.number==0 && !data.useCurrentLayer && !data.useCurrentAttributes) {
+		std::unique_ptr<LC_UndoTransform> transform{new LC_UndoTransform};
+		transform->move(data.offset);
+		// since 2.0.4.0: keep selection
+		selected = transformInPlace(selected, std::move(transform), true);
+	}
+	// only the clones need the draw order of their originals
+	container->sortInContainerOrder(selected);
 
     // Create new entities
     for (int num=1;
@@ -1625,29 +1636,26 @@ bool RS_Modification::move(RS_MoveData& data) {
         // too slow:
         //for (unsigned i=0; i<container->count(); ++i) {
 		//RS_Entity* e = container->entityAt(i);
-		for(auto e: *container){
-			if (e && e->isSelected()) {
-                RS_Entity* ec = e->clone();
+		for(auto e: selected){
+            RS_Entity* ec = e->clone();
 
-                ec->move(data.offset*num);
-                if (data.useCurrentLayer) {
-                    ec->setLayerToActive();
-                }
-                if (data.useCurrentAttributes) {
-                    ec->setPenToActive();
-                }
-                if (ec->rtti()==RS2::EntityInsert) {
-                    ((RS_Insert*)ec)->update();
-                }
-                // since 2.0.4.0: keep selection
-                ec->setSelected(true);
-				addList.push_back(ec);
+            ec->move(data.offset*num);
+            if (data.useCurrentLayer) {
+                ec->setLayerToActive();
+            }
+            if (data.useCurrentAttributes) {
+                ec->setPenToActive();
             }
+            if (ec->rtti()==RS2::EntityInsert) {
+                ((RS_Insert*)ec)->update();
+            }
+            // since 2.0.4.0: keep selection
+            ec->setSelected(true);
+			addList.push_back(ec);
         }
     }
 
-    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
-    deselectOriginals(data.number==0);
+    deselectOriginals(selected, data.number==0);
     addNewEntities(addList);
 
     return true;
@@ -1667,35 +1675,34 @@ bool RS_Modification::offset(const RS_OffsetData& data) {
     }
 
 	std::vector<RS_Entity*> addList;
+	std::vector<RS_Entity*> const selected = container->getSelectedEntitiesInOrder();
 
     // Create new entities
     for (int num=1;
             num<=data.number || (data.number==0 && num<=1);
             num++) {
         // too slow:
-		for(auto e: *container){
-			if (e && e->isSelected()) {
-                RS_Entity* ec = e->clone();
-				//highlight is used by trim actions. do not carry over flag
-				ec->setHighlighted(false);
+		for(auto e: selected){
+            RS_Entity* ec = e->clone();
+			//highlight is used by trim actions. do not carry over flag
+			ec->setHighlighted(false);
 
-				if (!ec->offset(data.coord, num*data.distance)) {
-                    delete ec;
-                    continue;
-                }
-                if (data.useCurrentLayer) {
-                    ec->setLayerToActive();
-                }
-                if (data.useCurrentAttributes) {
-                    ec->setPenToActive();
-                }
-                if (ec->rtti()==RS2::EntityInsert) {
-					static_cast<RS_Insert*>(ec)->update();
-                }
-                // since 2.0.4.0: keep selection
-                ec->setSelected(true);
-				addList.push_back(ec);
+			if (!ec->offset(data.coord, num*data.distance)) {
+                delete ec;
+                continue;
+            }
+            if (data.useCurrentLayer) {
+                ec->setLayerToActive();
+            }
+            if (data.useCurrentAttributes) {
+                ec->setPenToActive();
+            }
+            if (ec->rtti()==RS2::EntityInsert) {
+				static_cast<RS_Insert*>(ec)->update();
             }
+            // since 2.0.4.0: keep selection
+            ec->setSelected(true);
+			addList.push_back(ec);
         }
     }
 
@@ -1719,37 +1726,42 @@ bool RS_Modification::rotate(RS_RotateData& data) {
         return false;
     }
 
+    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
 	std::vector<RS_Entity*> addList;
+	std::vector<RS_Entity*> selected = container->getSelectedEntities();
+	if (data.number==0 && !data.useCurrentLayer && !data.useCurrentAttributes) {
+		std::unique_ptr<LC_UndoTransform> transform{new LC_UndoTransform};
+		transform->rotate(data.center, data.angle);
+		selected = transformInPlace(selected, std::move(transform), false);
+	}
+	// only the clones need the draw order of their originals
+	container->sortInContainerOrder(selected);
 
     // Create new entities
     for (int num=1;
             num<=data.number || (data.number==0 && num<=1);
 			num++) {
-		for(auto e: *container){
+		for(auto e: selected){
             //for (unsigned i=0; i<container->count(); ++i) {
             //RS_Entity* e = container->entityAt(i);
+            RS_Entity* ec = e->clone();
+            ec->setSelected(false);
 
-            if (e && e->isSelected()) {
-                RS_Entity* ec = e->clone();
-                ec->setSelected(false);
-
-                ec->rotate(data.center, data.angle*num);
-                if (data.useCurrentLayer) {
-                    ec->setLayerToActive();
-                }
-                if (data.useCurrentAttributes) {
-                    ec->setPenToActive();
-                }
-                if (ec->rtti()==RS2::EntityInsert) {
-                    ((RS_Insert*)ec)->update();
-                }
-				addList.push_back(ec);
+            ec->rotate(data.center, data.angle*num);
+            if (data.useCurrentLayer) {
+                ec->setLayerToActive();
+            }
+            if (data.useCurrentAttributes) {
+                ec->setPenToActive();
+            }
+            if (ec->rtti()==RS2::EntityInsert) {
+                ((RS_Insert*)ec)->update();
             }
+			addList.push_back(ec);
         }
     }
 
-    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
-    deselectOriginals(data.number==0);
+    deselectOriginals(selected, data.number==0);
     addNewEntities(addList);
 
     return true;
@@ -1768,19 +1780,28 @@ bool RS_Modification::scale(RS_ScaleData& data) {
         return false;
     }
 
+    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
 	std::vector<RS_Entity*> selectedList,addList;
+	std::vector<RS_Entity*> selected = container->getSelectedEntities();
+	if (data.number==0 && !data.useCurrentLayer && !data.useCurrentAttributes) {
+		// circles and arcs scaled non-uniformly become ellipses below
+		std::unique_ptr<LC_UndoTransform> transform{new LC_UndoTransform};
+		transform->scale(data.referencePoint, data.factor);
+		selected = transformInPlace(selected, std::move(transform), false);
+	}
+	// only the clones need the draw order of their originals
+	container->sortInContainerOrder(selected);
 
-	for(auto ec: *container){
-        if (ec->isSelected() ) {
-            if ( fabs(data.factor.x - data.factor.y) > RS_TOLERANCE ) {
-                    if ( ec->rtti() == RS2::EntityCircle ) {
+	for(auto ec: selected){
+        if ( fabs(data.factor.x - data.factor.y) > RS_TOLERANCE ) {
+                if ( ec->rtti() == RS2::EntityCircle ) {
     //non-isotropic scaling, replacing selected circles with ellipses
 				RS_Circle *c=static_cast<RS_Circle*>(ec);
 				ec= new RS_Ellipse{container,
 				{c->getCenter(), {c->getRadius(),0.},
 						1.,
 						0., 0., false}};
-            } else if ( ec->rtti() == RS2::EntityArc ) {
+        } else if ( ec->rtti() == RS2::EntityArc ) {
     //non-isotropic scaling, replacing selected arcs with ellipses
 				RS_Arc *c=static_cast<RS_Arc*>(ec);
 				ec= new RS_Ellipse{container,
@@ -1790,11 +1811,9 @@ bool RS_Modification::scale(RS_ScaleData& data) {
 								   c->getAngle1(),
 								   c->getAngle2(),
 								   c->isReversed()}};
-            }
-            }
-			selectedList.push_back(ec);
-
         }
+        }
+			selectedList.push_back(ec);
     }
 
     // Create new entities
@@ -1827,8 +1846,7 @@ bool RS_Modification::scale(RS_ScaleData& data) {
         }
     }
 
-    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
-    deselectOriginals(data.number==0);
+    deselectOriginals(selected, data.number==0);
     addNewEntities(addList);
 
     return true;
@@ -1847,37 +1865,42 @@ bool RS_Modification::mirror(RS_MirrorData& data) {
         return false;
     }
 
+    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
 	std::vector<RS_Entity*> addList;
+	std::vector<RS_Entity*> selected = container->getSelectedEntities();
+	if (data.copy==false && !data.useCurrentLayer && !data.useCurrentAttributes) {
+		std::unique_ptr<LC_UndoTransform> transform{new LC_UndoTransform};
+		transform->mirror(data.axisPoint1, data.axisPoint2);
+		selected = transformInPlace(selected, std::move(transform), false);
+	}
+	// only the clones need the draw order of their originals
+	container->sortInContainerOrder(selected);
 
     // Create new entities
     for (int num=1;
             num<=(int)data.copy || (data.copy==false && num<=1);
 			++num) {
-		for(auto e: *container){
+		for(auto e: selected){
             //for (unsigned i=0; i<container->count(); ++i) {
             //RS_Entity* e = container->entityAt(i);
+            RS_Entity* ec = e->clone();
+            ec->setSelected(false);
 
-            if (e && e->isSelected()) {
-                RS_Entity* ec = e->clone();
-                ec->setSelected(false);
-
-                ec->mirror(data.axisPoint1, data.axisPoint2);
-                if (data.useCurrentLayer) {
-                    ec->setLayerToActive();
-                }
-                if (data.useCurrentAttributes) {
-                    ec->setPenToActive();
-                }
-                if (ec->rtti()==RS2::EntityInsert) {
-                    ((RS_Insert*)ec)->update();
-                }
-				addList.push_back(ec);
+            ec->mirror(data.axisPoint1, data.axisPoint2);
+            if (data.useCurrentLayer) {
+                ec->setLayerToActive();
+            }
+            if (data.useCurrentAttributes) {
+                ec->setPenToActive();
             }
+            if (ec->rtti()==RS2::EntityInsert) {
+                ((RS_Insert*)ec)->update();
+            }
+			addList.push_back(ec);
         }
     }
 
-    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
-    deselectOriginals(data.copy==false);
+    deselectOriginals(selected, data.copy==false);
     addNewEntities(addList);
 
     return true;
@@ -1895,42 +1918,50 @@ bool RS_Modification::rotate2(RS_Rotate2Data& data) {
         return false;
     }
 
+    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
 	std::vector<RS_Entity*> addList;
+	std::vector<RS_Entity*> selected = container->getSelectedEntities();
+	if (data.number==0 && !data.useCurrentLayer && !data.useCurrentAttributes) {
+		std::unique_ptr<LC_UndoTransform> transform{new LC_UndoTransform};
+		transform->rotate(data.center1, data.angle1);
+		RS_Vector center2 = data.center2;
+		center2.rotate(data.center1, data.angle1);
+		transform->rotate(center2, data.angle2);
+		selected = transformInPlace(selected, std::move(transform), false);
+	}
+	// only the clones need the draw order of their originals
+	container->sortInContainerOrder(selected);
 
     // Create new entities
     for (int num=1;
             num<=data.number || (data.number==0 && num<=1);
             num++) {
 
-		for(auto e: *container){
+		for(auto e: selected){
             //for (unsigned i=0; i<container->count(); ++i) {
             //RS_Entity* e = container->entityAt(i);
+            RS_Entity* ec = e->clone();
+            ec->setSelected(false);
 
-            if (e && e->isSelected()) {
-                RS_Entity* ec = e->clone();
-                ec->setSelected(false);
-
-                ec->rotate(data.center1, data.angle1*num);
-                RS_Vector center2 = data.center2;
-                center2.rotate(data.center1, data.angle1*num);
+            ec->rotate(data.center1, data.angle1*num);
+            RS_Vector center2 = data.center2;
+            center2.rotate(data.center1, data.angle1*num);
 
-                ec->rotate(center2, data.angle2*num);
-                if (data.useCurrentLayer) {
-                    ec->setLayerToActive();
-                }
-                if (data.useCurrentAttributes) {
-                    ec->setPenToActive();
-                }
-                if (ec->rtti()==RS2::EntityInsert) {
-                    ((RS_Insert*)ec)->update();
-                }
-				addList.push_back(ec);
+            ec->rotate(center2, data.angle2*num);
+            if (data.useCurrentLayer) {
+                ec->setLayerToActive();
+            }
+            if (data.useCurrentAttributes) {
+                ec->setPenToActive();
             }
+            if (ec->rtti()==RS2::EntityInsert) {
+                ((RS_Insert*)ec)->update();
+            }
+			addList.push_back(ec);
         }
     }
 
-    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
-    deselectOriginals(data.number==0);
+    deselectOriginals(selected, data.number==0);
     addNewEntities(addList);
 
     return true;
@@ -1948,39 +1979,45 @@ bool RS_Modification::moveRotate(RS_MoveRotateData& data) {
         return false;
     }
 
+    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
 	std::vector<RS_Entity*> addList;
+	std::vector<RS_Entity*> selected = container->getSelectedEntities();
+	if (data.number==0 && !data.useCurrentLayer && !data.useCurrentAttributes) {
+		std::unique_ptr<LC_UndoTransform> transform{new LC_UndoTransform};
+		transform->move(data.offset);
+		transform->rotate(data.referencePoint + data.offset, data.angle);
+		selected = transformInPlace(selected, std::move(transform), false);
+	}
+	// only the clones need the draw order of their originals
+	container->sortInContainerOrder(selected);
 
     // Create new entities
     for (int num=1;
             num<=data.number || (data.number==0 && num<=1);
 			++num) {
-		for(auto e: *container){
+		for(auto e: selected){
             //for (unsigned i=0; i<container->count(); ++i) {
             //RS_Entity* e = container->entityAt(i);
+            RS_Entity* ec = e->clone();
+            ec->setSelected(false);
 
-            if (e && e->isSelected()) {
-                RS_Entity* ec = e->clone();
-                ec->setSelected(false);
-
-                ec->move(data.offset*num);
-                ec->rotate(data.referencePoint + data.offset*num,
-                           data.angle*num);
-                if (data.useCurrentLayer) {
-                    ec->setLayerToActive();
-                }
-                if (data.useCurrentAttributes) {
-                    ec->setPenToActive();
-                }
-                if (ec->rtti()==RS2::EntityInsert) {
-                    ((RS_Insert*)ec)->update();
-                }
-				addList.push_back(ec);
+            ec->move(data.offset*num);
+            ec->rotate(data.referencePoint + data.offset*num,
+                       data.angle*num);
+            if (data.useCurrentLayer) {
+                ec->setLayerToActive();
+            }
+            if (data.useCurrentAttributes) {
+                ec->setPenToActive();
+            }
+            if (ec->rtti()==RS2::EntityInsert) {
+                ((RS_Insert*)ec)->update();
             }
+			addList.push_back(ec);
         }
     }
 
-    LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
-    deselectOriginals(data.number==0);
+    deselectOriginals(selected, data.number==0);
     addNewEntities(addList);
 
     return true;
@@ -1994,49 +2031,72 @@ bool RS_Modification::moveRotate(RS_MoveRotateData& data) {
  * @param remove true: Remove entities.
  */
 void RS_Modification::deselectOriginals(bool remove)
+{
+    deselectOriginals(container->getSelectedEntities(), remove);
+}
+
+
+
+/**
+ * Deselects the given entities and removes them if remove is true.
+ */
+void RS_Modification::deselectOriginals(const std::vector<RS_Entity*>& originals, bool remove)
 {
     LC_UndoSection undo( document, handleUndo);
 
-    for (auto e: *container) {
+    for (auto e: originals) {
+        e->setSelected(false);
+        if (remove) {
+            e->changeUndoState();
+            undo.addUndoable(e);
+        }
+    }
+}
 
-        //for (unsigned i=0; i<container->count(); ++i) {
-        //RS_Entity* e = container->entityAt(i);
 
-        if (e) {
-            bool selected = false;
-
-            /*
-                  if (e->isAtomic()) {
-                      RS_AtomicEntity* ae = (RS_AtomicEntity*)e;
-                      if (ae->isStartpointSelected() ||
-                              ae->isEndpointSelected()) {
-
-                          selected = true;
-                      }
-                  }
-            */
-
-            if (e->isSelected()) {
-                selected = true;
-            }
-
-            if (selected) {
-                e->setSelected(false);
-                if (remove
-                   ) {
-                    //if (graphicView) {
-                    //    graphicView->deleteEntity(e);
-                    //}
-                    e->changeUndoState();
-                    undo.addUndoable(e);
-                } else {
-                    //if (graphicView) {
-                    //    graphicView->drawEntity(e);
-                    //}
-                }
-            }
+
+/**
+ * Transforms the selected entities in place, if they are not copied.
+ * The undo cycle keeps only the defining values of the entities then instead
+ * of the originals and transformed clones.
+ *
+ * @param selected The selected entities.
+ * @param transform The transform, applied to the entities which the undo
+ *        record can restore exactly, see LC_UndoTransform::isInvertible().
+ * @param keepSelected false: deselect the transformed entities.
+ * @return The entities left for the clone and replace path, e.g. polylines
+ *         or circles which become ellipses.
+ */
+std::vector<RS_Entity*> RS_Modification::transformInPlace(const std::vector<RS_Entity*>& selected,
+                                                          std::unique_ptr<LC_UndoTransform> transform,
+                                                          bool keepSelected)
+{
+    if (!document || !handleUndo) {
+        return selected;
+    }
+
+    std::vector<RS_Entity*> rest;
+    for (auto e: selected) {
+        if (transform->isInvertible(e)) {
+            transform->addEntity(e);
+        } else {
+            rest.push_back(e);
+        }
+    }
+    if (transform->isEmpty()) {
+        return rest;
+    }
+
+    transform->apply();
+    if (!keepSelected) {
+        for (auto e: transform->getEntities()) {
+            e->setSelected(false);
         }
     }
+
+    LC_UndoSection undo( document, handleUndo);
+    undo.addTransform(std::move(transform));
+    return rest;
 }
 
 
@@ -3023,87 +3083,94 @@ bool RS_Modification::explode(const bool remove /*= true*/)
 
 	std::vector<RS_Entity*> addList;
 
-    for(auto e: *container){
+    for(auto e: container->getSelectedEntitiesInOrder()){
         //for (unsigned i=0; i<container->count(); ++i) {
         //RS_Entity* e = container->entityAt(i);
+        if (e->isContainer()) {
 
-        if (e && e->isSelected()) {
-            if (e->isContainer()) {
-
-                // add entities from container:
-                RS_EntityContainer* ec = (RS_EntityContainer*)e;
-                //ec->setSelected(false);
-
-                // iterate and explode container:
-                //for (unsigned i2=0; i2<ec->count(); ++i2) {
-                //    RS_Entity* e2 = ec->entityAt(i2);
-                RS2::ResolveLevel rl;
-                bool resolvePen;
-                bool resolveLayer;
-
-                switch (ec->rtti()) {
-                case RS2::EntityMText:
-                case RS2::EntityText:
-                case RS2::EntityHatch:
-                case RS2::EntityPolyline:
-                    rl = RS2::ResolveAll;
-                    resolveLayer = true;
-                    resolvePen = false;
-                    break;
-
-                case RS2::EntityInsert:
-                    resolvePen = false;
-                    resolveLayer = false;
-                    rl = RS2::ResolveNone;
-                    break;
-
-                case RS2::EntityDimAligned:
-                case RS2::EntityDimLinear:
-                case RS2::EntityDimRadial:
-                case RS2::EntityDimDiametric:
-                case RS2::EntityDimAngular:
-                case RS2::EntityDimLeader:
-                    rl = RS2::ResolveNone;
-                    resolveLayer = true;
-                    resolvePen = false;
-                    break;
+            // add entities from container:
+            RS_EntityContainer* ec = (RS_EntityContainer*)e;
+            //ec->setSelected(false);
+
+            // iterate and explode container:
+            //for (unsigned i2=0; i2<ec->count(); ++i2) {
+            //    RS_Entity* e2 = ec->entityAt(i2);
+            RS2::ResolveLevel rl;
+            bool resolvePen;
+            bool resolveLayer;
+
+            switch (ec->rtti()) {
+            case RS2::EntityMText:
+            case RS2::EntityText:
+            case RS2::EntityHatch:
+            case RS2::EntityPolyline:
+                rl = RS2::ResolveAll;
+                resolveLayer = true;
+                resolvePen = false;
+                break;
+
+            case RS2::EntityInsert:
+                resolvePen = false;
+                resolveLayer = false;
+                rl = RS2::ResolveNone;
+                break;
+
+            case RS2::EntityDimAligned:
+            case RS2::EntityDimLinear:
+            case RS2::EntityDimRadial:
+            case RS2::EntityDimDiametric:
+            case RS2::EntityDimAngular:
+            case RS2::EntityDimLeader:
+                rl = RS2::ResolveNone;
+                resolveLayer = true;
+                resolvePen = false;
+                break;
+
+            default:
+                rl = RS2::ResolveAll;
+                resolveLayer = true;
+                resolvePen = false;
+                break;
+            }
 
-                default:
-                    rl = RS2::ResolveAll;
-                    resolveLayer = true;
-                    resolvePen = false;
-                    break;
-                }
+            std::unique_ptr<RS_EntityContainer> letters;
+            if (ec->rtti()==RS2::EntityText || ec->rtti()==RS2::EntityMText) {
+                letters.reset(static_cast<RS_EntityContainer*>(ec->clone()));
+                materializeLetters(letters.get());
+                ec = letters.get();
+            }
+            if (ec->rtti()==RS2::EntityInsert) {
+                static_cast<RS_Insert*>(ec)->materialize();
+            }
 
-                for (RS_Entity* e2 = ec->firstEntity(rl); e2;
-                        e2 = ec->nextEntity(rl)) {
+            for (RS_Entity* e2 = ec->firstEntity(rl); e2;
+                    e2 = ec->nextEntity(rl)) {
 
-                    if (e2) {
-                        RS_Entity* clone = e2->clone();
-                        clone->setSelected(false);
-                        clone->reparent(container);
+                if (e2) {
+                    RS_Entity* clone = e2->clone();
+                    clone->setSelected(false);
+                    clone->reparent(container);
 
-                        if (resolveLayer) {
-                            clone->setLayer(ec->getLayer());
-                        } else {
-                            clone->setLayer(e2->getLayer());
-                        }
+                    if (resolveLayer) {
+                        clone->setLayer(ec->getLayer());
+                    } else {
+                        clone->setLayer(e2->getLayer());
+                    }
 
 //                        clone->setPen(ec->getPen(resolvePen));
-                        if (resolvePen) {
-                            clone->setPen(ec->getPen(true));
-                        } else {
-                            clone->setPen(e2->getPen(false));
-                        }
+                    if (resolvePen) {
+                        clone->setPen(ec->getPen(true));
+                    } else {
+                        clone->setPen(e2->getPen(false));
+                    }
 
-						addList.push_back(clone);
+					addList.push_back(clone);
 
-                        clone->update();
-                    }
+                    clone->update();
                 }
-            } else {
-                e->setSelected(false);
             }
+        } else {
+            e->setSelected(false);
         }
     }
 
@@ -3126,19 +3193,17 @@ bool RS_Modification::explodeTextIntoLetters() {
 
 	std::vector<RS_Entity*> addList;
 
-	for(auto e: *container){
-        if (e && e->isSelected()) {
-            if (e->rtti()==RS2::EntityMText) {
-                // add letters of text:
-                RS_MText* text = (RS_MText*)e;
-                explodeTextIntoLetters(text, addList);
-            } else if (e->rtti()==RS2::EntityText) {
-                // add letters of text:
-                RS_Text* text = (RS_Text*)e;
-                explodeTextIntoLetters(text, addList);
-            } else {
-                e->setSelected(false);
-            }
+	for(auto e: container->getSelectedEntitiesInOrder()){
+        if (e->rtti()==RS2::EntityMText) {
+            // add letters of text:
+            RS_MText* text = (RS_MText*)e;
+            explodeTextIntoLetters(text, addList);
+        } else if (e->rtti()==RS2::EntityText) {
+            // add letters of text:
+            RS_Text* text = (RS_Text*)e;
+            explodeTextIntoLetters(text, addList);
+        } else {
+            e->setSelected(false);
         }
     }
 
@@ -3271,15 +3336,13 @@ bool RS_Modification::moveRef(RS_MoveRefData& data) {
 	std::vector<RS_Entity*> addList;
 
     // Create new entities
-	for(auto e: *container){
-		if (e && e->isSelected()) {
-            RS_Entity* ec = e->clone();
+	for(auto e: container->getSelectedEntitiesInOrder()){
+        RS_Entity* ec = e->clone();
 
-            ec->moveRef(data.ref, data.offset);
-            // since 2.0.4.0: keep it selected
-            ec->setSelected(true);
-			addList.push_back(ec);
-        }
+        ec->moveRef(data.ref, data.offset);
+        // since 2.0.4.0: keep it selected
+        ec->setSelected(true);
+		addList.push_back(ec);
     }
 
     LC_UndoSection undo( document, handleUndo); // bundle remove/add entities in one undoCycle
@@ -27,10 +27,13 @@
 #ifndef RS_MODIFICATION_H
 #define RS_MODIFICATION_H
 
+#include <memory>
+#include <vector>
 #include "rs_vector.h"
 #include "rs_pen.h"
 #include <QHash>
 
+class LC_UndoTransform;
 class RS_AtomicEntity;
 class RS_Entity;
 class RS_EntityContainer;
@@ -293,6 +296,10 @@ public:
 
 private:
     void deselectOriginals(bool remove);
+    void deselectOriginals(const std::vector<RS_Entity*>& originals, bool remove);
+    std::vector<RS_Entity*> transformInPlace(const std::vector<RS_Entity*>& selected,
+                                             std::unique_ptr<LC_UndoTransform> transform,
+                                             bool keepSelected);
 	void addNewEntities(std::vector<RS_Entity*>& addList);
 	bool explodeTextIntoLetters(RS_MText* text, std::vector<RS_Entity*>& addList);
 	bool explodeTextIntoLetters(RS_Text* text, std::vector<RS_Entity*>& addList);
@@ -32,6 +32,9 @@
 #include "rs_entity.h"
 #include "rs_graphic.h"
 #include "rs_layer.h"
+#include "lc_endpointindex.h"
+#include "lc_spatialindex.h"
+#include "lc_rect.h"
 
 
 
@@ -152,38 +155,40 @@ void RS_Selection::selectIntersected(const RS_Vector& v1, const RS_Vector& v2,
                                      bool select) {
 
 	RS_Line line{v1, v2};
-    bool inters;
-
-	for(auto e: *container){
-    //for (unsigned i=0; i<container->count(); ++i) {
-        //RS_Entity* e = container->entityAt(i);
+	LC_Rect const lineBox{v1, v2};
+	// only entities with extents overlapping the line can intersect it
+	auto crossesLine = [&line, &lineBox](RS_Entity* e) {
+		if (e->rtti() != RS2::EntityConstructionLine
+				&& !lineBox.intersects(LC_Rect{e->getMin(), e->getMax()})) {
+			return false;
+		}
+		return RS_Information::getIntersection(&line, e, true).hasValid();
+	};
+
+	std::vector<RS_Entity*> candidates;
+	const LC_SpatialIndex* index = container->getSpatialIndex();
+	if (index) {
+		candidates = index->query(lineBox, false);
+	} else {
+		candidates.assign(container->begin(), container->end());
+	}
+
+	for(auto e: candidates){
 
         if (e && e->isVisible()) {
 
-            inters = false;
+            bool inters = false;
 
             // select containers / groups:
             if (e->isContainer()) {
                 RS_EntityContainer* ec = (RS_EntityContainer*)e;
 
-                for (RS_Entity* e2=ec->firstEntity(RS2::ResolveAll); e2;
+                for (RS_Entity* e2=ec->firstEntity(RS2::ResolveAll); e2 && !inters;
                         e2=ec->nextEntity(RS2::ResolveAll)) {
-
-                    RS_VectorSolutions sol =
-                        RS_Information::getIntersection(&line, e2, true);
-
-                    if (sol.hasValid()) {
-                        inters = true;
-                    }
+                    inters = crossesLine(e2);
                 }
             } else {
-
-                RS_VectorSolutions sol =
-                    RS_Information::getIntersection(&line, e, true);
-
-                if (sol.hasValid()) {
-                    inters = true;
-                }
+                inters = crossesLine(e);
             }
 
             if (inters) {
@@ -223,7 +228,6 @@ void RS_Selection::selectContour(RS_Entity* e) {
     RS_AtomicEntity* ae = (RS_AtomicEntity*)e;
     RS_Vector p1 = ae->getStartpoint();
     RS_Vector p2 = ae->getEndpoint();
-    bool found = false;
 
     // (de)select 1st entity:
     if (graphicView) {
@@ -234,57 +238,33 @@ void RS_Selection::selectContour(RS_Entity* e) {
         graphicView->drawEntity(e);
     }
 
-    do {
-        found = false;
-
-		for(auto en: *container){
-        //for (unsigned i=0; i<container->count(); ++i) {
-            //RS_Entity* en = container->entityAt(i);
-
-            if (en && en->isVisible() && 
-				en->isAtomic() && en->isSelected()!=select && 
-				(!(en->getLayer() && en->getLayer()->isLocked()))) {
-
-                ae = (RS_AtomicEntity*)en;
-                bool doit = false;
-
-                // startpoint connects to 1st point
-                if (ae->getStartpoint().distanceTo(p1)<1.0e-4) {
-                    doit = true;
-                    p1 = ae->getEndpoint();
-                }
-
-                // endpoint connects to 1st point
-                else if (ae->getEndpoint().distanceTo(p1)<1.0e-4) {
-                    doit = true;
-                    p1 = ae->getStartpoint();
-                }
-
-                // startpoint connects to 2nd point
-                else if (ae->getStartpoint().distanceTo(p2)<1.0e-4) {
-                    doit = true;
-                    p2 = ae->getEndpoint();
-                }
+    // endpoints of all entities, which could be added to the contour
+    LC_EndpointIndex index(1.0e-4);
+	for(auto en: *container){
+        if (en && en->isVisible() &&
+            en->isAtomic() && en->isSelected()!=select &&
+            (!(en->getLayer() && en->getLayer()->isLocked()))) {
+            index.insert(en);
+        }
+    }
 
-                // endpoint connects to 1st point
-                else if (ae->getEndpoint().distanceTo(p2)<1.0e-4) {
-                    doit = true;
-                    p2 = ae->getStartpoint();
-                }
+    // follow the contour from both ends of the 1st entity
+    for (RS_Vector* p: {&p1, &p2}) {
+        LC_EndpointIndex::Endpoint next;
+        while (index.findNearest(*p, next)) {
+            ae = (RS_AtomicEntity*)next.entity;
+            index.remove(ae);
+            *p = next.start ? ae->getEndpoint() : ae->getStartpoint();
 
-                if (doit) {
-                    if (graphicView) {
-                        graphicView->deleteEntity(ae);
-                    }
-                    ae->setSelected(select);
-                    if (graphicView) {
-                        graphicView->drawEntity(ae);
-                    }
-                    found = true;
-                }
+            if (graphicView) {
+                graphicView->deleteEntity(ae);
+            }
+            ae->setSelected(select);
+            if (graphicView) {
+                graphicView->drawEntity(ae);
             }
         }
-    } while(found);
+    }
 }
 
 
@@ -0,0 +1,414 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <QtCore>
+#include <QCoreApplication>
+#include <QApplication>
+#include <QImage>
+#include <QMouseEvent>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+#include "rs_debug.h"
+#include "rs_fontlist.h"
+#include "rs_graphic.h"
+#include "rs_information.h"
+#include "rs_line.h"
+#include "rs_modification.h"
+#include "rs_painterqt.h"
+#include "rs_patternlist.h"
+#include "rs_selection.h"
+#include "rs_settings.h"
+#include "rs_snapper.h"
+#include "rs_staticgraphicview.h"
+#include "rs_system.h"
+
+#include "main.h"
+
+#include "console_benchmark.h"
+
+
+namespace {
+
+/** Parameters of one benchmark run. */
+struct BenchmarkParams {
+    QString dxfFile;
+    QString outFile;  // If empty, print to stdout.
+    int width = 1024;
+    int height = 768;
+    int frames = 10;
+    int snapGrid = 20;  // Snap queries per row and column of the view.
+    int trims = 50;
+};
+
+double seconds(const QElapsedTimer& timer)
+{
+    return std::max(timer.nsecsElapsed()*1e-9, 1e-9);
+}
+
+/**
+ * @return peak resident set size of the process in kB, -1 if the platform
+ * does not report it
+ */
+qint64 peakRss()
+{
+#if defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#if defined(Q_OS_MAC)
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
+
+QJsonObject phase(const QString& name, double secs)
+{
+    QJsonObject p;
+    p["name"] = name;
+    p["seconds"] = secs;
+    return p;
+}
+
+/**
+ * Renders frames of the view into an image the same way
+ * QG_GraphicView::paintEvent() does: background and grid first,
+ * then the entities.
+ */
+QJsonObject benchmarkRendering(RS_StaticGraphicView& view, double zoom,
+    int frames)
+{
+    QImage image(view.getWidth(), view.getHeight(), QImage::Format_ARGB32);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < frames; i++) {
+        image.fill(view.getBackground());
+        RS_PainterQt painter(&image);
+        view.drawLayer1(&painter);
+        view.drawLayer2(&painter);
+        painter.end();
+    }
+    double secs = seconds(timer);
+
+    QJsonObject p = phase("render", secs);
+    p["zoom"] = zoom;
+    p["frames"] = frames;
+    p["fps"] = frames / secs;
+    return p;
+}
+
+/**
+ * Moves a mouse over a grid of points of the view and snaps each point
+ * to end points, centers, intersections and entities.
+ */
+QJsonObject benchmarkSnapping(RS_EntityContainer& container,
+    RS_StaticGraphicView& view, int grid)
+{
+    RS_Snapper snapper(container, view);
+    snapper.init();
+
+    RS_SnapMode mode;
+    mode.snapEndpoint = true;
+    mode.snapCenter = true;
+    mode.snapIntersection = true;
+    mode.snapOnEntity = true;
+    snapper.setSnapMode(mode);
+
+    int hits = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < grid; i++) {
+        for (int j = 0; j < grid; j++) {
+            QPointF pos((i + 0.5) * view.getWidth() / grid,
+                        (j + 0.5) * view.getHeight() / grid);
+            QMouseEvent event(QEvent::MouseMove, pos, Qt::NoButton,
+                              Qt::NoButton, Qt::NoModifier);
+            if (snapper.snapPoint(&event) != view.toGraph(event.x(), event.y()))
+                hits++;
+        }
+    }
+    double secs = seconds(timer);
+    snapper.finish();
+
+    QJsonObject p = phase("snap", secs);
+    p["queries"] = grid * grid;
+    p["snapped"] = hits;
+    p["queriesPerSecond"] = grid * grid / secs;
+    return p;
+}
+
+/**
+ * Trims up to count lines of the drawing to another line crossing them.
+ * Finding the pairs is not timed.
+ */
+QJsonObject benchmarkTrimming(RS_Graphic& graphic, RS_StaticGraphicView& view,
+    int count)
+{
+    const size_t maxLines = 500;
+
+    std::vector<RS_Line*> lines;
+    for (RS_Entity* e: graphic) {
+        if (e->rtti() == RS2::EntityLine && e->isVisible())
+            lines.push_back(static_cast<RS_Line*>(e));
+        if (lines.size() >= maxLines)
+            break;
+    }
+
+    struct Trim {
+        RS_Line* trimEntity;
+        RS_Line* limitEntity;
+        RS_Vector limitCoord;
+    };
+    std::vector<Trim> trims;
+    std::vector<bool> used(lines.size(), false);
+    for (size_t i = 0; i < lines.size() && int(trims.size()) < count; i++) {
+        for (size_t j = i + 1; j < lines.size() && !used[i]; j++) {
+            if (used[j])
+                continue;
+            RS_VectorSolutions sol = RS_Information::getIntersection(
+                lines[i], lines[j], true);
+            if (sol.getNumber() == 0)
+                continue;
+            trims.push_back({lines[i], lines[j], sol.get(0)});
+            used[i] = used[j] = true;
+        }
+    }
+
+    RS_Modification modification(graphic, &view);
+    int trimmed = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (const Trim& t: trims) {
+        if (modification.trim(t.trimEntity->getStartpoint(), t.trimEntity,
+                               t.limitCoord, t.limitEntity, false))
+            trimmed++;
+    }
+    double secs = seconds(timer);
+
+    QJsonObject p = phase("trim", secs);
+    p["attempts"] = int(trims.size());
+    p["trimmed"] = trimmed;
+    return p;
+}
+
+QJsonObject runBenchmark(const BenchmarkParams& params)
+{
+    QJsonObject result;
+    QJsonArray phases;
+    result["file"] = params.dxfFile;
+    result["width"] = params.width;
+    result["height"] = params.height;
+
+    QElapsedTimer timer;
+    timer.start();
+    std::unique_ptr<RS_Graphic> graphic(new RS_Graphic());
+    bool opened = graphic->open(params.dxfFile, RS2::FormatUnknown);
+    phases.append(phase("load", seconds(timer)));
+    if (!opened) {
+        result["error"] = QString("Failed to open document");
+        result["phases"] = phases;
+        return result;
+    }
+    result["entities"] = int(graphic->count());
+
+    RS_StaticGraphicView view(params.width, params.height, nullptr);
+    view.setContainer(graphic.get());
+
+    timer.start();
+    view.zoomAuto(false);
+    phases.append(phase("zoomAuto", seconds(timer)));
+
+    // Zoom in around the center of the drawing, every level shows a quarter
+    // of the area of the previous one.
+    RS_Vector center = (graphic->getMin() + graphic->getMax()) * 0.5;
+    for (double zoom: {1.0, 2.0, 4.0, 8.0}) {
+        view.zoomAuto(false);
+        if (zoom > 1.0)
+            view.zoomIn(zoom, center);
+        phases.append(benchmarkRendering(view, zoom, params.frames));
+    }
+
+    view.zoomAuto(false);
+    phases.append(benchmarkSnapping(*graphic, view, params.snapGrid));
+
+    // Select the center quarter of the view, once as a window and once as
+    // a crossing window, and move the last selection.
+    RS_Selection selection(*graphic, &view);
+    RS_Vector v1 = view.toGraph(params.width / 4, params.height / 4);
+    RS_Vector v2 = view.toGraph(params.width * 3 / 4, params.height * 3 / 4);
+    for (bool cross: {false, true}) {
+        selection.deselectAll();
+        timer.start();
+        selection.selectWindow(v1, v2, true, cross);
+        QJsonObject p = phase(cross ? "selectCrossing" : "selectWindow",
+                              seconds(timer));
+        p["selected"] = int(graphic->countSelected());
+        phases.append(p);
+    }
+
+    RS_Modification modification(*graphic, &view);
+    RS_MoveData moveData;
+    moveData.number = 0;
+    moveData.useCurrentAttributes = false;
+    moveData.useCurrentLayer = false;
+    moveData.offset = view.toGraph(10, 0) - view.toGraph(0, 0);
+    timer.start();
+    modification.move(moveData);
+    phases.append(phase("move", seconds(timer)));
+
+    selection.deselectAll();
+    phases.append(benchmarkTrimming(*graphic, view, params.trims));
+
+    result["phases"] = phases;
+    return result;
+}
+
+} // namespace
+
+
+int console_benchmark(int argc, char* argv[])
+{
+    RS_DEBUG->setLevel(RS_Debug::D_NOTHING);
+
+    QApplication app(argc, argv);
+    QCoreApplication::setOrganizationName("LibreCAD");
+    QCoreApplication::setApplicationName("LibreCAD");
+    QCoreApplication::setApplicationVersion(XSTR(LC_VERSION));
+
+    QFileInfo prgInfo(QFile::decodeName(argv[0]));
+    QString prgDir(prgInfo.absolutePath());
+    RS_SETTINGS->init(app.organizationName(), app.applicationName());
+    RS_SYSTEM->init(app.applicationName(), app.applicationVersion(),
+        XSTR(QC_APPDIR), prgDir);
+
+    QCommandLineParser parser;
+
+    QString appDesc = "\nbenchmark usage: " + prgInfo.filePath()
+        + " benchmark [options] <dxf_file>\n";
+    appDesc += "\nLoad a DXF file, render it at several zoom levels, snap,"
+        " select, move and trim, and print the timings of every phase"
+        " and the peak memory use as JSON.";
+    appDesc += "\n\nRun with QT_QPA_PLATFORM=offscreen on machines"
+        " without a display.";
+    parser.setApplicationDescription(appDesc);
+
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption framesOpt(QStringList() << "n" << "frames",
+        "Frames rendered per zoom level (default 10).", "integer");
+    parser.addOption(framesOpt);
+
+    QCommandLineOption sizeOpt(QStringList() << "s" << "size",
+        "View size in pixels (default 1024x768).", "WxH");
+    parser.addOption(sizeOpt);
+
+    QCommandLineOption snapOpt(QStringList() << "g" << "snap-grid",
+        "Snap queries per row and column of the view (default 20).",
+        "integer");
+    parser.addOption(snapOpt);
+
+    QCommandLineOption trimsOpt(QStringList() << "t" << "trims",
+        "Maximum number of lines trimmed (default 50).", "integer");
+    parser.addOption(trimsOpt);
+
+    QCommandLineOption outFileOpt(QStringList() << "o" << "outfile",
+        "Output JSON file, stdout if not given.", "file");
+    parser.addOption(outFileOpt);
+
+    parser.addPositionalArgument("<dxf_file>", "Input DXF file");
+
+    parser.process(app);
+
+    BenchmarkParams params;
+
+    for (auto arg : parser.positionalArguments()) {
+        if (QFileInfo(arg).suffix().toLower() == "dxf") {
+            params.dxfFile = arg;
+            break;
+        }
+    }
+    if (params.dxfFile.isEmpty())
+        parser.showHelp(EXIT_FAILURE);
+
+    bool ok;
+    int frames = parser.value(framesOpt).toInt(&ok);
+    if (ok && frames > 0)
+        params.frames = frames;
+
+    int snapGrid = parser.value(snapOpt).toInt(&ok);
+    if (ok && snapGrid > 0)
+        params.snapGrid = snapGrid;
+
+    int trims = parser.value(trimsOpt).toInt(&ok);
+    if (ok && trims >= 0)
+        params.trims = trims;
+
+    if (parser.isSet(sizeOpt)) {
+        QRegularExpression re("^(?<width>\\d+)[x|X]{1}(?<height>\\d+)$");
+        QRegularExpressionMatch match = re.match(parser.value(sizeOpt));
+        if (match.hasMatch() && match.captured("width").toInt() > 0
+                && match.captured("height").toInt() > 0) {
+            params.width = match.captured("width").toInt();
+            params.height = match.captured("height").toInt();
+        } else {
+            qDebug() << "WARNING: Ignoring bad view size:"
+                     << parser.value(sizeOpt);
+        }
+    }
+
+    params.outFile = parser.value(outFileOpt);
+
+    RS_FONTLIST->init();
+    RS_PATTERNLIST->init();
+
+    QJsonObject result = runBenchmark(params);
+    result["version"] = QCoreApplication::applicationVersion();
+    result["peakRssKiB"] = double(peakRss());
+
+    QFile out(params.outFile);
+    bool opened = params.outFile.isEmpty()
+        ? out.open(stdout, QIODevice::WriteOnly)
+        : out.open(QIODevice::WriteOnly);
+    if (!opened) {
+        qDebug() << "ERROR: Cannot write" << params.outFile;
+        return EXIT_FAILURE;
+    }
+    out.write(QJsonDocument(result).toJson());
+    out.close();
+
+    return result.contains("error") ? EXIT_FAILURE : EXIT_SUCCESS;
+}
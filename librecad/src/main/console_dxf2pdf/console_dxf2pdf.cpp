@@ -31,6 +31,7 @@
 #include "rs_patternlist.h"
 #include "rs_settings.h"
 #include "rs_system.h"
+#include "lc_parallel.h"
 
 #include "main.h"
 
@@ -116,6 +117,11 @@ int console_dxf2pdf(int argc, char* argv[])
         "Target output directory.", "path");
     parser.addOption(outDirOpt);
 
+    QCommandLineOption jobsOpt(QStringList() << "j" << "jobs",
+        "Number of files processed in parallel, 0 for one per CPU core.",
+        "integer");
+    parser.addOption(jobsOpt);
+
     parser.addPositionalArgument("<dxf_files>", "Input DXF file(s)");
 
     parser.process(app);
@@ -143,6 +149,16 @@ int console_dxf2pdf(int argc, char* argv[])
     if (scaleOk)
         params.scale = scale;
 
+    bool jobsOk;
+    int jobs = parser.value(jobsOpt).toInt(&jobsOk);
+    if (jobsOk && jobs >= 0) {
+        params.jobs = jobs;
+        LC_Parallel::setThreadCount(jobs);
+    } else if (parser.isSet(jobsOpt)) {
+        qDebug() << "WARNING: Ignoring bad number of jobs:"
+                 << parser.value(jobsOpt);
+    }
+
     params.outFile = parser.value(outFileOpt);
     params.outDir = parser.value(outDirOpt);
 
@@ -24,27 +24,40 @@
 
 #include <QtCore>
 
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
 #include "rs.h"
+#include "rs_fileio.h"
 #include "rs_graphic.h"
 #include "rs_painterqt.h"
+#include "lc_parallel.h"
 #include "lc_printing.h"
 #include "rs_staticgraphicview.h"
 
 #include "pdf_print_loop.h"
 
 
-static bool openDocAndSetGraphic(RS_Document**, RS_Graphic**, QString&);
-static void touchGraphic(RS_Graphic*, PdfPrintParams&);
-static void setupPrinterAndPaper(RS_Graphic*, QPrinter&, PdfPrintParams&);
+static void forEachFile(const PdfPrintParams&,
+    const std::function<void(size_t)>&);
+static bool openDocAndSetGraphic(RS_Document**, RS_Graphic**, const QString&);
+static void touchGraphic(RS_Graphic*, const PdfPrintParams&);
+static void setupPrinterAndPaper(RS_Graphic*, QPrinter&, const PdfPrintParams&,
+    const QString&);
 static void drawPage(RS_Graphic*, QPrinter&, RS_PainterQt&);
 
 
 void PdfPrintLoop::run()
 {
+    // Create the file io instance before the workers use it.
+    RS_FileIO::instance();
+
     if (params.outFile.isEmpty()) {
-        for (auto f : params.dxfFiles) {
-            printOneDxfToOnePdf(f);
-        }
+        forEachFile(params, [this](size_t i) {
+            printOneDxfToOnePdf(params.dxfFiles.at(i));
+        });
     } else {
         printManyDxfToOnePdf();
     }
@@ -53,14 +66,14 @@ void PdfPrintLoop::run()
 }
 
 
-void PdfPrintLoop::printOneDxfToOnePdf(QString& dxfFile) {
+void PdfPrintLoop::printOneDxfToOnePdf(const QString& dxfFile) {
 
     // Main code logic and flow for this method is originally stolen from
     // QC_ApplicationWindow::slotFilePrint(bool printPDF) method.
     // But finally it was splitted in smaller parts.
 
     QFileInfo dxfFileInfo(dxfFile);
-    params.outFile =
+    QString outFile =
         (params.outDir.isEmpty() ? dxfFileInfo.path() : params.outDir)
         + "/" + dxfFileInfo.completeBaseName() + ".pdf";
 
@@ -70,13 +83,13 @@ void PdfPrintLoop::printOneDxfToOnePdf(QString& dxfFile) {
     if (!openDocAndSetGraphic(&doc, &graphic, dxfFile))
         return;
 
-    qDebug() << "Printing" << dxfFile << "to" << params.outFile << ">>>>";
+    qDebug() << "Printing" << dxfFile << "to" << outFile << ">>>>";
 
     touchGraphic(graphic, params);
 
     QPrinter printer(QPrinter::HighResolution);
 
-    setupPrinterAndPaper(graphic, printer, params);
+    setupPrinterAndPaper(graphic, printer, params, outFile);
 
     RS_PainterQt painter(&printer);
 
@@ -87,7 +100,7 @@ void PdfPrintLoop::printOneDxfToOnePdf(QString& dxfFile) {
 
     painter.end();
 
-    qDebug() << "Printing" << dxfFile << "to" << params.outFile << "DONE";
+    qDebug() << "Printing" << dxfFile << "to" << outFile << "DONE";
 
     delete doc;
 }
@@ -95,82 +108,86 @@ void PdfPrintLoop::printOneDxfToOnePdf(QString& dxfFile) {
 
 void PdfPrintLoop::printManyDxfToOnePdf() {
 
-    struct DxfPage {
-        RS_Document* doc;
-        RS_Graphic* graphic;
-        QString dxfFile;
-        QPrinter::PageSize paperSize;
-    };
-
+    QString outFile = params.outFile;
     if (!params.outDir.isEmpty()) {
         QFileInfo outFileInfo(params.outFile);
-        params.outFile = params.outDir + "/" + outFileInfo.fileName();
+        outFile = params.outDir + "/" + outFileInfo.fileName();
     }
 
-    QVector<DxfPage> pages;
-    int nrPages = 0;
-
-    // FIXME: Should probably open and print all dxf files in one 'for' loop.
-    // Tried but failed to do this. It looks like some 'chicken and egg'
-    // situation for the QPrinter and RS_PainterQt. Therefore, first open
-    // all dxf files and apply required actions. Then run another 'for'
-    // loop for actual printing.
-    for (auto dxfFile : params.dxfFiles) {
-
-        DxfPage page;
-
-        page.dxfFile = dxfFile;
-
-        if (!openDocAndSetGraphic(&page.doc, &page.graphic, dxfFile))
-            continue;
+    QPrinter printer(QPrinter::HighResolution);
+    std::unique_ptr<RS_PainterQt> painter;
+
+    // The dxf files are opened concurrently, but their pages are printed
+    // in input order, one after another. Every document is deleted right
+    // after its page, so at most one document per job is kept in memory.
+    std::mutex printMutex;
+    std::condition_variable printTurn;
+    size_t nextPage = 0;
+
+    forEachFile(params, [&](size_t i) {
+        const QString& dxfFile = params.dxfFiles.at(i);
+        RS_Document* doc = nullptr;
+        RS_Graphic* graphic = nullptr;
+
+        bool opened = openDocAndSetGraphic(&doc, &graphic, dxfFile);
+        if (opened) {
+            qDebug() << "Opened" << dxfFile;
+            touchGraphic(graphic, params);
+        }
 
-        qDebug() << "Opened" << dxfFile;
+        std::unique_lock<std::mutex> lock(printMutex);
+        printTurn.wait(lock, [&]() { return nextPage == i; });
 
-        touchGraphic(page.graphic, params);
+        if (opened) {
+            if (painter) {
+                printer.newPage();
+            } else {
+                // FIXME: Is it possible to set up printer and paper for every
+                // opened dxf file and tie them with painter? For now just using
+                // data extracted from the first opened dxf file for all pages.
+                setupPrinterAndPaper(graphic, printer, params, outFile);
+                painter.reset(new RS_PainterQt(&printer));
+                if (params.monochrome)
+                    painter->setDrawingMode(RS2::ModeBW);
+            }
 
-        pages.append(page);
+            qDebug() << "Printing" << dxfFile
+                     << "to" << outFile << ">>>>";
 
-        nrPages++;
-    }
+            drawPage(graphic, printer, *painter);
 
-    QPrinter printer(QPrinter::HighResolution);
+            qDebug() << "Printing" << dxfFile
+                     << "to" << outFile << "DONE";
 
-    if (nrPages > 0) {
-        // FIXME: Is it possible to set up printer and paper for every
-        // opened dxf file and tie them with painter? For now just using
-        // data extracted from the first opened dxf file for all pages.
-        setupPrinterAndPaper(pages.at(0).graphic, printer, params);
-    }
-
-    RS_PainterQt painter(&printer);
-
-    if (params.monochrome)
-        painter.setDrawingMode(RS2::ModeBW);
-
-    // And now it's time to actually print all previously opened dxf files.
-    for (auto page : pages) {
-        nrPages--;
+            delete doc;
+        }
 
-        qDebug() << "Printing" << page.dxfFile
-                 << "to" << params.outFile << ">>>>";
+        nextPage++;
+        printTurn.notify_all();
+    });
 
-        drawPage(page.graphic, printer, painter);
+    if (painter)
+        painter->end();
+}
 
-        qDebug() << "Printing" << page.dxfFile
-                 << "to" << params.outFile << "DONE";
 
-        delete page.doc;
+static void forEachFile(const PdfPrintParams& params,
+    const std::function<void(size_t)>& task)
+{
+    size_t count = params.dxfFiles.size();
 
-        if (nrPages > 0)
-            printer.newPage();
+    if (params.jobs == 1) {
+        for (size_t i = 0; i < count; i++)
+            task(i);
+    } else {
+        // The number of threads was set from params.jobs.
+        LC_Parallel::forEach(count, task);
     }
-
-    painter.end();
 }
 
 
 static bool openDocAndSetGraphic(RS_Document** doc, RS_Graphic** graphic,
-    QString& dxfFile)
+    const QString& dxfFile)
 {
     *doc = new RS_Graphic();
 
@@ -191,7 +208,7 @@ static bool openDocAndSetGraphic(RS_Document** doc, RS_Graphic** graphic,
 }
 
 
-static void touchGraphic(RS_Graphic* graphic, PdfPrintParams& params)
+static void touchGraphic(RS_Graphic* graphic, const PdfPrintParams& params)
 {
     graphic->calculateBorders();
 
@@ -209,7 +226,7 @@ static void touchGraphic(RS_Graphic* graphic, PdfPrintParams& params)
 
 
 static void setupPrinterAndPaper(RS_Graphic* graphic, QPrinter& printer,
-    PdfPrintParams& params)
+    const PdfPrintParams& params, const QString& outFile)
 {
     bool landscape = false;
 
@@ -233,7 +250,7 @@ static void setupPrinterAndPaper(RS_Graphic* graphic, QPrinter& printer,
         printer.setOrientation(QPrinter::Portrait);
     }
 
-    printer.setOutputFileName(params.outFile);
+    printer.setOutputFileName(outFile);
     printer.setOutputFormat(QPrinter::PdfFormat);
     printer.setResolution(params.resolution);
     printer.setFullPage(true);
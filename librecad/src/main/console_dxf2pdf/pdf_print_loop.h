@@ -41,6 +41,7 @@ struct PdfPrintParams {
         bool grayscale;
         double scale = 0.0;  // If scale <= 0.0, use value from dxf file.
         RS_Vector pageSize;  // If zeros, use value from dxf file.
+        int jobs = 1;  // Files processed concurrently, 0 for one per core.
 };
 
 
@@ -67,7 +68,7 @@ private:
 
     PdfPrintParams params;
 
-    void printOneDxfToOnePdf(QString&);
+    void printOneDxfToOnePdf(const QString&);
     void printManyDxfToOnePdf();
 };
 
@@ -0,0 +1,430 @@
+/****************************************************************************
+**
+** This file is part of the LibreCAD project, a 2D CAD program
+**
+** Copyright (C) 2026 librecad.org (www.librecad.org)
+**
+**
+** This file may be distributed and/or modified under the terms of the
+** GNU General Public License version 2 as published by the Free Software
+** Foundation and appearing in the file gpl-2.0.txt included in the
+** packaging of this file.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program; if not, write to the Free Software
+** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+**
+** This copyright notice MUST APPEAR in all copies of the script!
+**
+**********************************************************************/
+
+#include <QtCore>
+#include <QCoreApplication>
+#include <QApplication>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "rs_arc.h"
+#include "rs_block.h"
+#include "rs_circle.h"
+#include "rs_debug.h"
+#include "rs_fontlist.h"
+#include "rs_graphic.h"
+#include "rs_hatch.h"
+#include "rs_insert.h"
+#include "rs_layer.h"
+#include "rs_line.h"
+#include "rs_math.h"
+#include "rs_patternlist.h"
+#include "rs_polyline.h"
+#include "rs_settings.h"
+#include "rs_spline.h"
+#include "rs_system.h"
+#include "rs_text.h"
+
+#include "main.h"
+
+#include "console_generator.h"
+
+
+namespace {
+
+/** Number of entities of every kind in the generated drawing. */
+struct GeneratorParams {
+    QString outFile;
+    unsigned seed = 1;
+    int lines = 10000;
+    int arcs = 1000;
+    int polylines = 1000;
+    int splines = 1000;
+    int hatches = 100;
+    int texts = 1000;
+    int inserts = 1000;
+    int blockDepth = 3;
+    int layers = 10;
+};
+
+/**
+ * Builds the drawing. Every entity is placed at a random position of a
+ * square sized to keep the density of the drawing the same for every
+ * number of entities, so zooming to the same scale shows about the same
+ * number of entities. The same seed always gives the same drawing.
+ */
+class Generator {
+public:
+    Generator(const GeneratorParams& params):
+        params(params)
+      ,random(params.seed)
+    {
+        double count = params.lines + params.arcs + params.polylines
+            + params.splines + params.hatches + params.texts + params.inserts;
+        side = 100.0 * std::sqrt(std::max(count, 1.0));
+    }
+
+    void generate(RS_Graphic* graphic);
+
+private:
+    RS_Vector point() {
+        double x = value(0., side);
+        double y = value(0., side);
+        return {x, y};
+    }
+    /**
+     * @return a random value in [lo, hi). The 53 high bits of the engine
+     * are mapped by hand, the standard distributions may give other values
+     * with another standard library.
+     */
+    double value(double lo, double hi) {
+        double unit = std::ldexp(double(random() >> 11), -53);
+        return lo + (hi - lo) * unit;
+    }
+    /** @return a vector of a random length in [lo, hi) and direction */
+    RS_Vector polar(double lo, double hi) {
+        double length = value(lo, hi);
+        double angle = value(0., 2.*M_PI);
+        return RS_Vector::polar(length, angle);
+    }
+
+    void addLayers(RS_Graphic* graphic);
+    void addBlocks(RS_Graphic* graphic);
+    void add(RS_Graphic* graphic, RS_Entity* e);
+
+    RS_Entity* line(RS_EntityContainer* parent);
+    RS_Entity* arc(RS_EntityContainer* parent);
+    RS_Entity* polyline(RS_EntityContainer* parent);
+    RS_Entity* spline(RS_EntityContainer* parent);
+    RS_Entity* hatch(RS_EntityContainer* parent);
+    RS_Entity* text(RS_EntityContainer* parent);
+    RS_Entity* insert(RS_EntityContainer* parent);
+
+    const GeneratorParams& params;
+    std::mt19937_64 random;
+    //! side of the square holding the entities
+    double side;
+    std::vector<RS_Layer*> layers;
+    //! name of the block inserted into the drawing
+    QString topBlock;
+    size_t added = 0;
+};
+
+void Generator::generate(RS_Graphic* graphic)
+{
+    addLayers(graphic);
+    addBlocks(graphic);
+
+    // Kinds are generated one after another, so the entity list is
+    // ordered by kind the same way for every seed.
+    for (int i = 0; i < params.lines; i++)
+        add(graphic, line(graphic));
+    for (int i = 0; i < params.arcs; i++)
+        add(graphic, arc(graphic));
+    for (int i = 0; i < params.polylines; i++)
+        add(graphic, polyline(graphic));
+    for (int i = 0; i < params.splines; i++)
+        add(graphic, spline(graphic));
+    for (int i = 0; i < params.hatches; i++)
+        add(graphic, hatch(graphic));
+    for (int i = 0; i < params.texts; i++)
+        add(graphic, text(graphic));
+    for (int i = 0; i < params.inserts && !topBlock.isEmpty(); i++)
+        add(graphic, insert(graphic));
+}
+
+void Generator::addLayers(RS_Graphic* graphic)
+{
+    layers.push_back(graphic->findLayer("0"));
+    for (int i = 1; i < params.layers; i++) {
+        RS_Layer* layer = new RS_Layer(QString("layer_%1").arg(i));
+        layer->setPen(RS_Pen(RS_Color(QColor::fromHsv(i * 47 % 360, 200, 220)),
+                             RS2::Width00, RS2::SolidLine));
+        graphic->addLayer(layer);
+        layers.push_back(layer);
+    }
+}
+
+/**
+ * Adds blockDepth blocks, block_0 holds a few lines and a circle, every
+ * further block holds a line and two inserts of the previous block.
+ */
+void Generator::addBlocks(RS_Graphic* graphic)
+{
+    for (int level = 0; level < params.blockDepth; level++) {
+        QString name = QString("block_%1").arg(level);
+        RS_Block* block = new RS_Block(graphic,
+                                       RS_BlockData(name, {0., 0.}, false));
+        if (level == 0) {
+            block->addEntity(new RS_Line{block, {0., 0.}, {40., 0.}});
+            block->addEntity(new RS_Line{block, {40., 0.}, {40., 20.}});
+            block->addEntity(new RS_Line{block, {40., 20.}, {0., 0.}});
+            block->addEntity(new RS_Circle(block, {{25., 7.}, 5.}));
+        } else {
+            block->addEntity(new RS_Line{block, {0., -5.}, {100., -5.}});
+            for (double x: {0., 50.}) {
+                block->addEntity(new RS_Insert(block,
+                    RS_InsertData(topBlock, {x, 0.}, {1., 1.}, 0.,
+                                  1, 1, {0., 0.}, nullptr, RS2::NoUpdate)));
+            }
+        }
+        for (RS_Entity* e: *block) {
+            e->setLayer(layers.front());
+            e->setPen(RS_Pen(RS_Color(RS2::FlagByBlock), RS2::WidthByBlock,
+                             RS2::LineByBlock));
+        }
+        graphic->addBlock(block, false);
+        topBlock = name;
+    }
+}
+
+/** adds an entity to the drawing on the next layer */
+void Generator::add(RS_Graphic* graphic, RS_Entity* e)
+{
+    e->setLayer(layers.at(added++ % layers.size()));
+    e->setPen(RS_Pen(RS_Color(RS2::FlagByLayer), RS2::WidthByLayer,
+                     RS2::LineByLayer));
+    graphic->appendEntity(e);
+}
+
+RS_Entity* Generator::line(RS_EntityContainer* parent)
+{
+    RS_Vector p = point();
+    return new RS_Line{parent, p, p + polar(10., 200.)};
+}
+
+RS_Entity* Generator::arc(RS_EntityContainer* parent)
+{
+    // every value is drawn on its own, the order of evaluation of
+    // function arguments is unspecified
+    RS_Vector center = point();
+    double radius = value(5., 100.);
+    double angle1 = value(0., 2.*M_PI);
+    double angle2 = value(0., 2.*M_PI);
+    return new RS_Arc(parent, RS_ArcData(center, radius, angle1, angle2,
+                                         false));
+}
+
+RS_Entity* Generator::polyline(RS_EntityContainer* parent)
+{
+    RS_Polyline* pl = new RS_Polyline(parent,
+        RS_PolylineData(RS_Vector(false), RS_Vector(false), false));
+    RS_Vector p = point();
+    int vertices = int(value(3., 20.));
+    for (int i = 0; i < vertices; i++) {
+        // every third segment is an arc
+        pl->addVertex(p, i % 3 == 2 ? value(-1., 1.) : 0.);
+        p += polar(10., 50.);
+    }
+    return pl;
+}
+
+RS_Entity* Generator::spline(RS_EntityContainer* parent)
+{
+    RS_Spline* s = new RS_Spline(parent, RS_SplineData(3, false));
+    RS_Vector p = point();
+    int points = int(value(4., 12.));
+    for (int i = 0; i < points; i++) {
+        s->addControlPoint(p);
+        p += polar(10., 50.);
+    }
+    s->update();
+    return s;
+}
+
+/** a rectangle, every other one filled solid */
+RS_Entity* Generator::hatch(RS_EntityContainer* parent)
+{
+    bool solid = value(0., 1.) < 0.5;
+    RS_Hatch* h = new RS_Hatch(parent,
+        RS_HatchData(solid, 1., 0., solid ? "SOLID" : "ANSI31"));
+    RS_EntityContainer* loop = new RS_EntityContainer(h);
+    loop->setLayer(nullptr);
+    h->addEntity(loop);
+
+    RS_Vector c0 = point();
+    double width = value(20., 200.);
+    double height = value(20., 200.);
+    RS_Vector c2 = c0 + RS_Vector(width, height);
+    RS_Vector c1(c2.x, c0.y);
+    RS_Vector c3(c0.x, c2.y);
+    for (auto const& side: {std::make_pair(c0, c1), std::make_pair(c1, c2),
+                            std::make_pair(c2, c3), std::make_pair(c3, c0)}) {
+        RS_Line* l = new RS_Line{loop, side.first, side.second};
+        l->setLayer(nullptr);
+        loop->addEntity(l);
+    }
+    return h;
+}
+
+RS_Entity* Generator::text(RS_EntityContainer* parent)
+{
+    QString s = QString("Text %1").arg(int(value(0., 100000.)));
+    RS_Vector p = point();
+    double height = value(2.5, 10.);
+    double angle = value(0., 2.*M_PI);
+    return new RS_Text(parent, RS_TextData(p, RS_Vector(false),
+                                           height, 1.,
+                                           RS_TextData::VABaseline,
+                                           RS_TextData::HALeft,
+                                           RS_TextData::None,
+                                           s, "standard",
+                                           angle));
+}
+
+RS_Entity* Generator::insert(RS_EntityContainer* parent)
+{
+    double scale = value(0.5, 2.);
+    RS_Vector p = point();
+    double angle = value(0., 2.*M_PI);
+    return new RS_Insert(parent,
+        RS_InsertData(topBlock, p, {scale, scale}, angle,
+                      1, 1, {0., 0.}, nullptr, RS2::NoUpdate));
+}
+
+} // namespace
+
+
+int console_generator(int argc, char* argv[])
+{
+    RS_DEBUG->setLevel(RS_Debug::D_NOTHING);
+
+    QApplication app(argc, argv);
+    QCoreApplication::setOrganizationName("LibreCAD");
+    QCoreApplication::setApplicationName("LibreCAD");
+    QCoreApplication::setApplicationVersion(XSTR(LC_VERSION));
+
+    QFileInfo prgInfo(QFile::decodeName(argv[0]));
+    QString prgDir(prgInfo.absolutePath());
+    RS_SETTINGS->init(app.organizationName(), app.applicationName());
+    RS_SYSTEM->init(app.applicationName(), app.applicationVersion(),
+        XSTR(QC_APPDIR), prgDir);
+
+    QCommandLineParser parser;
+
+    QString appDesc = "\ngenerate usage: " + prgInfo.filePath()
+        + " generate [options] <dxf_file>\n";
+    appDesc += "\nWrite a synthetic drawing with the given number of"
+        " entities of every kind. The same options and seed always give"
+        " the same drawing.";
+    parser.setApplicationDescription(appDesc);
+
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    GeneratorParams params;
+
+    struct CountOption {
+        const char* name;
+        const char* what;
+        int* value;
+    };
+    const std::vector<CountOption> counts = {
+        {"lines", "lines", &params.lines},
+        {"arcs", "arcs", &params.arcs},
+        {"polylines", "polylines", &params.polylines},
+        {"splines", "splines", &params.splines},
+        {"hatches", "hatches", &params.hatches},
+        {"texts", "texts", &params.texts},
+        {"inserts", "block inserts", &params.inserts},
+        {"block-depth", "nesting levels of the inserted block",
+         &params.blockDepth},
+        {"layers", "layers", &params.layers}
+    };
+    std::vector<QCommandLineOption> countOpts;
+    for (const CountOption& c: counts) {
+        countOpts.emplace_back(c.name,
+            QString("Number of %1, default %2.").arg(c.what).arg(*c.value),
+            "integer");
+        parser.addOption(countOpts.back());
+    }
+
+    QCommandLineOption scaleOpt(QStringList() << "n" << "entities",
+        "Scale all numbers of entities to about this many in total.",
+        "integer");
+    parser.addOption(scaleOpt);
+
+    QCommandLineOption seedOpt(QStringList() << "s" << "seed",
+        "Seed of the random numbers, default 1.", "integer");
+    parser.addOption(seedOpt);
+
+    parser.addPositionalArgument("<dxf_file>", "Output DXF file");
+
+    parser.process(app);
+
+    for (auto arg : parser.positionalArguments()) {
+        if (QFileInfo(arg).suffix().toLower() == "dxf") {
+            params.outFile = arg;
+            break;
+        }
+    }
+    if (params.outFile.isEmpty())
+        parser.showHelp(EXIT_FAILURE);
+
+    bool ok;
+    double total = parser.value(scaleOpt).toDouble(&ok);
+    double count = params.lines + params.arcs + params.polylines
+        + params.splines + params.hatches + params.texts + params.inserts;
+    if (ok && total > 0.0 && count > 0.0) {
+        for (int* c: {&params.lines, &params.arcs, &params.polylines,
+                      &params.splines, &params.hatches, &params.texts,
+                      &params.inserts})
+            *c = int(std::round(*c * total / count));
+    }
+
+    for (size_t i = 0; i < counts.size(); i++) {
+        int value = parser.value(countOpts[i]).toInt(&ok);
+        if (ok && value >= 0)
+            *counts[i].value = value;
+        else if (parser.isSet(countOpts[i]))
+            qDebug() << "WARNING: Ignoring bad number of" << counts[i].what
+                     << parser.value(countOpts[i]);
+    }
+    params.layers = std::max(params.layers, 1);
+
+    unsigned seed = parser.value(seedOpt).toUInt(&ok);
+    if (ok)
+        params.seed = seed;
+
+    RS_FONTLIST->init();
+    RS_PATTERNLIST->init();
+
+    std::unique_ptr<RS_Graphic> graphic(new RS_Graphic());
+    // creates layer "0", which holds the block entities
+    graphic->newDoc();
+    Generator(params).generate(graphic.get());
+    graphic->calculateBorders();
+
+    if (!graphic->saveAs(params.outFile, RS2::FormatDXFRW, true)) {
+        qDebug() << "ERROR: Cannot write" << params.outFile;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
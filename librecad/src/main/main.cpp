@@ -46,6 +46,8 @@
 #include "rs_debug.h"
 
 #include "console_dxf2pdf.h"
+#include "console_benchmark.h"
+#include "console_generator.h"
 
 
 /**
@@ -73,6 +75,12 @@ int main(int argc, char** argv)
         if (arg.compare("dxf2pdf") == 0) {
             return console_dxf2pdf(argc, argv);
         }
+        if (i == 1 && arg.compare("benchmark") == 0) {
+            return console_benchmark(argc, argv);
+        }
+        if (i == 1 && arg.compare("generate") == 0) {
+            return console_generator(argc, argv);
+        }
     }
 
     RS_DEBUG->setLevel(RS_Debug::D_WARNING);
@@ -106,6 +114,8 @@ int main(int argc, char** argv)
             qDebug()<<"Commands:";
             qDebug()<<"";
             qDebug()<<"  dxf2pdf\tRun librecad as console dxf2pdf tool. Use -h for help.";
+            qDebug()<<"  benchmark\tTime rendering, snapping and editing of a dxf file. Use -h for help.";
+            qDebug()<<"  generate\tWrite a synthetic dxf file of a given size. Use -h for help.";
             qDebug()<<"";
             qDebug()<<"Options:";
             qDebug()<<"";
@@ -56,6 +56,7 @@
 #include "rs_painterqt.h"
 #include "rs_selection.h"
 #include "rs_document.h"
+#include "rs_graphic.h"
 
 #include "lc_centralwidget.h"
 #include "qc_mdiwindow.h"
@@ -479,6 +480,10 @@ w->getGraphicView()->redraw();
 QC_ApplicationWindow::~QC_ApplicationWindow() {
     RS_DEBUG->print("QC_ApplicationWindow::~QC_ApplicationWindow");
 
+    if (autosaveThread.joinable()) {
+        autosaveThread.join();
+    }
+
     RS_DEBUG->print("QC_ApplicationWindow::~QC_ApplicationWindow: "
                     "deleting dialog factory");
 
@@ -1089,6 +1094,7 @@ QC_MDIWindow* QC_ApplicationWindow::slotFileNew(RS_Document* doc) {
 
     RS_SETTINGS->beginGroup("/Appearance");
     int aa = RS_SETTINGS->readNumEntry("/Antialiasing", 0);
+    int batched = RS_SETTINGS->readNumEntry("/BatchedDrawing", 1);
     int scrollbars = RS_SETTINGS->readNumEntry("/ScrollBars", 1);
     int cursor_hiding = RS_SETTINGS->readNumEntry("/cursor_hiding", 0);
     RS_SETTINGS->endGroup();
@@ -1096,6 +1102,7 @@ QC_MDIWindow* QC_ApplicationWindow::slotFileNew(RS_Document* doc) {
     QG_GraphicView* view = w->getGraphicView();
 
     view->setAntialiasing(aa);
+    view->setBatchedDrawing(batched);
     view->setCursorHiding(cursor_hiding);
     view->device = settings.value("Hardware/Device", "Mouse").toString();
     if (scrollbars) view->addScrollbars();
@@ -1635,31 +1642,62 @@ void QC_ApplicationWindow::slotFileSaveAs() {
 
 
 /**
- * Autosave.
+ * Autosave. A snapshot of the document is taken and written
+ * by another thread, so editing can go on meanwhile.
  */
 void QC_ApplicationWindow::slotFileAutoSave() {
     RS_DEBUG->print("QC_ApplicationWindow::slotFileAutoSave()");
 
-    statusBar()->showMessage(tr("Auto-saving drawing..."), 2000);
+    if (autosaveThread.joinable()) {
+        // the last snapshot is still being written
+        return;
+    }
 
     QC_MDIWindow* w = getMDIWindow();
-    if (w) {
-        bool cancelled;
-        if (w->slotFileSave(cancelled, true)) {
-            // auto-save cannot be cancelled by user, so the
-            // "cancelled" parameter is a dummy
-            statusBar()->showMessage(tr("Auto-saved drawing"), 2000);
-        } else {
-            // error
-            autosaveTimer->stop();
-            QMessageBox::information(this, QMessageBox::tr("Warning"),
-                                     tr("Cannot auto-save the file\n%1\nPlease "
-                                        "check the permissions.\n"
-                                        "Auto-save disabled.")
-                                     .arg(w->getDocument()->getAutoSaveFilename()),
-                                     QMessageBox::Ok);
-            statusBar()->showMessage(tr("Auto-saving failed"), 2000);
+    RS_Graphic* graphic = w ? w->getDocument()->getGraphic() : nullptr;
+    if (!graphic || !graphic->isModified()) {
+        return;
+    }
+
+    statusBar()->showMessage(tr("Auto-saving drawing..."));
+
+    RS_Graphic* snapshot = graphic->createSnapshot();
+    autosaveWindow = w;
+    autosaveFile = snapshot->getAutoSaveFilename();
+    autosaveThread = std::thread([this, snapshot]() {
+        bool success = snapshot->save(true);
+        delete snapshot;
+        QMetaObject::invokeMethod(this, "slotFileAutoSaved", Qt::QueuedConnection,
+                                  Q_ARG(bool, success));
+    });
+}
+
+
+
+void QC_ApplicationWindow::slotFileAutoSaved(bool success) {
+    RS_DEBUG->print("QC_ApplicationWindow::slotFileAutoSaved()");
+
+    if (autosaveThread.joinable()) {
+        autosaveThread.join();
+    }
+
+    if (success) {
+        // the drawing was saved or closed while the snapshot was written,
+        // the auto-save file is outdated
+        if (!autosaveWindow || !autosaveWindow->getDocument()->isModified()) {
+            QFile::remove(autosaveFile);
         }
+        statusBar()->showMessage(tr("Auto-saved drawing"), 2000);
+    } else {
+        // error
+        autosaveTimer->stop();
+        QMessageBox::information(this, QMessageBox::tr("Warning"),
+                                 tr("Cannot auto-save the file\n%1\nPlease "
+                                    "check the permissions.\n"
+                                    "Auto-save disabled.")
+                                 .arg(autosaveFile),
+                                 QMessageBox::Ok);
+        statusBar()->showMessage(tr("Auto-saving failed"), 2000);
     }
 }
 
@@ -2344,6 +2382,7 @@ void QC_ApplicationWindow::slotOptionsGeneral() {
 
     RS_SETTINGS->beginGroup("/Appearance");
     int antialiasing = RS_SETTINGS->readNumEntry("/Antialiasing");
+    int batchedDrawing = RS_SETTINGS->readNumEntry("/BatchedDrawing", 1);
     RS_SETTINGS->endGroup();
 
     QList<QMdiSubWindow*> windows = mdiAreaCAD->subWindowList();
@@ -2361,6 +2400,7 @@ void QC_ApplicationWindow::slotOptionsGeneral() {
                 gv->setHandleColor(handleColor);
                 gv->setEndHandleColor(endHandleColor);
                 gv->setAntialiasing(antialiasing?true:false);
+                gv->setBatchedDrawing(batchedDrawing?true:false);
                 gv->redraw(RS2::RedrawGrid);
             }
         }
@@ -31,9 +31,11 @@
 
 #include "mainwindowx.h"
 
+#include <thread>
 #include "rs_pen.h"
 #include "rs_snapper.h"
 #include <QMap>
+#include <QPointer>
 
 class QMdiArea;
 class QMdiSubWindow;
@@ -144,6 +146,8 @@ public slots:
     void slotFileSaveAs();
     /** auto-save document */
     void slotFileAutoSave();
+    /** called when the auto-save thread is done */
+    void slotFileAutoSaved(bool success);
     /** exports the document as bitmap */
     void slotFileExport();
     bool slotFileExport(const QString& name, const QString& format,
@@ -312,6 +316,10 @@ private:
     /** Pointer to the application window (this). */
     static QC_ApplicationWindow* appWindow;
     QTimer *autosaveTimer;
+    /** writes a snapshot of the auto-saved document */
+    std::thread autosaveThread;
+    QPointer<QC_MDIWindow> autosaveWindow;
+    QString autosaveFile;
 
     QG_ActionHandler* actionHandler;
 
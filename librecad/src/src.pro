@@ -103,6 +103,8 @@ INCLUDEPATH += \
     actions \
     main \
     main/console_dxf2pdf \
+    main/console_benchmark \
+    main/console_generator \
     test \
     plugins \
     ui \
@@ -189,6 +191,7 @@ HEADERS += \
     lib/filters/rs_filterjww.h \
     lib/filters/rs_filterlff.h \
     lib/filters/rs_filterinterface.h \
+    lib/filters/lc_dxfpipeline.h \
     lib/gui/rs_commandevent.h \
     lib/gui/rs_coordinateevent.h \
     lib/gui/rs_dialogfactory.h \
@@ -217,6 +220,14 @@ HEADERS += \
     actions/lc_actionfileexportmakercam.h \
     lib/engine/lc_rect.h \
     lib/engine/lc_undosection.h \
+    lib/engine/lc_spatialindex.h \
+    lib/engine/lc_curvecache.h \
+    lib/engine/lc_endpointindex.h \
+    lib/engine/lc_contourregion.h \
+    lib/engine/lc_selectionset.h \
+    lib/engine/lc_undotransform.h \
+    lib/engine/lc_glyph.h \
+    lib/engine/lc_parallel.h \
     lib/printing/lc_printing.h \
     actions/lc_actiondrawlinepolygon3.h \
     main/lc_application.h
@@ -280,6 +291,7 @@ SOURCES += \
     lib/filters/rs_filterdxf1.cpp \
     lib/filters/rs_filterjww.cpp \
     lib/filters/rs_filterlff.cpp \
+    lib/filters/lc_dxfpipeline.cpp \
     lib/gui/rs_dialogfactory.cpp \
     lib/gui/rs_eventhandler.cpp \
     lib/gui/rs_graphicview.cpp \
@@ -307,6 +319,14 @@ SOURCES += \
     lib/engine/rs_flags.cpp \
     lib/engine/lc_rect.cpp \
     lib/engine/lc_undosection.cpp \
+    lib/engine/lc_spatialindex.cpp \
+    lib/engine/lc_curvecache.cpp \
+    lib/engine/lc_endpointindex.cpp \
+    lib/engine/lc_contourregion.cpp \
+    lib/engine/lc_selectionset.cpp \
+    lib/engine/lc_undotransform.cpp \
+    lib/engine/lc_glyph.cpp \
+    lib/engine/lc_parallel.cpp \
     lib/engine/rs.cpp \
     lib/printing/lc_printing.cpp \
     actions/lc_actiondrawlinepolygon3.cpp \
@@ -891,7 +911,9 @@ HEADERS += \
     main/main.h \
     main/mainwindowx.h \
     main/console_dxf2pdf/console_dxf2pdf.h \
-    main/console_dxf2pdf/pdf_print_loop.h
+    main/console_dxf2pdf/pdf_print_loop.h \
+    main/console_benchmark/console_benchmark.h \
+    main/console_generator/console_generator.h
 
 SOURCES += \
     main/qc_applicationwindow.cpp \
@@ -904,7 +926,9 @@ SOURCES += \
     main/main.cpp \
     main/mainwindowx.cpp \
     main/console_dxf2pdf/console_dxf2pdf.cpp \
-    main/console_dxf2pdf/pdf_print_loop.cpp
+    main/console_dxf2pdf/pdf_print_loop.cpp \
+    main/console_benchmark/console_benchmark.cpp \
+    main/console_generator/console_generator.cpp
 
 # If C99 emulation is needed, add the respective source files.
 contains(DEFINES, EMU_C99) {
@@ -1,7 +1,16 @@
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <fstream>
+#include <memory>
+#include <random>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
 #include <QMenuBar>
+#include <QPixmap>
+#include <QTemporaryDir>
 #include "lc_simpletests.h"
 #include "qc_applicationwindow.h"
 #include "rs_graphic.h"
@@ -26,6 +35,131 @@
 #include "rs_layer.h"
 #include "rs_graphicview.h"
 #include "rs_debug.h"
+#include "rs_dialogfactory.h"
+#include "rs_painterqt.h"
+#include "rs_linetypepattern.h"
+#include "rs_filterdxfrw.h"
+#include "libdxfrw.h"
+
+namespace {
+/**
+ * Counts the entities of a DXF file and drops everything else, to measure
+ * the reading speed of libdxfrw alone.
+ */
+class DxfCounter: public DRW_Interface {
+public:
+	long entities = 0;
+
+	void addHeader(const DRW_Header*) override {}
+	void addLType(const DRW_LType&) override {}
+	void addLayer(const DRW_Layer&) override {}
+	void addDimStyle(const DRW_Dimstyle&) override {}
+	void addVport(const DRW_Vport&) override {}
+	void addTextStyle(const DRW_Textstyle&) override {}
+	void addAppId(const DRW_AppId&) override {}
+	void addBlock(const DRW_Block&) override {}
+	void setBlock(const int) override {}
+	void endBlock() override {}
+	void addPoint(const DRW_Point&) override {++entities;}
+	void addLine(const DRW_Line&) override {++entities;}
+	void addRay(const DRW_Ray&) override {++entities;}
+	void addXline(const DRW_Xline&) override {++entities;}
+	void addArc(const DRW_Arc&) override {++entities;}
+	void addCircle(const DRW_Circle&) override {++entities;}
+	void addEllipse(const DRW_Ellipse&) override {++entities;}
+	void addLWPolyline(const DRW_LWPolyline&) override {++entities;}
+	void addPolyline(const DRW_Polyline&) override {++entities;}
+	void addSpline(const DRW_Spline*) override {++entities;}
+	void addKnot(const DRW_Entity&) override {}
+	void addInsert(const DRW_Insert&) override {++entities;}
+	void addTrace(const DRW_Trace&) override {++entities;}
+	void add3dFace(const DRW_3Dface&) override {++entities;}
+	void addSolid(const DRW_Solid&) override {++entities;}
+	void addMText(const DRW_MText&) override {++entities;}
+	void addText(const DRW_Text&) override {++entities;}
+	void addDimAlign(const DRW_DimAligned*) override {++entities;}
+	void addDimLinear(const DRW_DimLinear*) override {++entities;}
+	void addDimRadial(const DRW_DimRadial*) override {++entities;}
+	void addDimDiametric(const DRW_DimDiametric*) override {++entities;}
+	void addDimAngular(const DRW_DimAngular*) override {++entities;}
+	void addDimAngular3P(const DRW_DimAngular3p*) override {++entities;}
+	void addDimOrdinate(const DRW_DimOrdinate*) override {++entities;}
+	void addLeader(const DRW_Leader*) override {++entities;}
+	void addHatch(const DRW_Hatch*) override {++entities;}
+	void addViewport(const DRW_Viewport&) override {++entities;}
+	void addImage(const DRW_Image*) override {++entities;}
+	void linkImage(const DRW_ImageDef*) override {}
+	void addComment(const char*) override {}
+	void writeHeader(DRW_Header&) override {}
+	void writeBlocks() override {}
+	void writeBlockRecords() override {}
+	void writeEntities() override {}
+	void writeLTypes() override {}
+	void writeLayers() override {}
+	void writeTextstyles() override {}
+	void writeVports() override {}
+	void writeDimstyles() override {}
+	void writeAppId() override {}
+};
+
+/**
+ * Draws a line the way RS_Line::draw() did before lines were clipped to
+ * the view: a temporary border container per call, the whole line in
+ * screen coordinates and every pattern period along it. Only used to get
+ * the "before" numbers of the line drawing benchmark.
+ */
+void drawLineLegacy(RS_Line* line, RS_PainterQt* painter, RS_GraphicView* view,
+					double& patternOffset) {
+	auto viewportRect = view->getViewRect();
+	RS_EntityContainer ec(nullptr);
+	ec.addRectangle(viewportRect.minP(), viewportRect.maxP());
+
+	RS_Vector const pStart{view->toGui(line->getStartpoint())};
+	RS_Vector const pEnd{view->toGui(line->getEndpoint())};
+	RS_Vector direction = pEnd-pStart;
+	double const length = direction.magnitude();
+	patternOffset -= length;
+	if (line->getPen().getLineType() == RS2::SolidLine) {
+		painter->drawLine(pStart, pEnd);
+		return;
+	}
+
+	const RS_LineTypePattern* pat = view->getPattern(line->getPen().getLineType());
+	if (!pat || pat->num <= 0 || length <= RS_TOLERANCE) {
+		painter->drawLine(pStart, pEnd);
+		return;
+	}
+	direction /= length;
+	RS_Pen pen = painter->getPen();
+	pen.setLineType(RS2::SolidLine);
+	painter->setPen(pen);
+
+	double const patternSegmentLength = pat->totalLength;
+	std::vector<RS_Vector> dp(pat->num);
+	std::vector<double> ds(pat->num);
+	double const dpmm = painter->getDpmm();
+	for (size_t i = 0; i < pat->num; ++i) {
+		ds[i] = dpmm*pat->pattern[i];
+		if (fabs(ds[i]) < 1.) ds[i] = copysign(1., ds[i]);
+		dp[i] = direction*fabs(ds[i]);
+	}
+	double total = remainder(patternOffset-0.5*patternSegmentLength, patternSegmentLength)
+			- 0.5*patternSegmentLength;
+
+	RS_Vector curP{pStart+direction*total};
+	for (size_t j = 0; total < length; j = (j+1)%pat->num) {
+		double const t2 = total+fabs(ds[j]);
+		RS_Vector const p3 = curP+dp[j];
+		if (ds[j] > 0.0 && t2 > 0.0) {
+			RS_Vector const& p1 = (total > -0.5) ? curP : pStart;
+			RS_Vector const& p2 = (t2 < length+0.5) ? p3 : pEnd;
+			painter->drawLine(p1, p2);
+		}
+		total = t2;
+		curP = p3;
+	}
+}
+}
 
 LC_SimpleTests::LC_SimpleTests(QWidget *parent):
 	QObject(parent)
@@ -95,6 +229,21 @@ LC_SimpleTests::LC_SimpleTests(QWidget *parent):
 				this, SLOT(slotTestMath01()));
 		testMenu->addAction(action);
 
+		action = new QAction("Benchmark Line Drawing", this);
+		connect(action, SIGNAL(triggered()),
+				this, SLOT(slotTestBenchmarkLines()));
+		testMenu->addAction(action);
+
+		action = new QAction("Benchmark DXF Reading", this);
+		connect(action, SIGNAL(triggered()),
+				this, SLOT(slotTestBenchmarkDxfReading()));
+		testMenu->addAction(action);
+
+		action = new QAction("Benchmark DXF Writing", this);
+		connect(action, SIGNAL(triggered()),
+				this, SLOT(slotTestBenchmarkDxfWriting()));
+		testMenu->addAction(action);
+
 		action = new QAction("Resize to 640x480", this);
 		connect(action, SIGNAL(triggered()),
 				this, SLOT(slotTestResize640()));
@@ -1074,6 +1223,132 @@ void LC_SimpleTests::slotTestMath01() {
 	RS_DEBUG->print("%s\n: end\n", __func__);
 }
 
+/**
+ * Draws random lines, most of them crossing or outside of the viewport,
+ * into an offscreen pixmap of the current view and reports lines per second
+ * for solid and for dashed lines.
+ */
+void LC_SimpleTests::slotTestBenchmarkLines() {
+	RS_DEBUG->print("%s\n: begin\n", __func__);
+	RS_GraphicView* v = QC_ApplicationWindow::getAppWindow()->getGraphicView();
+	if (!v) {
+		return;
+	}
+
+	const int count = 200000;
+	// lines spread over an area nine times as large as the view
+	RS_Vector const c0 = v->toGraph(-v->getWidth(), 2*v->getHeight());
+	RS_Vector const c1 = v->toGraph(2*v->getWidth(), -v->getHeight());
+	std::mt19937 gen(1);
+	std::uniform_real_distribution<double> x(c0.x, c1.x);
+	std::uniform_real_distribution<double> y(c0.y, c1.y);
+	std::vector<std::unique_ptr<RS_Line>> lines;
+	lines.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		lines.emplace_back(new RS_Line{nullptr, {x(gen), y(gen)}, {x(gen), y(gen)}});
+	}
+
+	QPixmap pixmap(v->getWidth(), v->getHeight());
+	for (RS2::LineType type: {RS2::SolidLine, RS2::DashLine}) {
+		RS_Pen const pen(RS_Color(0, 0, 0), RS2::Width00, type);
+		double rates[2];
+		// the legacy path first, then the clipped RS_Line::draw()
+		for (bool legacy: {true, false}) {
+			pixmap.fill(Qt::white);
+			RS_PainterQt painter(&pixmap);
+			painter.setPen(pen);
+
+			QElapsedTimer timer;
+			timer.start();
+			for (auto& line: lines) {
+				line->setPen(pen);
+				double patternOffset = 0.;
+				if (legacy) {
+					drawLineLegacy(line.get(), &painter, v, patternOffset);
+				} else {
+					line->draw(&painter, v, patternOffset);
+				}
+			}
+			painter.flush();
+			painter.end();
+			rates[legacy ? 0 : 1] = count/std::max(timer.nsecsElapsed()*1e-9, 1e-9);
+		}
+
+		RS_DIALOGFACTORY->commandMessage(
+					QString("%1 lines: before %2 lines/s, after %3 lines/s")
+					.arg(type == RS2::SolidLine ? "solid" : "dashed")
+					.arg(rates[0], 0, 'f', 0)
+					.arg(rates[1], 0, 'f', 0));
+	}
+	RS_DEBUG->print("%s\n: end\n", __func__);
+}
+
+/**
+ * Testing function.
+ */
+void LC_SimpleTests::slotTestBenchmarkDxfReading() {
+	RS_DEBUG->print("%s\n: begin\n", __func__);
+	QString const file = QFileDialog::getOpenFileName(
+				QC_ApplicationWindow::getAppWindow(), "Benchmark DXF Reading",
+				QString(), "DXF (*.dxf *.DXF)");
+	if (file.isEmpty()) {
+		return;
+	}
+	double const megaBytes = QFileInfo(file).size()*1e-6;
+
+	for (bool mapped: {false, true}) {
+		DxfCounter counter;
+		dxfRW dxf(QFile::encodeName(file));
+		dxf.setMemoryMapped(mapped);
+
+		QElapsedTimer timer;
+		timer.start();
+		bool const ok = dxf.read(&counter, false);
+		double const seconds = std::max(timer.nsecsElapsed()*1e-9, 1e-9);
+
+		RS_DIALOGFACTORY->commandMessage(
+					QString("%1 reader: %2 MB/s, %3 entities%4")
+					.arg(mapped ? "memory mapped" : "stream")
+					.arg(megaBytes/seconds, 0, 'f', 1)
+					.arg(counter.entities)
+					.arg(ok ? "" : ", failed"));
+	}
+	RS_DEBUG->print("%s\n: end\n", __func__);
+}
+
+/**
+ * Testing function.
+ */
+void LC_SimpleTests::slotTestBenchmarkDxfWriting() {
+	RS_DEBUG->print("%s\n: begin\n", __func__);
+	RS_Document* d = QC_ApplicationWindow::getAppWindow()->getDocument();
+	RS_Graphic* graphic = d ? d->getGraphic() : nullptr;
+	QTemporaryDir dir;
+	if (!graphic || !dir.isValid()) {
+		return;
+	}
+	QString const file = dir.filePath("benchmark.dxf");
+
+	for (bool buffered: {false, true}) {
+		RS_FilterDXFRW filter;
+		filter.setBufferedWriting(buffered);
+
+		QElapsedTimer timer;
+		timer.start();
+		bool const ok = filter.fileExport(*graphic, file, RS2::FormatDXFRW);
+		double const seconds = std::max(timer.nsecsElapsed()*1e-9, 1e-9);
+		double const megaBytes = QFileInfo(file).size()*1e-6;
+
+		RS_DIALOGFACTORY->commandMessage(
+					QString("%1 writer: %2 MB/s, %3 MB%4")
+					.arg(buffered ? "buffered" : "stream")
+					.arg(megaBytes/seconds, 0, 'f', 1)
+					.arg(megaBytes, 0, 'f', 1)
+					.arg(ok ? "" : ", failed"));
+	}
+	RS_DEBUG->print("%s\n: end\n", __func__);
+}
+
 /**
  * Testing function.
  */
@@ -36,6 +36,12 @@ public slots:
 	void slotTestUnicode();
 	/** math experimental */
 	void slotTestMath01();
+	/** measures RS_Line::draw() throughput */
+	void slotTestBenchmarkLines();
+	/** measures the DXF reading speed of the stream and memory mapped readers */
+	void slotTestBenchmarkDxfReading();
+	/** measures the DXF saving speed of the stream and buffered writers */
+	void slotTestBenchmarkDxfWriting();
 	/** resizes window to 640x480 for screen shots */
 	void slotTestResize640();
 	/** resizes window to 640x480 for screen shots */
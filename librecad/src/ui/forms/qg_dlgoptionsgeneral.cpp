@@ -178,6 +178,8 @@ void QG_DlgOptionsGeneral::init()
     cbUnit->setCurrentIndex( cbUnit->findText(QObject::tr( RS_SETTINGS->readEntry("/Unit", def_unit).toUtf8().data() )) );
     // Auto save timer
     cbAutoSaveTime->setValue(RS_SETTINGS->readNumEntry("/AutoSaveTime", 5));
+    sbMaxUndoSteps->setValue(RS_SETTINGS->readNumEntry("/MaxUndoSteps", 0));
+    sbUndoBudget->setValue(RS_SETTINGS->readNumEntry("/UndoBudget", 1000));
     cbAutoBackup->setChecked(RS_SETTINGS->readNumEntry("/AutoBackupDocument", 1));
     cbUseQtFileOpenDialog->setChecked(RS_SETTINGS->readNumEntry("/UseQtFileOpenDialog", 1));
     RS_SETTINGS->endGroup();
@@ -268,6 +270,8 @@ void QG_DlgOptionsGeneral::ok()
         RS_SETTINGS->writeEntry("/Unit",
             RS_Units::unitToString( RS_Units::stringToUnit( cbUnit->currentText() ), false/*untr.*/) );
         RS_SETTINGS->writeEntry("/AutoSaveTime", cbAutoSaveTime->value() );
+        RS_SETTINGS->writeEntry("/MaxUndoSteps", sbMaxUndoSteps->value());
+        RS_SETTINGS->writeEntry("/UndoBudget", sbUndoBudget->value());
         RS_SETTINGS->writeEntry("/AutoBackupDocument", cbAutoBackup->isChecked() ? 1 : 0);
         RS_SETTINGS->writeEntry("/UseQtFileOpenDialog", cbUseQtFileOpenDialog->isChecked() ? 1 : 0);
         RS_SETTINGS->endGroup();
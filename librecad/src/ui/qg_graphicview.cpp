@@ -242,6 +242,16 @@ void QG_GraphicView::redraw(RS2::RedrawMethod method) {
 }
 
 
+/**
+ * Moves the drawing buffer instead of redrawing it, only the strips
+ * exposed by the move are drawn on the next paint event.
+ */
+void QG_GraphicView::redrawPanned(int dx, int dy) {
+        panOffset += QPoint(dx, dy);
+        redraw((RS2::RedrawMethod) (RS2::RedrawGrid | RS2::RedrawOverlay | RS2::RedrawPan));
+}
+
+
 void QG_GraphicView::resizeEvent(QResizeEvent* /*e*/) {
     RS_DEBUG->print("QG_GraphicView::resizeEvent begin");
     adjustOffsetControls();
@@ -922,12 +932,47 @@ void QG_GraphicView::paintEvent(QPaintEvent *)
             painter2.setRenderHint(QPainter::Antialiasing);
         }
         painter2.setDrawingMode(drawingMode);
-        painter2.setDrawSelectedOnly(false);
-        drawLayer2((RS_Painter*)&painter2);
-        painter2.setDrawSelectedOnly(true);
+        painter2.setBatching(batchedDrawing);
         drawLayer2((RS_Painter*)&painter2);
+        painter2.flush();
+        painter2.end();
+    }
+    else if (redrawMethod & RS2::RedrawPan)
+    {
+        view_rect = LC_Rect(toGraph(0, 0),
+                            toGraph(getWidth(), getHeight()));
+        // Move layer 2 and draw the exposed strips only
+        QRegion exposed;
+        PixmapLayer2->scroll(panOffset.x(), panOffset.y(), PixmapLayer2->rect(), &exposed);
+        RS_PainterQt painter2(PixmapLayer2.get());
+        painter2.setCompositionMode(QPainter::CompositionMode_Source);
+        for (const QRect& r: exposed)
+            painter2.QPainter::fillRect(r, Qt::transparent);
+        painter2.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        if (antialiasing)
+        {
+            painter2.setRenderHint(QPainter::Antialiasing);
+        }
+        painter2.setDrawingMode(drawingMode);
+        painter2.setBatching(batchedDrawing);
+        // the strips don't overlap, so every strip gets its own query
+        for (const QRect& r: exposed)
+        {
+            painter2.setClipRect(r.x(), r.y(), r.width(), r.height());
+            drawEntities((RS_Painter*)&painter2,
+                         LC_Rect{{double(r.left()), double(r.top())},
+                                 {double(r.right() + 1), double(r.bottom() + 1)}});
+        }
+        if (!isPrintPreview())
+        {
+            painter2.flush();
+            painter2.setClipRegion(exposed);
+            drawAbsoluteZero((RS_Painter*)&painter2);
+        }
+        painter2.flush();
         painter2.end();
     }
+    panOffset = QPoint();
 
     if (redrawMethod & RS2::RedrawOverlay)
     {
@@ -956,6 +1001,15 @@ void QG_GraphicView::setAntialiasing(bool state)
 	antialiasing = state;
 }
 
+/**
+ * @brief setBatchedDrawing toggles between batched and immediate submission
+ * of lines to the painter of the drawing layer
+ */
+void QG_GraphicView::setBatchedDrawing(bool state)
+{
+	batchedDrawing = state;
+}
+
 void QG_GraphicView::addScrollbars()
 {
     scrollbars = true;
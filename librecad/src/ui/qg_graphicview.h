@@ -59,6 +59,7 @@ public:
 	int getWidth() const override;
 	int getHeight() const override;
 	void redraw(RS2::RedrawMethod method=RS2::RedrawAll) override;
+	void redrawPanned(int dx, int dy) override;
 	void adjustOffsetControls() override;
 	void adjustZoomControls() override;
 	void setBackground(const RS_Color& bg) override;
@@ -92,6 +93,7 @@ public:
 	RS_Vector getMousePosition() const override;
 
     void setAntialiasing(bool state);
+    void setBatchedDrawing(bool state);
     void setCursorHiding(bool state);
     void addScrollbars();
     bool hasScrollbars();
@@ -152,6 +154,8 @@ protected:
     std::unique_ptr<QPixmap> PixmapLayer3;  // Used for crosshair and actionitems
 	
 	RS2::RedrawMethod redrawMethod;
+	//! pixels PixmapLayer2 has to be moved by for RS2::RedrawPan
+	QPoint panOffset;
 		
     //! Keep tracks of if we are currently doing a high-resolution scrolling
     bool isSmoothScrolling;
@@ -160,6 +164,7 @@ protected:
 
 private:
     bool antialiasing{false};
+    bool batchedDrawing{true};
     bool scrollbars{false};
     bool cursor_hiding{false};
 